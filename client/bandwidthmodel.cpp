@@ -0,0 +1,187 @@
+/*
+  bandwidthmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bandwidthmodel.h"
+
+#include <QApplication>
+#include <QColor>
+#include <QPalette>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+BandwidthModel::Sample::Sample()
+    : second(0)
+    , sentBytes(0)
+    , receivedBytes(0)
+    , sentMessages(0)
+    , receivedMessages(0)
+{
+}
+
+BandwidthModel::BandwidthModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_peakBytes(0)
+{
+    m_clock.start();
+}
+
+BandwidthModel::~BandwidthModel()
+{
+}
+
+void BandwidthModel::clear()
+{
+    beginResetModel();
+    m_samples.clear();
+    m_peakBytes = 0;
+    m_clock.restart();
+    endResetModel();
+}
+
+void BandwidthModel::addSentMessage(int size)
+{
+    auto &sample = currentSample();
+    sample.sentBytes += size;
+    ++sample.sentMessages;
+    m_peakBytes = std::max(m_peakBytes, sample.sentBytes + sample.receivedBytes);
+    sampleChanged();
+}
+
+void BandwidthModel::addReceivedMessage(int size)
+{
+    auto &sample = currentSample();
+    sample.receivedBytes += size;
+    ++sample.receivedMessages;
+    m_peakBytes = std::max(m_peakBytes, sample.sentBytes + sample.receivedBytes);
+    sampleChanged();
+}
+
+BandwidthModel::Sample &BandwidthModel::currentSample()
+{
+    const qint64 now = m_clock.elapsed() / 1000;
+    const qint64 last = m_samples.isEmpty() ? -1 : m_samples.last().second;
+    if (now == last)
+        return m_samples.last();
+
+    // one row per second, also for seconds without traffic
+    const int newSamples = std::min<qint64>(now - last, MaximumSamples);
+    const int excess = m_samples.size() + newSamples - MaximumSamples;
+    if (excess > 0) {
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        m_samples.remove(0, excess);
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_samples.size(), m_samples.size() + newSamples - 1);
+    for (qint64 second = now - newSamples + 1; second <= now; ++second) {
+        Sample sample;
+        sample.second = second;
+        m_samples.push_back(sample);
+    }
+    endInsertRows();
+    return m_samples.last();
+}
+
+void BandwidthModel::sampleChanged()
+{
+    const int row = m_samples.size() - 1;
+    emit dataChanged(index(row, SentBytesColumn), index(row, ColumnCount - 1));
+}
+
+int BandwidthModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int BandwidthModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_samples.size();
+}
+
+QVariant BandwidthModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const auto &sample = m_samples.at(index.row());
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case TimeColumn:
+            return sample.second;
+        case SentBytesColumn:
+            return sample.sentBytes;
+        case ReceivedBytesColumn:
+            return sample.receivedBytes;
+        case SentMessagesColumn:
+            return sample.sentMessages;
+        case ReceivedMessagesColumn:
+            return sample.receivedMessages;
+        }
+    }
+
+    if (role == Qt::TextAlignmentRole)
+        return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+
+    // highlight busy seconds relative to the busiest one so far
+    if (role == Qt::BackgroundRole && index.column() == TimeColumn && m_peakBytes > 0) {
+        const auto ratio = (double)(sample.sentBytes + sample.receivedBytes) / (double)m_peakBytes;
+        if (ratio <= 0.0)
+            return QVariant();
+        auto color = QColor::fromHsvF(0.0, 0.5 * ratio, 1.0);
+        if (QApplication::palette().color(QPalette::Base).lightness() <= 128)
+            color = color.darker(300);
+        return color;
+    }
+
+    return QVariant();
+}
+
+QVariant BandwidthModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case TimeColumn:
+            return tr("Time [s]");
+        case SentBytesColumn:
+            return tr("Sent [B/s]");
+        case ReceivedBytesColumn:
+            return tr("Received [B/s]");
+        case SentMessagesColumn:
+            return tr("Sent Messages");
+        case ReceivedMessagesColumn:
+            return tr("Received Messages");
+        }
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
@@ -0,0 +1,84 @@
+/*
+  bandwidthmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_BANDWIDTHMODEL_H
+#define GAMMARAY_BANDWIDTHMODEL_H
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QVector>
+
+namespace GammaRay {
+/** Diagnostics for GammaRay-internal communication, traffic per second over time. */
+class BandwidthModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        TimeColumn,
+        SentBytesColumn,
+        ReceivedBytesColumn,
+        SentMessagesColumn,
+        ReceivedMessagesColumn,
+        ColumnCount
+    };
+
+    /** Number of seconds kept, older samples are discarded. */
+    static const int MaximumSamples = 3600;
+
+    explicit BandwidthModel(QObject *parent = Q_NULLPTR);
+    ~BandwidthModel();
+
+    void clear();
+    void addSentMessage(int size);
+    void addReceivedMessage(int size);
+
+    int columnCount(const QModelIndex &parent) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const Q_DECL_OVERRIDE;
+
+private:
+    struct Sample {
+        Sample();
+        qint64 second;
+        qint64 sentBytes;
+        qint64 receivedBytes;
+        int sentMessages;
+        int receivedMessages;
+    };
+    /** Sample for the current second, with rows for all idle seconds before it. */
+    Sample &currentSample();
+    void sampleChanged();
+
+    QElapsedTimer m_clock;
+    QVector<Sample> m_samples;
+    qint64 m_peakBytes;
+};
+}
+
+#endif // GAMMARAY_BANDWIDTHMODEL_H
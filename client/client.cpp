@@ -27,8 +27,10 @@
 */
 
 #include "client.h"
+#include "bandwidthmodel.h"
 #include "clientdevice.h"
 #include "messagestatisticsmodel.h"
+#include "requestlatencymodel.h"
 
 #include <common/message.h>
 #include <common/objectbroker.h>
@@ -45,6 +47,8 @@ Client::Client(QObject *parent)
     : Endpoint(parent)
     , m_clientDevice(0)
     , m_statModel(new MessageStatisticsModel)
+    , m_latencyModel(new RequestLatencyModel(this))
+    , m_bandwidthModel(new BandwidthModel(this))
     , m_initState(0)
 {
     connect(this, SIGNAL(disconnected()), SLOT(socketDisconnected()));
@@ -54,6 +58,10 @@ Client::Client(QObject *parent)
     ObjectBroker::registerModelInternal(QStringLiteral(
                                             "com.kdab.GammaRay.MessageStatisticsModel"),
                                         m_statModel);
+    ObjectBroker::registerModelInternal(QStringLiteral("com.kdab.GammaRay.RequestLatencyModel"),
+                                        m_latencyModel);
+    ObjectBroker::registerModelInternal(QStringLiteral("com.kdab.GammaRay.BandwidthModel"),
+                                        m_bandwidthModel);
 }
 
 Client::~Client()
@@ -81,6 +89,8 @@ void Client::connectToHost(const QUrl &url, int tryAgain)
     m_initState = 0;
 
     m_statModel->clear();
+    m_latencyModel->clear();
+    m_bandwidthModel->clear();
     m_clientDevice = ClientDevice::create(m_serverAddress, this);
     if (!m_clientDevice) {
         emit persisitentConnectionError(tr("Unsupported transport protocol."));
@@ -130,6 +140,7 @@ void Client::socketDisconnected()
 void Client::messageReceived(const Message &msg)
 {
     m_statModel->addMessage(msg.address(), msg.type(), msg.size());
+    m_bandwidthModel->addReceivedMessage(msg.size());
     // server version must be the very first message we get
     if (!(m_initState & VersionChecked)) {
         if (msg.address() != endpointAddress() || msg.type() != Protocol::ServerVersion) {
@@ -158,6 +169,7 @@ void Client::messageReceived(const Message &msg)
             msg >> name >> addr;
             addObjectNameAddressMapping(name, addr);
             m_statModel->addObject(addr, name);
+            m_latencyModel->addObject(addr, name);
             break;
         }
         case Protocol::ObjectRemoved:
@@ -177,6 +189,7 @@ void Client::messageReceived(const Message &msg)
                 if (it->first != endpointAddress())
                     addObjectNameAddressMapping(it->second, it->first);
                 m_statModel->addObject(it->first, it->second);
+                m_latencyModel->addObject(it->first, it->second);
             }
 
             m_propertySyncer->setAddress(objectAddress(QStringLiteral(
@@ -230,6 +243,14 @@ void Client::registerMessageHandler(Protocol::ObjectAddress objectAddress, QObje
     monitorObject(objectAddress);
 }
 
+void Client::registerMessageHandler(Protocol::ObjectAddress objectAddress, QObject *receiver,
+                                    MessageHandlerCallback callback)
+{
+    Q_ASSERT(isConnected());
+    Endpoint::registerMessageHandler(objectAddress, receiver, callback);
+    monitorObject(objectAddress);
+}
+
 void Client::unregisterMessageHandler(Protocol::ObjectAddress objectAddress)
 {
     Endpoint::unregisterMessageHandler(objectAddress);
@@ -268,5 +289,13 @@ void Client::unmonitorObject(Protocol::ObjectAddress objectAddress)
 void Client::doSendMessage(const GammaRay::Message &msg)
 {
     m_statModel->addMessage(msg.address(), msg.type(), msg.size());
+    m_bandwidthModel->addSentMessage(msg.size());
     Endpoint::doSendMessage(msg);
 }
+
+void Client::addRequestLatency(Protocol::ObjectAddress objectAddress,
+                               Protocol::MessageType requestType, qint64 roundTrip,
+                               qint64 serverTime)
+{
+    m_latencyModel->addRequest(objectAddress, requestType, roundTrip, serverTime);
+}
@@ -35,8 +35,10 @@
 #include <QUrl>
 
 namespace GammaRay {
+class BandwidthModel;
 class ClientDevice;
 class MessageStatisticsModel;
+class RequestLatencyModel;
 
 /** Client-side connection endpoint. */
 class Client : public Endpoint
@@ -61,10 +63,19 @@ public:
     bool isRemoteClient() const Q_DECL_OVERRIDE;
     QUrl serverAddress() const Q_DECL_OVERRIDE;
 
+    using Endpoint::registerMessageHandler;
     void registerMessageHandler(Protocol::ObjectAddress objectAddress, QObject *receiver,
                                 const char *messageHandlerName) Q_DECL_OVERRIDE;
+    void registerMessageHandler(Protocol::ObjectAddress objectAddress, QObject *receiver,
+                                MessageHandlerCallback callback) Q_DECL_OVERRIDE;
     void unregisterMessageHandler(Protocol::ObjectAddress objectAddress) Q_DECL_OVERRIDE;
 
+    /** Record the reply to a request of type @p requestType sent to @p objectAddress.
+     *  @p roundTrip and @p serverTime are in microseconds.
+     */
+    void addRequestLatency(Protocol::ObjectAddress objectAddress, Protocol::MessageType requestType,
+                           qint64 roundTrip, qint64 serverTime);
+
 signals:
     /** Emitted on transient connection errors.
      *  That is, on errors it's worth re-trying, e.g. because the target wasn't up yet.
@@ -104,6 +115,8 @@ private:
     QUrl m_serverAddress;
     ClientDevice *m_clientDevice;
     MessageStatisticsModel *m_statModel;
+    RequestLatencyModel *m_latencyModel;
+    BandwidthModel *m_bandwidthModel;
     int m_initState;
 };
 }
@@ -68,6 +68,7 @@ static const MetaEnum::Value<Protocol::MessageType> message_type_table[] = {
     M(ModelLayoutChanged),
     M(SelectionModelSelect),
     M(SelectionModelCurrent),
+    M(MethodIdDefinition),
     M(MethodCall),
     M(PropertySyncRequest),
     M(PropertyValuesChanged),
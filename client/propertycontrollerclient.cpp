@@ -42,3 +42,8 @@ PropertyControllerClient::PropertyControllerClient(const QString &name, QObject
 PropertyControllerClient::~PropertyControllerClient()
 {
 }
+
+void PropertyControllerClient::setMaximumUpdateRate(int rate)
+{
+    Endpoint::instance()->invokeObject(name(), "setMaximumUpdateRate", QVariantList() << rate);
+}
@@ -39,6 +39,9 @@ class PropertyControllerClient : public PropertyControllerInterface
 public:
     explicit PropertyControllerClient(const QString &name, QObject *parent = 0);
     virtual ~PropertyControllerClient();
+
+public slots:
+    void setMaximumUpdateRate(int rate) Q_DECL_OVERRIDE;
 };
 }
 
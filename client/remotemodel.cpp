@@ -34,6 +34,7 @@
 #include <QApplication>
 #include <QDataStream>
 #include <QDebug>
+#include <QPixmap>
 #include <QStyle>
 #include <QStyleOptionViewItem>
 
@@ -95,10 +96,15 @@ QVariant RemoteModel::s_emptySizeHintValue;
 RemoteModel::RemoteModel(const QString &serverObject, QObject *parent)
     : QAbstractItemModel(parent)
     , m_pendingDataRequestsTimer(new QTimer(this))
+    , m_accessCounter(0)
+    , m_cachedRowCount(0)
+    , m_maximumCacheSize(20000)
+    , m_eagerRolesKnown(false)
     , m_serverObject(serverObject)
     , m_myAddress(Protocol::InvalidObjectAddress)
     , m_currentSyncBarrier(0)
     , m_targetSyncBarrier(0)
+    , m_lastRequestId(0)
     , m_proxyDynamicSortFilter(false)
     , m_proxyCaseSensitivity(Qt::CaseSensitive)
     , m_proxyKeyColumn(0)
@@ -118,6 +124,13 @@ RemoteModel::RemoteModel(const QString &serverObject, QObject *parent)
     }
 
     m_root = new Node;
+    m_requestClock.start();
+
+    // roles used by the default delegate, so painting a view doesn't trigger follow-up requests
+    m_eagerRoles << Qt::DisplayRole << Qt::DecorationRole << Qt::EditRole << Qt::FontRole
+                 << Qt::TextAlignmentRole << Qt::BackgroundRole << Qt::ForegroundRole
+                 << Qt::CheckStateRole << Qt::SizeHintRole;
+    std::sort(m_eagerRoles.begin(), m_eagerRoles.end());
 
     m_pendingDataRequestsTimer->setInterval(0);
     m_pendingDataRequestsTimer->setSingleShot(true);
@@ -203,6 +216,7 @@ QVariant RemoteModel::data(const QModelIndex &index, int role) const
     const auto state = stateForColumn(node, index.column());
     if (role == RemoteModelRole::LoadingState)
         return QVariant::fromValue(state);
+    node->lastAccess = ++m_accessCounter;
 
     // for size hint we don't want to trigger loading, as that's largely used for item view layouting
     if (state & RemoteModelNodeState::Empty) {
@@ -219,9 +233,26 @@ QVariant RemoteModel::data(const QModelIndex &index, int role) const
         return QVariant();
     }
 
-    // note .value returns good defaults otherwise
     Q_ASSERT(node->data.size() > index.column());
-    return node->data.at(index.column()).value(role);
+    const auto &cellData = node->data.at(index.column());
+    const auto it = cellData.constFind(role);
+    if (it != cellData.constEnd())
+        return it.value();
+
+    // role we haven't fetched for this cell yet
+    if (isLazyRole(role)) {
+        if (state == RemoteModelNodeState::NoState)
+            requestRoleData(index, role);
+        return QVariant();
+    }
+
+    // include it in all content requests from now on, and refetch the rows around this one
+    // in one go, rather than sending follow-up requests for every cell
+    addEagerRole(role);
+    markOutdated(node->parent, index.row());
+    if ((stateForColumn(node, index.column()) & RemoteModelNodeState::Loading) == 0)
+        requestDataAndFlags(index);
+    return QVariant();
 }
 
 bool RemoteModel::setData(const QModelIndex &index, const QVariant &value, int role)
@@ -278,6 +309,15 @@ void RemoteModel::sort(int column, Qt::SortOrder order)
 
 void RemoteModel::newMessage(const GammaRay::Message &msg)
 {
+    switch (msg.type()) {
+    case Protocol::ModelRowColumnCountReply:
+    case Protocol::ModelContentReply:
+    case Protocol::ModelHeaderReply:
+        // also for replies we are going to discard, they still tell us about the latency
+        endRequest(msg);
+        break;
+    }
+
     if (!checkSyncBarrier(msg))
         return;
 
@@ -298,6 +338,14 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
         }
         qint32 rowCount, columnCount;
         msg >> rowCount >> columnCount;
+        if (node == m_root) {
+            msg >> m_lazyRoles;
+            // the delegate roles we start out with might be too expensive for this model
+            m_eagerRoles.erase(std::remove_if(m_eagerRoles.begin(), m_eagerRoles.end(),
+                                              [this](qint32 role) {
+                return isLazyRole(role);
+            }), m_eagerRoles.end());
+        }
         // we get -1/-1 if we requested for an invalid index, e.g. due to not having processed
         // all structure changes yet. This will automatically trigger a retry.
         Q_ASSERT((rowCount >= 0 && columnCount >= 0) || (rowCount == -1 && columnCount == -1));
@@ -342,42 +390,92 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
 
     case Protocol::ModelContentReply:
     {
-        quint32 size;
-        msg >> size;
-        Q_ASSERT(size > 0);
+        quint32 iconCount;
+        msg >> iconCount;
+        for (quint32 i = 0; i < iconCount; ++i) {
+            quint32 iconId;
+            QPixmap pixmap;
+            msg >> iconId >> pixmap;
+            m_icons.insert(iconId, QVariant::fromValue(pixmap));
+        }
+        // cells below might still refer to those, so drop them only afterwards
+        QVector<quint32> removedIcons;
+        msg >> removedIcons;
+
+        quint32 rangeCount;
+        msg >> rangeCount;
+        Q_ASSERT(rangeCount > 0);
 
         QHash<QModelIndex, QVector<QModelIndex> > dataChangedIndexes;
-        for (quint32 i = 0; i < size; ++i) {
-            Protocol::ModelIndex index;
-            msg >> index;
-            Node *node = nodeForIndex(index);
-            const auto column = index.last().second;
-            const auto state = node ? stateForColumn(node, column) : RemoteModelNodeState::NoState;
-            typedef QHash<int, QVariant> ItemData;
-            ItemData itemData;
-            qint32 flags;
-            msg >> itemData >> flags;
-            if ((state & RemoteModelNodeState::Loading) == 0)
-                continue; // we didn't ask for this, probably outdated response for a moved cell
-
-            if (node) {
-                node->allocateColumns();
-                Q_ASSERT(node->data.size() > column);
-                node->data[column] = itemData;
-                node->flags[column] = static_cast<Qt::ItemFlags>(flags);
-                node->state[column] = state & ~(RemoteModelNodeState::Loading | RemoteModelNodeState::Empty | RemoteModelNodeState::Outdated);
+        for (quint32 i = 0; i < rangeCount; ++i) {
+            Protocol::ModelIndex parentIndex;
+            qint32 firstRow, lastRow, firstColumn, lastColumn;
+            QVector<qint32> roles;
+            bool mergeRoles;
+            msg >> parentIndex >> firstRow >> lastRow >> firstColumn >> lastColumn >> roles
+            >> mergeRoles;
+            Node *parentNode = nodeForIndex(parentIndex);
+
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                QVector<qint32> flags;
+                msg >> flags;
+                Q_ASSERT(flags.size() == lastRow - firstRow + 1);
+                for (int row = firstRow; row <= lastRow; ++row) {
+                    typedef QHash<int, QVariant> ItemData;
+                    ItemData itemData;
+                    QHash<qint32, quint32> iconIds;
+                    msg >> itemData >> iconIds;
+
+                    Node *node = parentNode ? parentNode->children.value(row) : 0;
+                    const auto state = node && column < parentNode->columnCount
+                                       ? stateForColumn(node, column) : RemoteModelNodeState::NoState;
+                    if ((state & RemoteModelNodeState::Loading) == 0)
+                        continue; // we didn't ask for this, probably outdated response for a moved cell
+
+                    for (auto it = iconIds.constBegin(); it != iconIds.constEnd(); ++it)
+                        itemData.insert(it.key(), m_icons.value(it.value()));
+
+                    // remember which roles we have, so data() can tell invalid from not yet fetched
+                    if (roles.isEmpty() && !mergeRoles) {
+                        // a full reply, everything in there is something client code might read
+                        for (auto it = itemData.constBegin(); it != itemData.constEnd(); ++it)
+                            addEagerRole(it.key());
+                        m_eagerRolesKnown = true;
+                        addMissingRoles(itemData, m_eagerRoles);
+                    } else {
+                        addMissingRoles(itemData, roles);
+                    }
+
+                    node->allocateColumns();
+                    Q_ASSERT(node->data.size() > column);
+                    if (mergeRoles) {
+                        if (state & RemoteModelNodeState::Empty)
+                            continue; // content request pending, that will also answer this
+                        for (auto it = itemData.constBegin(); it != itemData.constEnd(); ++it)
+                            node->data[column].insert(it.key(), it.value());
+                        node->state[column] = state & ~RemoteModelNodeState::Loading;
+                        const QModelIndex qmi = modelIndexForNode(node, column);
+                        dataChangedIndexes[qmi.parent()].push_back(qmi);
+                        continue;
+                    }
+
+                    const auto cellFlags = flags.at(row - firstRow);
+                    node->data[column] = itemData;
+                    node->flags[column] = static_cast<Qt::ItemFlags>(cellFlags);
+                    node->state[column] = state & ~(RemoteModelNodeState::Loading | RemoteModelNodeState::Empty | RemoteModelNodeState::Outdated);
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-                if ((flags & Qt::ItemNeverHasChildren) && column == 0) {
-                    node->rowCount = 0;
-                    node->columnCount = node->data.size();
-                }
+                    if ((cellFlags & Qt::ItemNeverHasChildren) && column == 0) {
+                        node->rowCount = 0;
+                        node->columnCount = node->data.size();
+                    }
 #endif
 
-                // group by parent, and emit dataChange for the bounding rect per hierarchy level
-                // as an approximiation of perfect range batching
-                const QModelIndex qmi = modelIndexForNode(node, column);
-                dataChangedIndexes[qmi.parent()].push_back(qmi);
+                    // group by parent, and emit dataChange for the bounding rect per hierarchy level
+                    // as an approximiation of perfect range batching
+                    const QModelIndex qmi = modelIndexForNode(node, column);
+                    dataChangedIndexes[qmi.parent()].push_back(qmi);
+                }
             }
         }
 
@@ -395,6 +493,12 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
             const auto qmi = indexes.at(0);
             emit dataChanged(qmi.sibling(r1, c1), qmi.sibling(r2, c2));
         }
+
+        foreach (auto iconId, removedIcons)
+            m_icons.remove(iconId);
+
+        if (m_cachedRowCount > m_maximumCacheSize)
+            evictCachedData();
         break;
     }
 
@@ -642,6 +746,8 @@ void RemoteModel::serverUnregistered(const QString &objectName,
     Q_UNUSED(objectName);
     if (m_myAddress == objectAddress) {
         m_myAddress = Protocol::InvalidObjectAddress;
+        m_icons.clear();
+        m_pendingRequests.clear();
         clear();
     }
 }
@@ -706,7 +812,7 @@ void RemoteModel::requestRowColumnCount(const QModelIndex &index) const
     node->rowCount = -2;
 
     Message msg(m_myAddress, Protocol::ModelRowColumnCountRequest);
-    msg << Protocol::fromQModelIndex(index);
+    msg << beginRequest(Protocol::ModelRowColumnCountRequest) << Protocol::fromQModelIndex(index);
     sendMessage(msg);
 }
 
@@ -715,12 +821,8 @@ void RemoteModel::requestDataAndFlags(const QModelIndex &index) const
     Node *node = nodeForIndex(index);
     Q_ASSERT(node);
 
-    const auto state = stateForColumn(node, index.column());
-    Q_ASSERT((state & RemoteModelNodeState::Loading) == 0);
-
-    node->allocateColumns();
-    Q_ASSERT(node->state.size() > index.column());
-    node->state[index.column()] = state | RemoteModelNodeState::Loading; // mark pending request
+    Q_ASSERT((stateForColumn(node, index.column()) & RemoteModelNodeState::Loading) == 0);
+    markLoading(node, index.column());
 
     m_pendingDataRequests.push_back(Protocol::fromQModelIndex(index));
     if (m_pendingDataRequests.size() > 100) {
@@ -731,17 +833,266 @@ void RemoteModel::requestDataAndFlags(const QModelIndex &index) const
     }
 }
 
+void RemoteModel::markLoading(RemoteModel::Node *node, int column) const
+{
+    const auto state = stateForColumn(node, column);
+    if (!node->hasColumnData())
+        ++m_cachedRowCount;
+    node->allocateColumns();
+    Q_ASSERT(node->state.size() > column);
+    node->state[column] = state | RemoteModelNodeState::Loading; // mark pending request
+}
+
+void RemoteModel::addPrefetchRequests(RemoteModel::Node *parentNode,
+                                      RemoteModel::PendingRows &pending) const
+{
+    if (parentNode->rowCount <= 0 || parentNode->columnCount <= 0)
+        return;
+
+    // the requests of one view update approximate the visible range,
+    // prefetch one range length before and after, within reasonable limits
+    const auto minMax = std::minmax_element(pending.rows.constBegin(), pending.rows.constEnd());
+    const auto window = qBound(16, *minMax.second - *minMax.first + 1, 256);
+    const auto firstRow = std::max(0, *minMax.first - window);
+    const auto lastRow = std::min(parentNode->rowCount - 1, *minMax.second + window);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        Node *node = parentNode->children.at(row);
+        bool prefetched = false;
+        for (int column = 0; column < parentNode->columnCount; ++column) {
+            // only fetch what we never had, outdated content is refetched when actually needed
+            const auto state = stateForColumn(node, column);
+            if ((state & RemoteModelNodeState::Empty) == 0 || (state & RemoteModelNodeState::Loading))
+                continue;
+            markLoading(node, column);
+            prefetched = true;
+        }
+        if (prefetched) {
+            node->lastAccess = m_accessCounter;
+            pending.rows.push_back(row);
+            pending.firstColumn = 0;
+            pending.lastColumn = parentNode->columnCount - 1;
+        }
+    }
+}
+
+void RemoteModel::requestRoleData(const QModelIndex &index, int role) const
+{
+    Node *node = nodeForIndex(index);
+    Q_ASSERT(node);
+    Q_ASSERT(stateForColumn(node, index.column()) == RemoteModelNodeState::NoState);
+
+    markLoading(node, index.column());
+    m_pendingRoleRequests[role].push_back(Protocol::fromQModelIndex(index));
+    m_pendingDataRequestsTimer->start();
+}
+
+bool RemoteModel::isLazyRole(int role) const
+{
+    return std::binary_search(m_lazyRoles.constBegin(), m_lazyRoles.constEnd(), role);
+}
+
+void RemoteModel::addEagerRole(int role) const
+{
+    const auto it = std::lower_bound(m_eagerRoles.begin(), m_eagerRoles.end(), role);
+    if (it == m_eagerRoles.end() || *it != role)
+        m_eagerRoles.insert(it, role);
+}
+
+void RemoteModel::markOutdated(RemoteModel::Node *parentNode, int row) const
+{
+    // views show rows close to each other, the same window the prefetching uses covers them
+    const auto firstRow = std::max(0, row - 256);
+    const auto lastRow = std::min(parentNode->children.size() - 1, row + 256);
+    for (int r = firstRow; r <= lastRow; ++r) {
+        Node *node = parentNode->children.at(r);
+        for (auto it = node->state.begin(); it != node->state.end(); ++it) {
+            if (((*it) & RemoteModelNodeState::Empty) == 0)
+                (*it) |= RemoteModelNodeState::Outdated;
+        }
+    }
+}
+
+void RemoteModel::addMissingRoles(QHash<int, QVariant> &itemData, const QVector<qint32> &roles)
+{
+    foreach (auto role, roles) {
+        if (!itemData.contains(role))
+            itemData.insert(role, QVariant());
+    }
+}
+
+QHash<RemoteModel::Node *, RemoteModel::PendingRows> RemoteModel::groupByParent(
+    const QVector<Protocol::ModelIndex> &indexes) const
+{
+    QHash<Node *, PendingRows> pendingRows;
+    foreach (const auto &index, indexes) {
+        Q_ASSERT(!index.isEmpty());
+        const auto parent = index.mid(0, index.size() - 1);
+        Node *parentNode = nodeForIndex(parent);
+        if (!parentNode)
+            continue;
+        auto it = pendingRows.find(parentNode);
+        if (it == pendingRows.end()) {
+            PendingRows rows;
+            rows.parent = parent;
+            rows.firstColumn = index.last().second;
+            rows.lastColumn = index.last().second;
+            it = pendingRows.insert(parentNode, rows);
+        }
+        it.value().rows.push_back(index.last().first);
+        it.value().firstColumn = std::min(it.value().firstColumn, index.last().second);
+        it.value().lastColumn = std::max(it.value().lastColumn, index.last().second);
+    }
+    return pendingRows;
+}
+
+QVector<QPair<qint32, qint32> > RemoteModel::consecutiveRows(QVector<qint32> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    QVector<QPair<qint32, qint32> > runs;
+    foreach (auto row, rows) {
+        if (!runs.isEmpty() && runs.last().second >= row - 1)
+            runs.last().second = row;
+        else
+            runs.push_back(qMakePair(row, row));
+    }
+    return runs;
+}
+
+QVector<QPair<qint32, qint32> > RemoteModel::loadingColumns(RemoteModel::Node *parentNode,
+                                                            const QPair<qint32, qint32> &rows,
+                                                            qint32 firstColumn, qint32 lastColumn) const
+{
+    QVector<QPair<qint32, qint32> > runs;
+    for (int column = firstColumn; column <= lastColumn && column < parentNode->columnCount; ++column) {
+        bool loading = false;
+        for (int row = rows.first; row <= rows.second && row < parentNode->children.size() && !loading; ++row)
+            loading = (stateForColumn(parentNode->children.at(row), column) & RemoteModelNodeState::Loading) != 0;
+        if (!loading)
+            continue;
+        if (!runs.isEmpty() && runs.last().second == column - 1)
+            runs.last().second = column;
+        else
+            runs.push_back(qMakePair(column, column));
+    }
+    return runs;
+}
+
 void RemoteModel::doRequestDataAndFlags() const
 {
-    Q_ASSERT(!m_pendingDataRequests.isEmpty());
-    Message msg(m_myAddress, Protocol::ModelContentRequest);
-    msg << quint32(m_pendingDataRequests.size());
-    foreach (const auto &index, m_pendingDataRequests)
-        msg << index;
+    Q_ASSERT(!m_pendingDataRequests.isEmpty() || !m_pendingRoleRequests.isEmpty());
+
+    // merge consecutive rows below the same parent into ranges, so we need only a single index path per range
+    QVector<RequestRange> ranges;
+    auto pendingRows = groupByParent(m_pendingDataRequests);
     m_pendingDataRequests.clear();
+    for (auto it = pendingRows.begin(); it != pendingRows.end(); ++it) {
+        Node *parentNode = it.key();
+        auto &pending = it.value();
+        addPrefetchRequests(parentNode, pending);
+
+        foreach (const auto &run, consecutiveRows(pending.rows)) {
+            // cells inside the range we didn't explicitly ask for are updated as well if outdated
+            for (int row = run.first; row <= run.second && row < parentNode->children.size(); ++row) {
+                Node *node = parentNode->children.at(row);
+                for (int column = pending.firstColumn;
+                     column <= pending.lastColumn && column < parentNode->columnCount; ++column) {
+                    const auto state = stateForColumn(node, column);
+                    if ((state & RemoteModelNodeState::Outdated) && (state & RemoteModelNodeState::Loading) == 0)
+                        markLoading(node, column);
+                }
+            }
+
+            // don't ask for columns again that are up to date in all of these rows
+            foreach (const auto &columns, loadingColumns(parentNode, run, pending.firstColumn, pending.lastColumn)) {
+                RequestRange range;
+                range.parent = pending.parent;
+                range.firstRow = run.first;
+                range.lastRow = run.second;
+                range.firstColumn = columns.first;
+                range.lastColumn = columns.second;
+                if (m_eagerRolesKnown)
+                    range.roles = m_eagerRoles;
+                range.mergeRoles = false;
+                ranges.push_back(range);
+            }
+        }
+    }
+
+    // follow-up requests for single roles of already loaded cells
+    for (auto roleIt = m_pendingRoleRequests.constBegin(); roleIt != m_pendingRoleRequests.constEnd(); ++roleIt) {
+        pendingRows = groupByParent(roleIt.value());
+        for (auto it = pendingRows.constBegin(); it != pendingRows.constEnd(); ++it) {
+            foreach (const auto &run, consecutiveRows(it.value().rows)) {
+                foreach (const auto &columns, loadingColumns(it.key(), run, it.value().firstColumn, it.value().lastColumn)) {
+                    RequestRange range;
+                    range.parent = it.value().parent;
+                    range.firstRow = run.first;
+                    range.lastRow = run.second;
+                    range.firstColumn = columns.first;
+                    range.lastColumn = columns.second;
+                    range.roles.push_back(roleIt.key());
+                    range.mergeRoles = true;
+                    ranges.push_back(range);
+                }
+            }
+        }
+    }
+    m_pendingRoleRequests.clear();
+
+    if (ranges.isEmpty())
+        return;
+
+    Message msg(m_myAddress, Protocol::ModelContentRequest);
+    msg << beginRequest(Protocol::ModelContentRequest) << quint32(ranges.size());
+    foreach (const auto &range, ranges) {
+        msg << range.parent << range.firstRow << range.lastRow << range.firstColumn
+            << range.lastColumn << range.roles << range.mergeRoles;
+    }
     sendMessage(msg);
 }
 
+void RemoteModel::evictCachedData()
+{
+    QVector<Node *> evictable;
+    int cachedCount = 0;
+    collectCachedNodes(m_root, evictable, cachedCount);
+    m_cachedRowCount = cachedCount;
+
+    // evict down to 3/4 of the limit, so we don't have to do this on every reply
+    const auto targetCount = m_maximumCacheSize * 3 / 4;
+    const auto evictCount = std::min(cachedCount - targetCount, evictable.size());
+    if (evictCount <= 0)
+        return;
+
+    const auto cutOff = evictable.begin() + evictCount;
+    std::nth_element(evictable.begin(), cutOff, evictable.end(), [](Node *lhs, Node *rhs) {
+        return lhs->lastAccess < rhs->lastAccess;
+    });
+    for (auto it = evictable.begin(); it != cutOff; ++it) {
+        (*it)->data.clear();
+        (*it)->flags.clear();
+        (*it)->state.clear();
+    }
+    m_cachedRowCount -= evictCount;
+}
+
+void RemoteModel::collectCachedNodes(RemoteModel::Node *node, QVector<Node *> &evictable,
+                                     int &cachedCount) const
+{
+    foreach (auto child, node->children) {
+        if (child->hasColumnData()) {
+            ++cachedCount;
+            // pending replies expect allocated column data, so keep those
+            if (std::find_if(child->state.constBegin(), child->state.constEnd(),
+                             [](RemoteModelNodeState::NodeStates state) {
+                    return state & RemoteModelNodeState::Loading;
+                }) == child->state.constEnd())
+                evictable.push_back(child);
+        }
+        collectCachedNodes(child, evictable, cachedCount);
+    }
+}
+
 void RemoteModel::requestHeaderData(Qt::Orientation orientation, int section) const
 {
     Q_ASSERT(section >= 0);
@@ -751,10 +1102,35 @@ void RemoteModel::requestHeaderData(Qt::Orientation orientation, int section) co
     headers[section][Qt::DisplayRole] = s_emptyDisplayValue;
 
     Message msg(m_myAddress, Protocol::ModelHeaderRequest);
-    msg << qint8(orientation) << qint32(section);
+    msg << beginRequest(Protocol::ModelHeaderRequest) << qint8(orientation) << qint32(section);
     sendMessage(msg);
 }
 
+quint32 RemoteModel::beginRequest(Protocol::MessageType type) const
+{
+    m_pendingRequests.insert(++m_lastRequestId, qMakePair(type, m_requestClock.nsecsElapsed()));
+    return m_lastRequestId;
+}
+
+void RemoteModel::endRequest(const Message &msg)
+{
+    quint32 requestId, serverTime;
+    msg >> requestId >> serverTime;
+
+    // replies arrive in request order, anything older has been dropped by the server
+    // (e.g. while it had no source model), and will never be answered
+    auto it = m_pendingRequests.begin();
+    while (it != m_pendingRequests.end() && it.key() < requestId)
+        it = m_pendingRequests.erase(it);
+    if (it == m_pendingRequests.end() || it.key() != requestId)
+        return;
+
+    const qint64 roundTrip = (m_requestClock.nsecsElapsed() - it.value().second) / 1000;
+    if (Client::instance())
+        Client::instance()->addRequestLatency(m_myAddress, it.value().first, roundTrip, serverTime);
+    m_pendingRequests.erase(it);
+}
+
 void RemoteModel::clear()
 {
     beginResetModel();
@@ -767,6 +1143,7 @@ void RemoteModel::clear()
 
     delete m_root;
     m_root = new Node;
+    m_cachedRowCount = 0;
     m_horizontalHeaders.clear();
     m_verticalHeaders.clear();
     endResetModel();
@@ -778,8 +1155,9 @@ void RemoteModel::connectToServer()
         return;
 
     beginResetModel();
+    m_icons.clear();
     Client::instance()->registerObject(m_serverObject, this);
-    Client::instance()->registerMessageHandler(m_myAddress, this, "newMessage");
+    Client::instance()->registerMessageHandler<RemoteModel, &RemoteModel::newMessage>(m_myAddress, this);
     endResetModel();
 }
 
@@ -35,6 +35,8 @@
 #include <common/remotemodelroles.h>
 
 #include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QMap>
 #include <QRegExp>
 #include <QSet>
 #include <QTimer>
@@ -91,7 +93,8 @@ private:
         Node()
             : parent(0)
             , rowCount(-1)
-            , columnCount(-1) {}
+            , columnCount(-1)
+            , lastAccess(0) {}
         ~Node();
         Q_DISABLE_COPY(Node)
         // delete all cached children data, but assume row/column count on this level is still accurate
@@ -111,6 +114,7 @@ private:
         QVector<QHash<int, QVariant> > data; // column -> role -> data
         QVector<Qt::ItemFlags> flags;      // column -> flags
         QVector<RemoteModelNodeState::NodeStates> state;         // column -> state (cache outdated, waiting for data, etc)
+        quint64 lastAccess; // access counter value of the last data() call, for cache eviction
     };
 
     void clear();
@@ -129,7 +133,53 @@ private:
 
     void requestRowColumnCount(const QModelIndex &index) const;
     void requestDataAndFlags(const QModelIndex &index) const;
+    /// mark @p column of @p node as loading, allocating column data if necessary
+    void markLoading(Node *node, int column) const;
+    /// pending data requests below a common parent node
+    struct PendingRows {
+        Protocol::ModelIndex parent;
+        QVector<qint32> rows;
+        qint32 firstColumn;
+        qint32 lastColumn;
+    };
+    /// a block of cells as sent to the server in a content request
+    struct RequestRange {
+        Protocol::ModelIndex parent;
+        qint32 firstRow;
+        qint32 lastRow;
+        qint32 firstColumn;
+        qint32 lastColumn;
+        QVector<qint32> roles; // empty for all roles
+        bool mergeRoles; // add to the existing cell content rather than replacing it
+    };
+    QHash<Node *, PendingRows> groupByParent(const QVector<Protocol::ModelIndex> &indexes) const;
+    /// sorts @p rows and merges them into ranges of consecutive rows
+    static QVector<QPair<qint32, qint32> > consecutiveRows(QVector<qint32> rows);
+    /// contiguous blocks of columns within [@p firstColumn, @p lastColumn] containing loading cells in @p rows
+    QVector<QPair<qint32, qint32> > loadingColumns(Node *parentNode, const QPair<qint32, qint32> &rows,
+                                                   qint32 firstColumn, qint32 lastColumn) const;
+    /// extend the pending data requests by a prefetch window around the requested rows
+    void addPrefetchRequests(Node *parentNode, PendingRows &pending) const;
+
+    /// fetch @p role for the already loaded cell @p index
+    void requestRoleData(const QModelIndex &index, int role) const;
+    /// roles the server only sends when actually asked for, rather than with every content request
+    bool isLazyRole(int role) const;
+    /// include @p role in all content requests from now on
+    void addEagerRole(int role) const;
+    /// mark the loaded cells in the rows around @p row below @p parentNode as outdated,
+    /// so they are refetched when accessed next
+    void markOutdated(Node *parentNode, int row) const;
+    /// add invalid entries for @p roles not contained in @p itemData, to mark them as fetched
+    static void addMissingRoles(QHash<int, QVariant> &itemData, const QVector<qint32> &roles);
+    /// drop the cached data of the least recently used rows, if we exceed the cache limit
+    void evictCachedData();
+    void collectCachedNodes(Node *node, QVector<Node *> &evictable, int &cachedCount) const;
     void requestHeaderData(Qt::Orientation orientation, int section) const;
+    /// start measuring the latency of a request of type @p type, returns the request id to send
+    quint32 beginRequest(Protocol::MessageType type) const;
+    /// read request id and server time from the reply @p msg, and record the request latency
+    void endRequest(const Message &msg);
     /// Reset the loading state for all rows at @p startRow or later.
     /// This is needed when rows have been added or removed before @p startRow, since
     /// pending replies might have a wrong index.
@@ -167,14 +217,34 @@ private:
     mutable QVector<QHash<int, QVariant> > m_horizontalHeaders; // section -> role -> data
     mutable QVector<QHash<int, QVariant> > m_verticalHeaders; // section -> role -> data
 
+    // icon table id -> icon, icons are transferred only once by the server
+    QHash<quint32, QVariant> m_icons;
+
     mutable QVector<Protocol::ModelIndex> m_pendingDataRequests;
     QTimer *m_pendingDataRequestsTimer;
 
+    // LRU cache eviction state
+    mutable quint64 m_accessCounter;
+    mutable int m_cachedRowCount; // upper bound of the number of rows with column data
+    int m_maximumCacheSize; // rows
+
+    // role negotiation, content requests ask for all but the lazy roles until the first reply
+    // tells us what the model provides, from then on only for those and the roles views asked for
+    QVector<qint32> m_lazyRoles; // sorted, provided by the server
+    mutable QVector<qint32> m_eagerRoles; // sorted
+    bool m_eagerRolesKnown;
+    mutable QHash<int, QVector<Protocol::ModelIndex> > m_pendingRoleRequests; // role -> cells
+
     QString m_serverObject;
     Protocol::ObjectAddress m_myAddress;
 
     qint32 m_currentSyncBarrier, m_targetSyncBarrier;
 
+    // request latency diagnostics, request id -> (request type, send time in ns)
+    mutable QMap<quint32, QPair<Protocol::MessageType, qint64> > m_pendingRequests;
+    mutable quint32 m_lastRequestId;
+    QElapsedTimer m_requestClock;
+
     // default data() values for empty cells
     static QVariant s_emptyDisplayValue;
     static QVariant s_emptySizeHintValue;
@@ -0,0 +1,257 @@
+/*
+  requestlatencymodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "requestlatencymodel.h"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace GammaRay;
+
+LatencyDistribution::LatencyDistribution()
+    : count(0)
+    , max(0)
+{
+    memset(histogram, 0, sizeof(histogram));
+}
+
+void LatencyDistribution::add(qint64 usecs)
+{
+    usecs = std::max<qint64>(0, usecs);
+    ++count;
+    max = std::max(max, usecs);
+
+    int bucket = usecs;
+    if (usecs >= SubBuckets) {
+        int magnitude = 0;
+        while (usecs >> (magnitude + 1))
+            ++magnitude;
+        // the two bits below the leading one select the sub-bucket
+        const int subBucket = (usecs >> (magnitude - 2)) - SubBuckets;
+        bucket = std::min<int>((magnitude - 1) * SubBuckets + subBucket, Buckets - 1);
+    }
+    ++histogram[bucket];
+}
+
+qint64 LatencyDistribution::percentile(double fraction) const
+{
+    if (!count)
+        return 0;
+
+    const quint64 threshold = std::max<quint64>(1, quint64(std::ceil(fraction * count)));
+    quint64 sum = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        sum += histogram[i];
+        if (sum >= threshold)
+            return std::min(bucketUpperBound(i), max);
+    }
+    return max;
+}
+
+qint64 LatencyDistribution::bucketUpperBound(int bucket)
+{
+    if (bucket < SubBuckets)
+        return bucket;
+    const int magnitude = bucket / SubBuckets + 1;
+    const int subBucket = bucket % SubBuckets;
+    return (qint64(SubBuckets + subBucket + 1) << (magnitude - 2)) - 1;
+}
+
+RequestLatencyModel::RequestLatencyModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+RequestLatencyModel::~RequestLatencyModel()
+{
+}
+
+void RequestLatencyModel::clear()
+{
+    beginResetModel();
+    m_data.clear();
+    m_rows.clear();
+    m_names.clear();
+    endResetModel();
+}
+
+void RequestLatencyModel::addObject(Protocol::ObjectAddress addr, const QString &name)
+{
+    m_names.insert(addr, name);
+    const auto it = m_rows.constFind(addr);
+    if (it != m_rows.constEnd())
+        emit dataChanged(index(it.value(), ObjectColumn), index(it.value(), ObjectColumn));
+}
+
+void RequestLatencyModel::addRequest(Protocol::ObjectAddress addr,
+                                     Protocol::MessageType requestType, qint64 roundTrip,
+                                     qint64 serverTime)
+{
+    auto it = m_rows.constFind(addr);
+    if (it == m_rows.constEnd()) {
+        beginInsertRows(QModelIndex(), m_data.size(), m_data.size());
+        it = m_rows.insert(addr, m_data.size());
+        Info info;
+        info.address = addr;
+        m_data.push_back(info);
+        endInsertRows();
+    }
+
+    auto &info = m_data[it.value()];
+    info.roundTrip.add(roundTrip);
+    info.server.add(serverTime);
+    info.transfer.add(roundTrip - serverTime);
+    info.perType[requestType].add(roundTrip);
+    emit dataChanged(index(it.value(), CountColumn), index(it.value(), ColumnCount - 1));
+}
+
+int RequestLatencyModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int RequestLatencyModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_data.size();
+}
+
+static QString formatMilliseconds(qint64 usecs)
+{
+    return QString::number(usecs / 1000.0, 'f', 2);
+}
+
+static QString requestTypeName(Protocol::MessageType type)
+{
+    switch (type) {
+    case Protocol::ModelRowColumnCountRequest:
+        return QStringLiteral("ModelRowColumnCountRequest");
+    case Protocol::ModelContentRequest:
+        return QStringLiteral("ModelContentRequest");
+    case Protocol::ModelHeaderRequest:
+        return QStringLiteral("ModelHeaderRequest");
+    }
+    return QString::number(type);
+}
+
+QVariant RequestLatencyModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const auto &info = m_data.at(index.row());
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ObjectColumn:
+            return m_names.value(info.address, QString::number(info.address));
+        case CountColumn:
+            return info.roundTrip.count;
+        case MedianColumn:
+            return formatMilliseconds(info.roundTrip.percentile(0.5));
+        case P90Column:
+            return formatMilliseconds(info.roundTrip.percentile(0.9));
+        case P99Column:
+            return formatMilliseconds(info.roundTrip.percentile(0.99));
+        case MaxColumn:
+            return formatMilliseconds(info.roundTrip.max);
+        case ServerMedianColumn:
+            return formatMilliseconds(info.server.percentile(0.5));
+        case ServerP99Column:
+            return formatMilliseconds(info.server.percentile(0.99));
+        case TransferMedianColumn:
+            return formatMilliseconds(info.transfer.percentile(0.5));
+        }
+    }
+
+    if (role == Qt::TextAlignmentRole && index.column() != ObjectColumn)
+        return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+
+    if (role == Qt::ToolTipRole && index.column() == ObjectColumn) {
+        QStringList lines;
+        for (auto it = info.perType.constBegin(); it != info.perType.constEnd(); ++it) {
+            lines.push_back(tr("%1: %2 requests, median %3 ms, 99%: %4 ms")
+                            .arg(requestTypeName(it.key()))
+                            .arg(it.value().count)
+                            .arg(formatMilliseconds(it.value().percentile(0.5)))
+                            .arg(formatMilliseconds(it.value().percentile(0.99))));
+        }
+        lines.sort();
+        return lines.join(QStringLiteral("\n"));
+    }
+
+    return QVariant();
+}
+
+QVariant RequestLatencyModel::headerData(int section, Qt::Orientation orientation,
+                                         int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ObjectColumn:
+            return tr("Object Name");
+        case CountColumn:
+            return tr("Requests");
+        case MedianColumn:
+            return tr("Median [ms]");
+        case P90Column:
+            return tr("90% [ms]");
+        case P99Column:
+            return tr("99% [ms]");
+        case MaxColumn:
+            return tr("Max [ms]");
+        case ServerMedianColumn:
+            return tr("Server Median [ms]");
+        case ServerP99Column:
+            return tr("Server 99% [ms]");
+        case TransferMedianColumn:
+            return tr("Transfer Median [ms]");
+        }
+    }
+
+    if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        switch (section) {
+        case MedianColumn:
+        case P90Column:
+        case P99Column:
+        case MaxColumn:
+            return tr("Time from sending a request until its reply has been received.");
+        case ServerMedianColumn:
+        case ServerP99Column:
+            return tr("Time the server spent processing a request.");
+        case TransferMedianColumn:
+            return tr("Round trip time minus server processing time, i.e. time spent in transfer and queues.");
+        }
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
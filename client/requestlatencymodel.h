@@ -0,0 +1,105 @@
+/*
+  requestlatencymodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_REQUESTLATENCYMODEL_H
+#define GAMMARAY_REQUESTLATENCYMODEL_H
+
+#include <common/protocol.h>
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QVector>
+
+namespace GammaRay {
+/** Logarithmic histogram of latencies, with four sub-buckets per power of two. */
+struct LatencyDistribution
+{
+    enum {
+        SubBuckets = 4,
+        Buckets = 32 * SubBuckets
+    };
+
+    LatencyDistribution();
+    void add(qint64 usecs);
+    /** Estimated latency in us below which @p fraction of all samples stayed. */
+    qint64 percentile(double fraction) const;
+    static qint64 bucketUpperBound(int bucket);
+
+    quint64 count;
+    qint64 max; // us
+    quint32 histogram[Buckets];
+};
+
+/** Diagnostics for the round trip time of requests to remote objects. */
+class RequestLatencyModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        ObjectColumn,
+        CountColumn,
+        MedianColumn,
+        P90Column,
+        P99Column,
+        MaxColumn,
+        ServerMedianColumn,
+        ServerP99Column,
+        TransferMedianColumn,
+        ColumnCount
+    };
+
+    explicit RequestLatencyModel(QObject *parent = Q_NULLPTR);
+    ~RequestLatencyModel();
+
+    void clear();
+    void addObject(Protocol::ObjectAddress addr, const QString &name);
+    /** Record a reply to a request of type @p requestType, which took @p roundTrip us,
+     *  @p serverTime us of which were spent processing it on the server.
+     */
+    void addRequest(Protocol::ObjectAddress addr, Protocol::MessageType requestType,
+                    qint64 roundTrip, qint64 serverTime);
+
+    int columnCount(const QModelIndex &parent) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const Q_DECL_OVERRIDE;
+
+private:
+    struct Info {
+        Protocol::ObjectAddress address;
+        LatencyDistribution roundTrip;
+        LatencyDistribution server;
+        LatencyDistribution transfer; // round trip minus server time
+        QHash<Protocol::MessageType, LatencyDistribution> perType; // round trip
+    };
+    QVector<Info> m_data;
+    QHash<Protocol::ObjectAddress, int> m_rows;
+    QHash<Protocol::ObjectAddress, QString> m_names;
+};
+}
+
+#endif // GAMMARAY_REQUESTLATENCYMODEL_H
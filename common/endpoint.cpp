@@ -30,12 +30,49 @@
 #include "message.h"
 #include "methodargument.h"
 #include "propertysyncer.h"
+#include "variantwrapper.h"
 
 #include <iostream>
+#include <limits>
 
 using namespace GammaRay;
 using namespace std;
 
+static QByteArray methodName(const QMetaMethod &method)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+    const QByteArray signature(method.signature());
+    return signature.left(signature.indexOf('('));
+#else
+    return method.name();
+#endif
+}
+
+static int parameterCount(const QMetaMethod &method)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+    return method.parameterTypes().size();
+#else
+    return method.parameterCount();
+#endif
+}
+
+static int parameterType(const QMetaMethod &method, int index)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+    return QMetaType::type(method.parameterTypes().at(index));
+#else
+    return method.parameterType(index);
+#endif
+}
+
+static int argumentType(const QVariant &arg)
+{
+    if (arg.userType() == qMetaTypeId<VariantWrapper>())
+        return QMetaType::QVariant;
+    return arg.userType();
+}
+
 Endpoint *Endpoint::s_instance = 0;
 
 Endpoint::Endpoint(QObject *parent)
@@ -119,6 +156,7 @@ void Endpoint::setDevice(QIODevice *device)
     Q_ASSERT(!m_socket);
     Q_ASSERT(device);
     m_socket = device;
+    clearMethodIds();
     connect(m_socket.data(), SIGNAL(readyRead()), SLOT(readyRead()));
     connect(m_socket.data(), SIGNAL(disconnected()), SLOT(connectionClosed()));
     if (m_socket->bytesAvailable())
@@ -139,6 +177,7 @@ void Endpoint::readyRead()
 void Endpoint::connectionClosed()
 {
     m_socket = 0;
+    clearMethodIds();
     emit disconnected();
 }
 
@@ -175,10 +214,34 @@ Protocol::ObjectAddress Endpoint::registerObject(const QString &name, QObject *o
 
 void Endpoint::invokeObject(const QString &objectName, const char *method,
                             const QVariantList &args) const
+{
+    invokeObjectRemote(objectName, QByteArray::fromRawData(method, qstrlen(method)), args);
+}
+
+void Endpoint::invokeObjectRemote(const QString &objectName, const QByteArray &method,
+                                  const QVariantList &args) const
 {
     if (!isConnected())
         return;
 
+    Q_ASSERT(args.size() <= 10);
+    quint16 methodId;
+    const Protocol::ObjectAddress addr = remoteMethodId(objectName, method, &methodId);
+    if (addr == Protocol::InvalidObjectAddress)
+        return;
+
+    Message msg(addr, Protocol::MethodCall);
+    msg << methodId << static_cast<quint8>(args.size());
+    foreach (const QVariant &arg, args)
+        msg << arg;
+    send(msg);
+}
+
+Protocol::ObjectAddress Endpoint::remoteMethodId(const QString &objectName,
+                                                 const QByteArray &method,
+                                                 quint16 *methodId) const
+{
+    Q_ASSERT(methodId);
     ObjectInfo *obj = m_nameMap.value(objectName, 0);
     Q_ASSERT(obj);
 
@@ -186,25 +249,107 @@ void Endpoint::invokeObject(const QString &objectName, const char *method,
 
     // cppcheck-suppress nullPointerRedundantCheck
     if (!obj || obj->address == Protocol::InvalidObjectAddress)
-        return;
+        return Protocol::InvalidObjectAddress;
+
+    Q_ASSERT(!method.isEmpty());
+
+    const QHash<QByteArray, quint16>::const_iterator it = obj->methodIds.constFind(method);
+    if (it != obj->methodIds.constEnd()) {
+        *methodId = it.value();
+        return obj->address;
+    }
+
+    Q_ASSERT(obj->methodIds.size() < std::numeric_limits<quint16>::max());
+    *methodId = obj->methodIds.size();
+    // deep copy, method might be a raw data wrapper
+    obj->methodIds.insert(QByteArray(method.constData(), method.size()), *methodId);
 
-    Message msg(obj->address, Protocol::MethodCall);
-    const QByteArray name(method);
-    Q_ASSERT(!name.isEmpty());
-    msg << name << args;
+    Message msg(obj->address, Protocol::MethodIdDefinition);
+    msg << *methodId << method;
     send(msg);
+    return obj->address;
 }
 
 void Endpoint::invokeObjectLocal(QObject *object, const char *method,
                                  const QVariantList &args) const
+{
+    const QMetaMethod m = lookupMethod(object->metaObject(),
+                                       QByteArray::fromRawData(method, qstrlen(method)), args);
+    if (m.methodIndex() < 0) {
+        cerr << "cannot call unknown method " << method << " on object of type "
+             << object->metaObject()->className() << endl;
+        return;
+    }
+    invokeMethodLocal(object, m, args);
+}
+
+QMetaMethod Endpoint::lookupMethod(const QMetaObject *mo, const QByteArray &method,
+                                   const QVariantList &args) const
+{
+    QHash<QPair<const QMetaObject *, QByteArray>, QVector<int> >::const_iterator it
+        = m_methodCache.constFind(qMakePair(mo, method));
+    if (it == m_methodCache.constEnd()) {
+        QVector<int> candidates;
+        for (int i = 0; i < mo->methodCount(); ++i) {
+            if (methodName(mo->method(i)) == method)
+                candidates.push_back(i);
+        }
+        it = m_methodCache.insert(qMakePair(mo, QByteArray(method.constData(), method.size())),
+                                  candidates);
+    }
+
+    // prefer an exact signature match, otherwise take the first overload we can convert the arguments for
+    int fallbackIndex = -1;
+    foreach (int methodIndex, it.value()) {
+        const QMetaMethod m = mo->method(methodIndex);
+        if (parameterCount(m) != args.size())
+            continue;
+        bool exactMatch = true;
+        for (int i = 0; i < args.size() && exactMatch; ++i)
+            exactMatch = parameterType(m, i) == argumentType(args.at(i));
+        if (exactMatch)
+            return m;
+        if (fallbackIndex < 0)
+            fallbackIndex = methodIndex;
+    }
+
+    if (fallbackIndex < 0)
+        return QMetaMethod();
+    return mo->method(fallbackIndex);
+}
+
+void Endpoint::invokeMethodLocal(QObject *object, const QMetaMethod &method,
+                                 const QVariantList &args) const
 {
     Q_ASSERT(args.size() <= 10);
     QVector<MethodArgument> a(10);
-    for (int i = 0; i < args.size(); ++i)
-        a[i] = MethodArgument(args.at(i));
+    for (int i = 0; i < args.size() && i < parameterCount(method); ++i) {
+        QVariant arg = args.at(i);
+        const int type = parameterType(method, i);
+        if (type == QMetaType::QVariant && argumentType(arg) != QMetaType::QVariant) {
+            arg = QVariant::fromValue(VariantWrapper(arg));
+        } else if (type != QMetaType::Void && type != QMetaType::QVariant
+                   && arg.isValid() && arg.userType() != type
+                   && !arg.convert(static_cast<QVariant::Type>(type))) {
+            cerr << "cannot convert argument " << i << " of type " << arg.typeName() << " for call to "
+                 << methodName(method).constData() << " on object of type "
+                 << object->metaObject()->className() << endl;
+            return;
+        }
+        a[i] = MethodArgument(arg);
+    }
 
-    QMetaObject::invokeMethod(object, method, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8],
-                              a[9]);
+    method.invoke(object, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9]);
+}
+
+void Endpoint::clearMethodIds()
+{
+    for (QHash<Protocol::ObjectAddress, ObjectInfo *>::const_iterator it =
+             m_addressMap.constBegin();
+         it != m_addressMap.constEnd(); ++it) {
+        it.value()->methodIds.clear();
+        it.value()->remoteMethods.clear();
+    }
 }
 
 void Endpoint::addObjectNameAddressMapping(const QString &objectName,
@@ -235,17 +380,35 @@ void Endpoint::registerMessageHandler(Protocol::ObjectAddress objectAddress, QOb
     Q_ASSERT(m_addressMap.contains(objectAddress));
     ObjectInfo *obj = m_addressMap.value(objectAddress);
     Q_ASSERT(obj);
-    Q_ASSERT(!obj->receiver);
-#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-    Q_ASSERT(!obj->messageHandler.isValid());
-#endif
-    obj->receiver = receiver;
 
     QByteArray signature(messageHandlerName);
     signature += "(GammaRay::Message)";
     auto idx = receiver->metaObject()->indexOfMethod(signature);
     Q_ASSERT(idx >= 0);
+    setMessageHandlerReceiver(obj, receiver);
     obj->messageHandler = receiver->metaObject()->method(idx);
+}
+
+void Endpoint::registerMessageHandler(Protocol::ObjectAddress objectAddress, QObject *receiver,
+                                      MessageHandlerCallback callback)
+{
+    Q_ASSERT(m_addressMap.contains(objectAddress));
+    ObjectInfo *obj = m_addressMap.value(objectAddress);
+    Q_ASSERT(obj);
+    Q_ASSERT(callback);
+
+    setMessageHandlerReceiver(obj, receiver);
+    obj->messageHandlerCallback = callback;
+}
+
+void Endpoint::setMessageHandlerReceiver(ObjectInfo *obj, QObject *receiver)
+{
+    Q_ASSERT(!obj->receiver);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    Q_ASSERT(!obj->messageHandler.isValid());
+#endif
+    Q_ASSERT(!obj->messageHandlerCallback);
+    obj->receiver = receiver;
 
     Q_ASSERT(!m_handlerMap.contains(receiver, obj));
     m_handlerMap.insert(receiver, obj);
@@ -264,6 +427,7 @@ void Endpoint::unregisterMessageHandler(Protocol::ObjectAddress objectAddress)
     m_handlerMap.remove(obj->receiver, obj);
     obj->receiver = 0;
     obj->messageHandler = QMetaMethod();
+    obj->messageHandlerCallback = 0;
 }
 
 void Endpoint::objectDestroyed(QObject *obj)
@@ -289,37 +453,74 @@ void Endpoint::handlerDestroyed(QObject *obj)
     foreach (ObjectInfo *obj, objs) {
         obj->receiver = 0;
         obj->messageHandler = QMetaMethod();
+        obj->messageHandlerCallback = 0;
         handlerDestroyed(obj->address, QString(obj->name)); // copy the name, in case unregisterMessageHandlerInternal() is called inside
     }
 }
 
 void Endpoint::dispatchMessage(const Message &msg)
 {
-    const QHash<Protocol::ObjectAddress, ObjectInfo *>::const_iterator it = m_addressMap.constFind(
-        msg.address());
-    if (it == m_addressMap.constEnd()) {
+    ObjectInfo *obj = msg.address() < m_addressTable.size() ? m_addressTable.at(msg.address()) : 0;
+    if (!obj) {
         cerr << "message for unknown object address received: " << quint64(msg.address()) << endl;
         return;
     }
 
-    ObjectInfo *obj = it.value();
-    if (msg.type() == Protocol::MethodCall) {
+    if (msg.type() == Protocol::MethodIdDefinition) {
+        quint16 methodId;
         QByteArray method;
-        msg >> method;
-        if (obj->object) {
-            Q_ASSERT(!method.isEmpty());
-            QVariantList args;
-            msg >> args;
+        msg >> methodId >> method;
+        Q_ASSERT(!method.isEmpty());
+        if (obj->remoteMethods.size() <= methodId)
+            obj->remoteMethods.resize(methodId + 1);
+        obj->remoteMethods[methodId] = RemoteMethod();
+        obj->remoteMethods[methodId].name = method;
+        return;
+    }
 
-            invokeObjectLocal(obj->object, method.constData(), args);
+    if (msg.type() == Protocol::MethodCall) {
+        quint16 methodId;
+        quint8 argCount;
+        msg >> methodId >> argCount;
+        const bool knownMethod = methodId < obj->remoteMethods.size();
+        Q_ASSERT(knownMethod);
+        if (obj->object && knownMethod) {
+            QVariantList args;
+            QVector<int> argumentTypes;
+            args.reserve(argCount);
+            argumentTypes.reserve(argCount);
+            for (quint8 i = 0; i < argCount; ++i) {
+                QVariant arg;
+                msg >> arg;
+                args.push_back(arg);
+                argumentTypes.push_back(argumentType(arg));
+            }
+
+            RemoteMethod &remoteMethod = obj->remoteMethods[methodId];
+            const QMetaObject *mo = obj->object->metaObject();
+            if (remoteMethod.metaObject != mo || remoteMethod.argumentTypes != argumentTypes) {
+                remoteMethod.method = lookupMethod(mo, remoteMethod.name, args);
+                remoteMethod.metaObject = mo;
+                remoteMethod.argumentTypes = argumentTypes;
+            }
+            if (remoteMethod.method.methodIndex() >= 0) {
+                invokeMethodLocal(obj->object, remoteMethod.method, args);
+            } else {
+                cerr << "cannot call unknown method " << remoteMethod.name.constData()
+                     << " on object of name " << qPrintable(obj->name) << endl;
+            }
         } else {
-            cerr << "cannot call method " << method.constData() << " on unknown object of name "
+            cerr << "cannot call method "
+                 << (knownMethod ? obj->remoteMethods.at(methodId).name.constData() : "<unknown>")
+                 << " on unknown object of name "
                  << qPrintable(obj->name) << " with address " << quint64(obj->address)
                  << " - did you forget to register it?" << endl;
         }
     }
 
-    if (obj->receiver)
+    if (obj->messageHandlerCallback)
+        obj->messageHandlerCallback(obj->receiver, msg);
+    else if (obj->receiver)
         obj->messageHandler.invoke(obj->receiver, Q_ARG(GammaRay::Message, msg));
 
     if (!obj->receiver && (msg.type() != Protocol::MethodCall || !obj->object)) {
@@ -344,6 +545,9 @@ void Endpoint::insertObjectInfo(Endpoint::ObjectInfo *oi)
 {
     Q_ASSERT(!m_addressMap.contains(oi->address));
     m_addressMap.insert(oi->address, oi);
+    if (m_addressTable.size() <= oi->address)
+        m_addressTable.resize(oi->address + 1);
+    m_addressTable[oi->address] = oi;
     Q_ASSERT(!m_nameMap.contains(oi->name));
     m_nameMap.insert(oi->name, oi);
 
@@ -358,6 +562,7 @@ void Endpoint::removeObjectInfo(Endpoint::ObjectInfo *oi)
 {
     Q_ASSERT(m_addressMap.contains(oi->address));
     m_addressMap.remove(oi->address);
+    m_addressTable[oi->address] = 0;
     Q_ASSERT(m_nameMap.contains(oi->name));
     m_nameMap.remove(oi->name);
 
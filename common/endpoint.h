@@ -55,6 +55,9 @@ class GAMMARAY_COMMON_EXPORT Endpoint : public QObject
 {
     Q_OBJECT
 public:
+    /** Type-erased message handler, see the typed registerMessageHandler() overload. */
+    typedef void (*MessageHandlerCallback)(QObject *receiver, const GammaRay::Message &msg);
+
     ~Endpoint();
 
     /** Send @p msg to the connected endpoint. */
@@ -133,6 +136,22 @@ public:
     virtual void registerMessageHandler(Protocol::ObjectAddress objectAddress, QObject *receiver,
                                         const char *messageHandlerName);
 
+    /** Register @p callback as the handler for messages to/from @p objectAddress.
+     *  @p callback is invoked directly with @p receiver, bypassing the meta object system.
+     *  Prefer the typed overload taking a member function below.
+     */
+    virtual void registerMessageHandler(Protocol::ObjectAddress objectAddress, QObject *receiver,
+                                        MessageHandlerCallback callback);
+
+    /** Register member function @p Handler of @p receiver as the handler for messages to/from @p objectAddress.
+     *  Example: @code registerMessageHandler<MyClass, &MyClass::newMessage>(address, this); @endcode
+     */
+    template<typename T, void (T::*Handler)(const GammaRay::Message &)>
+    void registerMessageHandler(Protocol::ObjectAddress objectAddress, T *receiver)
+    {
+        registerMessageHandler(objectAddress, receiver, &invokeMessageHandler<T, Handler>);
+    }
+
     /** Unregister the message handler for @p objectAddress. */
     virtual void unregisterMessageHandler(Protocol::ObjectAddress objectAddress);
 
@@ -196,6 +215,22 @@ protected:
      */
     void invokeObjectLocal(QObject *object, const char *method, const QVariantList &args) const;
 
+    /**
+     * Forward the call of @p method with @p args to the object called @p objectName on the remote side.
+     *
+     * Method names are interned per object, after the first call only the method id is transmitted.
+     */
+    void invokeObjectRemote(const QString &objectName, const QByteArray &method,
+                            const QVariantList &args) const;
+
+    /**
+     * Returns the address of the object called @p objectName and the interned id of @p method on it
+     * in @p methodId, announcing the id to the remote side first if necessary.
+     * Use this to build MethodCall messages directly, returns @c Protocol::InvalidObjectAddress on failure.
+     */
+    Protocol::ObjectAddress remoteMethodId(const QString &objectName, const QByteArray &method,
+                                           quint16 *methodId) const;
+
     PropertySyncer *m_propertySyncer;
 
 private slots:
@@ -205,12 +240,35 @@ private slots:
     void objectDestroyed(QObject *obj);
 
 private:
+    template<typename T, void (T::*Handler)(const GammaRay::Message &)>
+    static void invokeMessageHandler(QObject *receiver, const GammaRay::Message &msg)
+    {
+        (static_cast<T *>(receiver)->*Handler)(msg);
+    }
+
+    /** A method id assigned by the remote side, and the local method it resolves to. */
+    struct RemoteMethod
+    {
+        RemoteMethod()
+            : metaObject(0)
+        {
+        }
+
+        QByteArray name;
+        // meta object and argument types the method has been resolved against,
+        // the name alone does not identify an overload
+        const QMetaObject *metaObject;
+        QVector<int> argumentTypes;
+        QMetaMethod method;
+    };
+
     struct ObjectInfo
     {
         ObjectInfo()
             : address(Protocol::InvalidObjectAddress)
             , object(0)
             , receiver(0)
+            , messageHandlerCallback(0)
         {
         }
 
@@ -222,17 +280,39 @@ private:
         // custom message handling support
         QObject *receiver;
         QMetaMethod messageHandler;
+        MessageHandlerCallback messageHandlerCallback;
+
+        // method ids for outgoing calls, assigned by us
+        QHash<QByteArray, quint16> methodIds;
+        // method ids for incoming calls, indexed by the id the remote side assigned
+        QVector<RemoteMethod> remoteMethods;
     };
 
+    /** Sets @p receiver as message handler of @p obj, either messageHandler or messageHandlerCallback need to be set as well. */
+    void setMessageHandlerReceiver(ObjectInfo *obj, QObject *receiver);
+
     /** Inserts @p oi into all maps. */
     void insertObjectInfo(ObjectInfo *oi);
     /** Removes @p oi from all maps and destroys it. */
     void removeObjectInfo(ObjectInfo *oi);
 
+    /** Finds the best match for calling @p method on @p mo with @p args. */
+    QMetaMethod lookupMethod(const QMetaObject *mo, const QByteArray &method,
+                             const QVariantList &args) const;
+    /** Invokes @p method on @p object, converting @p args as needed. */
+    void invokeMethodLocal(QObject *object, const QMetaMethod &method,
+                           const QVariantList &args) const;
+    /** Forget all method ids, they are only valid for a single connection. */
+    void clearMethodIds();
+
     QHash<QString, ObjectInfo *> m_nameMap;
     QHash<Protocol::ObjectAddress, ObjectInfo *> m_addressMap;
+    // same content as m_addressMap, as a flat table for message dispatching
+    QVector<ObjectInfo *> m_addressTable;
     QHash<QObject *, ObjectInfo *> m_objectMap;
     QMultiHash<QObject *, ObjectInfo *> m_handlerMap;
+    // method name to candidate method indexes, per meta object
+    mutable QHash<QPair<const QMetaObject *, QByteArray>, QVector<int> > m_methodCache;
 
     QPointer<QIODevice> m_socket;
     Protocol::ObjectAddress m_myAddress;
@@ -0,0 +1,196 @@
+/*
+  pluginindex.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  acuordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config-gammaray.h>
+#include "pluginindex.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QLocale>
+#include <QStringList>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <QStandardPaths>
+#endif
+
+using namespace GammaRay;
+
+namespace {
+struct IndexEntry
+{
+    IndexEntry()
+        : size(-1)
+        , lastModified(-1)
+    {
+    }
+
+    qint64 size;
+    qint64 lastModified;
+    PluginInfo info;
+};
+
+// file name -> entry
+typedef QHash<QString, IndexEntry> DirectoryIndex;
+// directory -> index
+typedef QHash<QString, DirectoryIndex> IndexCache;
+
+const quint32 IndexMagic = 0x47524149; // "GRAI"
+const qint32 IndexVersion = 1;
+}
+
+// indexes already loaded in this process, by directory
+Q_GLOBAL_STATIC(IndexCache, s_indexes)
+
+static QString indexFilePath(const QString &dirPath)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+#else
+    const QString cacheDir = QDir::homePath() + QLatin1String("/.cache");
+#endif
+    if (cacheDir.isEmpty())
+        return QString();
+    const QByteArray key = QCryptographicHash::hash(dirPath.toUtf8(), QCryptographicHash::Md5).toHex();
+    return cacheDir + QLatin1String("/gammaray/plugin-index-") + QLatin1String(GAMMARAY_PROBE_ABI)
+           + QLatin1Char('-') + QString::fromLatin1(key);
+}
+
+/** Plugin names are localized, so the index is only valid for the locale it was created with. */
+static QString localeKey()
+{
+    return QLocale().uiLanguages().join(QStringLiteral(",")) + QLatin1Char(';')
+           + qApp->property("qtc_locale").toString();
+}
+
+static DirectoryIndex loadIndex(const QString &dirPath)
+{
+    DirectoryIndex index;
+    const QString path = indexFilePath(dirPath);
+    if (path.isEmpty())
+        return index;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return index;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    quint32 magic;
+    qint32 version;
+    QString locale;
+    quint32 count;
+    stream >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion)
+        return index;
+    stream >> locale >> count;
+    if (locale != localeKey() || stream.status() != QDataStream::Ok)
+        return index;
+
+    // no reserve() based on count, a corrupt index could make us allocate arbitrary amounts of memory
+    for (quint32 i = 0; i < count; ++i) {
+        QString fileName;
+        IndexEntry entry;
+        stream >> fileName >> entry.size >> entry.lastModified >> entry.info;
+        if (stream.status() != QDataStream::Ok)
+            return DirectoryIndex();
+        index.insert(fileName, entry);
+    }
+    return index;
+}
+
+static void saveIndex(const QString &dirPath, const DirectoryIndex &index)
+{
+    const QString path = indexFilePath(dirPath);
+    if (path.isEmpty())
+        return;
+    const QFileInfo fi(path);
+    if (!QDir().mkpath(fi.absolutePath()))
+        return;
+
+    // write to a temporary file first, so concurrently starting probes never see a partial index
+    QFile file(path + QLatin1String(".") + QString::number(QCoreApplication::applicationPid()));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream << IndexMagic << IndexVersion << localeKey() << quint32(index.size());
+    for (DirectoryIndex::const_iterator it = index.constBegin(); it != index.constEnd(); ++it)
+        stream << it.key() << it.value().size << it.value().lastModified << it.value().info;
+    file.close();
+
+    if (stream.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        file.remove();
+        return;
+    }
+    QFile::remove(path);
+    if (!file.rename(path))
+        file.remove();
+}
+
+QVector<PluginInfo> PluginIndex::pluginInfos(const QDir &dir, const QStringList &filter)
+{
+    const QString dirPath = dir.absolutePath();
+    IndexCache::iterator indexIt = s_indexes()->find(dirPath);
+    if (indexIt == s_indexes()->end())
+        indexIt = s_indexes()->insert(dirPath, loadIndex(dirPath));
+    DirectoryIndex &index = indexIt.value();
+
+    QVector<PluginInfo> infos;
+    DirectoryIndex updatedIndex;
+    bool changed = false;
+    foreach (const QFileInfo &fi, dir.entryInfoList(filter, QDir::Files)) {
+        const qint64 lastModified = fi.lastModified().toMSecsSinceEpoch();
+        IndexEntry entry = index.value(fi.fileName());
+        if (entry.size != fi.size() || entry.lastModified != lastModified) {
+            entry.size = fi.size();
+            entry.lastModified = lastModified;
+            entry.info = PluginInfo(fi.absoluteFilePath());
+            changed = true;
+        }
+        updatedIndex.insert(fi.fileName(), entry);
+        infos.push_back(entry.info);
+    }
+
+    // also catches removed plugins
+    if (changed || updatedIndex.size() != index.size()) {
+        index = updatedIndex;
+        saveIndex(dirPath, index);
+    }
+    return infos;
+}
+
+void PluginIndex::clearCache()
+{
+    s_indexes()->clear();
+}
@@ -0,0 +1,58 @@
+/*
+  pluginindex.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  acuordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_PLUGININDEX_H
+#define GAMMARAY_PLUGININDEX_H
+
+#include "plugininfo.h"
+
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QDir;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** @brief Persistent cache of plugin meta data.
+ *
+ *  Reading plugin meta data requires opening every plugin library or desktop file,
+ *  which is slow on some targets. The index stores the meta data per plugin directory,
+ *  validated by file size and modification time, in the user's cache directory.
+ */
+namespace PluginIndex {
+/** Returns the plugin meta data for all files in @p dir matching @p filter.
+ *  Unchanged plugins are served from the index, new or changed ones are read
+ *  and the index is updated accordingly.
+ */
+QVector<PluginInfo> pluginInfos(const QDir &dir, const QStringList &filter);
+
+/// internal, drops the indexes already loaded by this process, for unit tests
+void clearCache();
+}
+}
+
+#endif // GAMMARAY_PLUGININDEX_H
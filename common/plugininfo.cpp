@@ -36,6 +36,7 @@
 #include <QLocale>
 #include <QSettings>
 #include <QCoreApplication>
+#include <QDataStream>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include <QJsonArray>
@@ -257,3 +258,20 @@ void PluginInfo::initFromDesktopFile(const QString &path)
         }
     }
 }
+
+namespace GammaRay {
+QDataStream &operator<<(QDataStream &out, const PluginInfo &info)
+{
+    Q_ASSERT(!info.isStatic());
+    out << info.m_path << info.m_id << info.m_interface << info.m_supportedTypes << info.m_name
+        << info.m_selectableTypes << info.m_remoteSupport << info.m_hidden;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, PluginInfo &info)
+{
+    in >> info.m_path >> info.m_id >> info.m_interface >> info.m_supportedTypes >> info.m_name
+    >> info.m_selectableTypes >> info.m_remoteSupport >> info.m_hidden;
+    return in;
+}
+}
@@ -35,6 +35,7 @@
 #include <qplugin.h>
 
 QT_BEGIN_NAMESPACE
+class QDataStream;
 class QJsonObject;
 QT_END_NAMESPACE
 
@@ -66,6 +67,10 @@ public:
     QObject* staticInstance() const;
 
 private:
+    // for the plugin index, static plugins are not serialized
+    friend QDataStream &operator<<(QDataStream &out, const PluginInfo &info);
+    friend QDataStream &operator>>(QDataStream &in, PluginInfo &info);
+
     void init();
     void initFromJSON(const QString &path);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
@@ -28,6 +28,7 @@
 
 #include <config-gammaray.h>
 #include "pluginmanager.h"
+#include "pluginindex.h"
 #include "paths.h"
 
 #include <QCoreApplication>
@@ -106,16 +107,13 @@ void PluginManagerBase::scan(const QString &serviceType)
     foreach (const QString &pluginPath, pluginPaths()) {
         const QDir dir(pluginPath);
         IF_DEBUG(cout << "checking plugin path: " << qPrintable(dir.absolutePath()) << endl);
-        foreach (const QString &plugin, dir.entryList(pluginFilter(), QDir::Files)) {
-            const QString pluginFile = dir.absoluteFilePath(plugin);
-            const PluginInfo pluginInfo(pluginFile);
-
+        foreach (const PluginInfo &pluginInfo, PluginIndex::pluginInfos(dir, pluginFilter())) {
             if (!pluginInfo.isValid() || loadedPluginNames.contains(pluginInfo.id()))
                 continue;
 
             if (pluginInfo.interfaceId() != serviceType) {
                 IF_DEBUG(
-                    qDebug() << Q_FUNC_INFO << "skipping" << pluginFile << "not supporting service type" << serviceType << "service types are: " << pluginInfo.interfaceId();
+                    qDebug() << Q_FUNC_INFO << "skipping" << pluginInfo.path() << "not supporting service type" << serviceType << "service types are: " << pluginInfo.interfaceId();
                     )
                 continue;
             }
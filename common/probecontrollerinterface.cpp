@@ -32,9 +32,37 @@ using namespace GammaRay;
 
 ProbeControllerInterface::ProbeControllerInterface(QObject *parent)
     : QObject(parent)
+    , m_objectDiscoveryActive(false)
+    , m_discoveredObjectCount(0)
 {
 }
 
 ProbeControllerInterface::~ProbeControllerInterface()
 {
 }
+
+bool ProbeControllerInterface::objectDiscoveryActive() const
+{
+    return m_objectDiscoveryActive;
+}
+
+void ProbeControllerInterface::setObjectDiscoveryActive(bool active)
+{
+    if (m_objectDiscoveryActive == active)
+        return;
+    m_objectDiscoveryActive = active;
+    emit objectDiscoveryActiveChanged(active);
+}
+
+int ProbeControllerInterface::discoveredObjectCount() const
+{
+    return m_discoveredObjectCount;
+}
+
+void ProbeControllerInterface::setDiscoveredObjectCount(int count)
+{
+    if (m_discoveredObjectCount == count)
+        return;
+    m_discoveredObjectCount = count;
+    emit discoveredObjectCountChanged(count);
+}
@@ -40,19 +40,38 @@ namespace GammaRay {
 class ProbeControllerInterface : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(
+        bool objectDiscoveryActive READ objectDiscoveryActive WRITE setObjectDiscoveryActive NOTIFY objectDiscoveryActiveChanged)
+    Q_PROPERTY(
+        int discoveredObjectCount READ discoveredObjectCount WRITE setDiscoveredObjectCount NOTIFY discoveredObjectCountChanged)
 
 public:
     explicit ProbeControllerInterface(QObject *parent = nullptr);
     virtual ~ProbeControllerInterface();
 
+    /** @c true while objects that existed before the probe was attached are still being searched. */
+    bool objectDiscoveryActive() const;
+    void setObjectDiscoveryActive(bool active);
+
+    /** Number of pre-existing objects found so far. */
+    int discoveredObjectCount() const;
+    void setDiscoveredObjectCount(int count);
+
     /** Terminate host application. */
     virtual void quitHost() = 0;
 
     /** Detach GammaRay but keep host application running. */
     virtual void detachProbe() = 0;
 
+signals:
+    void objectDiscoveryActiveChanged(bool active);
+    void discoveredObjectCountChanged(int count);
+
 private:
     Q_DISABLE_COPY(ProbeControllerInterface)
+
+    bool m_objectDiscoveryActive;
+    int m_discoveredObjectCount;
 };
 }
 
@@ -0,0 +1,137 @@
+/*
+  probesettingsfile.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "probesettingsfile.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#ifdef Q_OS_WIN
+#include <QFileInfo>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+using namespace GammaRay;
+
+#ifndef Q_OS_WIN
+// regular file or directory owned by us, and not accessible to anyone else
+static bool isPrivate(const struct stat &st, mode_t type)
+{
+    return (st.st_mode & S_IFMT) == type && st.st_uid == geteuid()
+           && (st.st_mode & (S_IRWXG | S_IRWXO)) == 0;
+}
+#endif
+
+QString ProbeSettingsFile::path(qint64 launcherId)
+{
+    const QString fileName = QStringLiteral("gammaray-%1.settings").arg(launcherId);
+#ifdef Q_OS_WIN
+    // the temporary directory is inside the user profile
+    return QDir::temp().absoluteFilePath(fileName);
+#else
+    const QString dirName = QDir::temp().absoluteFilePath(
+        QStringLiteral("gammaray-%1").arg(geteuid()));
+    const QByteArray dir = QFile::encodeName(dirName);
+    if (mkdir(dir.constData(), S_IRWXU) != 0 && errno != EEXIST)
+        return QString();
+
+    // the name is predictable, so make sure nobody else created it (lstat, symlinks are rejected)
+    struct stat st;
+    if (lstat(dir.constData(), &st) != 0 || !isPrivate(st, S_IFDIR)) {
+        qWarning() << "Not using" << dirName << "for probe settings, it is not a private directory.";
+        return QString();
+    }
+    return dirName + QLatin1Char('/') + fileName;
+#endif
+}
+
+bool ProbeSettingsFile::write(const QString &path, const QByteArray &data)
+{
+#ifdef Q_OS_WIN
+    if (QFileInfo(path).exists())
+        return false;
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly))
+        return false;
+    file.setPermissions(QFile::ReadOwner | QFile::WriteOwner);
+    return file.write(data) == data.size();
+#else
+    const int fd = open(QFile::encodeName(path).constData(),
+                        O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+        return false;
+
+    qint64 written = 0;
+    while (written < data.size()) {
+        const ssize_t n = ::write(fd, data.constData() + written, data.size() - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        written += n;
+    }
+    close(fd);
+    return written == data.size();
+#endif
+}
+
+bool ProbeSettingsFile::read(const QString &path, QByteArray *data)
+{
+#ifdef Q_OS_WIN
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    *data = file.readAll();
+    return true;
+#else
+    const int fd = open(QFile::encodeName(path).constData(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !isPrivate(st, S_IFREG)) {
+        qWarning() << "Ignoring probe settings file" << path
+                   << "not owned by the current user, or accessible by others.";
+        close(fd);
+        return false;
+    }
+
+    QFile file;
+    if (!file.open(fd, QFile::ReadOnly, QFile::AutoCloseHandle)) {
+        close(fd);
+        return false;
+    }
+    *data = file.readAll();
+    return true;
+#endif
+}
@@ -0,0 +1,58 @@
+/*
+  probesettingsfile.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_PROBESETTINGSFILE_H
+#define GAMMARAY_PROBESETTINGSFILE_H
+
+#include "gammaray_common_export.h"
+
+#include <QByteArray>
+#include <QString>
+
+namespace GammaRay {
+/** @brief Hand-over of probe settings from the launcher to the probe via a file.
+ *
+ *  The file lives in a directory only the current user can access, is created
+ *  exclusively by the launcher and only read by the probe when it is owned by the
+ *  current user and not accessible to anyone else. On Windows, the per-user
+ *  temporary directory is relied upon for this.
+ */
+namespace ProbeSettingsFile {
+/** Path of the settings file for the launcher with id @p launcherId.
+ *  Returns an empty string if no private directory for it is available.
+ */
+GAMMARAY_COMMON_EXPORT QString path(qint64 launcherId);
+
+/** Create the file at @p path, which must not exist yet, with @p data as content. */
+GAMMARAY_COMMON_EXPORT bool write(const QString &path, const QByteArray &data);
+
+/** Read the content of the file at @p path, if it passes the ownership and permission checks. */
+GAMMARAY_COMMON_EXPORT bool read(const QString &path, QByteArray *data);
+}
+}
+
+#endif // GAMMARAY_PROBESETTINGSFILE_H
@@ -34,6 +34,7 @@ using namespace GammaRay;
 PropertyControllerInterface::PropertyControllerInterface(const QString &name, QObject *parent)
     : QObject(parent)
     , m_name(name)
+    , m_maximumUpdateRate(0)
 {
     ObjectBroker::registerObject(name, this);
 }
@@ -59,3 +60,17 @@ void PropertyControllerInterface::setAvailableExtensions(const QStringList &avai
     m_availableExtensions = availableExtensions;
     emit availableExtensionsChanged();
 }
+
+int PropertyControllerInterface::maximumUpdateRate() const
+{
+    return m_maximumUpdateRate;
+}
+
+void PropertyControllerInterface::setMaximumUpdateRate(int rate)
+{
+    rate = qMax(0, rate);
+    if (m_maximumUpdateRate == rate)
+        return;
+    m_maximumUpdateRate = rate;
+    emit maximumUpdateRateChanged(rate);
+}
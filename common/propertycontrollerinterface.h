@@ -48,12 +48,23 @@ public:
     QStringList availableExtensions() const;
     void setAvailableExtensions(const QStringList &availableExtensions);
 
+    /** Maximum number of property change notifications per second and property
+     *  the client wants to receive, 0 (the default) means unlimited.
+     */
+    int maximumUpdateRate() const;
+
+public slots:
+    /** Called by the client to negotiate the update rate it can make use of. */
+    virtual void setMaximumUpdateRate(int rate);
+
 signals:
     void availableExtensionsChanged();
+    void maximumUpdateRateChanged(int rate);
 
 private:
     QString m_name;
     QStringList m_availableExtensions;
+    int m_maximumUpdateRate;
 };
 }
 
@@ -31,8 +31,9 @@
 
 #include <QDebug>
 #include <QMetaProperty>
+#include <QTimer>
 
-#include <algorithm>
+#include <limits>
 
 using namespace GammaRay;
 
@@ -43,13 +44,18 @@ static int qobjectPropertyOffset()
 
 PropertySyncer::PropertySyncer(QObject *parent)
     : QObject(parent)
+    , m_flushTimer(new QTimer(this))
     , m_address(Protocol::InvalidObjectAddress)
     , m_initialSync(false)
 {
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(0);
+    connect(m_flushTimer, SIGNAL(timeout()), this, SLOT(flushChanges()));
 }
 
 PropertySyncer::~PropertySyncer()
 {
+    qDeleteAll(m_objects);
 }
 
 void PropertySyncer::setRequestInitialSync(bool initialSync)
@@ -61,45 +67,74 @@ void PropertySyncer::addObject(Protocol::ObjectAddress addr, QObject *obj)
 {
     Q_ASSERT(addr != Protocol::InvalidObjectAddress);
     Q_ASSERT(obj);
-    if (qobjectPropertyOffset() == obj->metaObject()->propertyCount())
-        return; // no properties we could sync
 
-    for (int i = qobjectPropertyOffset(); i < obj->metaObject()->propertyCount(); ++i) {
-        const auto prop = obj->metaObject()->property(i);
+    // re-registration, the monitoring state belongs to the address and carries over
+    const auto oldAddrIt = m_objectAddresses.constFind(obj);
+    if (oldAddrIt != m_objectAddresses.constEnd() && oldAddrIt.value() != addr)
+        removeObject(oldAddrIt.value());
+    const bool wasEnabled = removeObject(addr);
+
+    const auto mo = obj->metaObject();
+    if (qobjectPropertyOffset() == mo->propertyCount())
+        return; // no properties we could sync
+    Q_ASSERT(mo->propertyCount() - qobjectPropertyOffset() <= std::numeric_limits<quint16>::max());
+
+    ObjectInfo *info = new ObjectInfo;
+    info->addr = addr;
+    info->obj = obj;
+    info->recursionLock = false;
+    info->enabled = false;
+    info->remoteLayoutKnown = false;
+    info->dirtyProperties.resize(mo->propertyCount() - qobjectPropertyOffset());
+
+    for (int i = qobjectPropertyOffset(); i < mo->propertyCount(); ++i) {
+        const auto prop = mo->property(i);
         if (!prop.hasNotifySignal())
             continue;
-        connect(obj, QByteArray("2") +
+        auto &props = info->notifyMap[prop.notifySignalIndex()];
+        if (props.isEmpty()) {
+            connect(obj, QByteArray("2") +
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-                prop.notifySignal().signature()
+                    prop.notifySignal().signature()
 #else
-                prop.notifySignal().methodSignature()
+                    prop.notifySignal().methodSignature()
 #endif
-                , this, SLOT(propertyChanged()));
+                    , this, SLOT(propertyChanged()));
+        }
+        props.push_back(i - qobjectPropertyOffset());
     }
 
     connect(obj, SIGNAL(destroyed(QObject*)), this, SLOT(objectDestroyed(QObject*)));
 
-    ObjectInfo info;
-    info.addr = addr;
-    info.obj = obj;
-    info.recursionLock = false;
-    info.enabled = false;
-    m_objects.push_back(info);
+    m_objects.insert(addr, info);
+    m_objectAddresses.insert(obj, addr);
+    setObjectEnabled(addr, wasEnabled);
+}
+
+bool PropertySyncer::removeObject(Protocol::ObjectAddress addr)
+{
+    ObjectInfo *info = m_objects.take(addr);
+    if (!info)
+        return false;
+    disconnect(info->obj, Q_NULLPTR, this, Q_NULLPTR);
+    m_objectAddresses.remove(info->obj);
+    const bool enabled = info->enabled;
+    delete info;
+    return enabled;
 }
 
 void PropertySyncer::setObjectEnabled(Protocol::ObjectAddress addr, bool enabled)
 {
-    const auto it = std::find_if(m_objects.begin(), m_objects.end(), [addr](
-                                     const ObjectInfo &info) {
-        return info.addr == addr;
-    });
-    if (it == m_objects.end() || (*it).enabled == enabled)
+    ObjectInfo *info = m_objects.value(addr);
+    if (!info || info->enabled == enabled)
         return;
 
-    (*it).enabled = enabled;
+    info->enabled = enabled;
+    if (!enabled)
+        info->dirtyProperties.fill(false);
     if (enabled && m_initialSync) {
         Message msg(m_address, Protocol::PropertySyncRequest);
-        msg << addr;
+        msg << addr << propertyNames(info);
         emit message(msg);
     }
 }
@@ -121,60 +156,64 @@ void PropertySyncer::handleMessage(const GammaRay::Message &msg)
     case Protocol::PropertySyncRequest:
     {
         Protocol::ObjectAddress addr;
-        msg >> addr;
+        QVector<QByteArray> remoteNames;
+        msg >> addr >> remoteNames;
         Q_ASSERT(addr != Protocol::InvalidObjectAddress);
 
-        const auto it
-            = std::find_if(m_objects.constBegin(), m_objects.constEnd(),
-                           [addr](const ObjectInfo &info) {
-                return info.addr == addr;
-            });
-        if (it == m_objects.constEnd())
+        ObjectInfo *info = m_objects.value(addr);
+        if (!info)
             break;
+        setRemotePropertyNames(info, remoteNames);
 
-        QVector<QPair<QByteArray, QVariant> > values;
-        const auto propCount = (*it).obj->metaObject()->propertyCount();
-        values.reserve(propCount);
-        for (int i = qobjectPropertyOffset(); i < propCount; ++i) {
-            const auto prop = (*it).obj->metaObject()->property(i);
-            values.push_back(qMakePair(QByteArray(prop.name()), prop.read((*it).obj)));
-        }
-        Q_ASSERT(!values.isEmpty());
+        // send everything, this also replaces any pending changes
+        info->dirtyProperties.fill(false);
+        QBitArray allProperties(info->dirtyProperties.size(), true);
 
         Message msg(m_address, Protocol::PropertyValuesChanged);
-        msg << addr << (quint32)values.size();
-        foreach (const auto &value, values)
-            msg << value.first << value.second;
+        msg << addr << propertyNames(info);
+        writeValues(msg, info, allProperties);
         emit message(msg);
         break;
     }
     case Protocol::PropertyValuesChanged:
     {
         Protocol::ObjectAddress addr;
-        quint32 changeSize;
-        msg >> addr >> changeSize;
+        QVector<QByteArray> remoteNames;
+        quint16 changeSize;
+        msg >> addr >> remoteNames >> changeSize;
         Q_ASSERT(addr != Protocol::InvalidObjectAddress);
         Q_ASSERT(changeSize > 0);
 
-        auto it = std::find_if(m_objects.begin(), m_objects.end(), [addr](const ObjectInfo &info) {
-                return info.addr == addr;
-            });
-        if (it == m_objects.end())
+        ObjectInfo *info = m_objects.value(addr);
+        if (!info)
+            break;
+        if (!remoteNames.isEmpty())
+            setRemotePropertyNames(info, remoteNames);
+        // we can't interpret property indexes before knowing the remote property names,
+        // the initial sync will provide the current values anyway
+        if (!info->remoteLayoutKnown)
             break;
 
-        for (quint32 i = 0; i < changeSize; ++i) {
-            QByteArray propName;
+        const auto mo = info->obj->metaObject();
+        for (quint16 i = 0; i < changeSize; ++i) {
+            quint16 remoteIndex;
             QVariant propValue;
-            msg >> propName >> propValue;
-            (*it).recursionLock = true;
-            (*it).obj->setProperty(propName, propValue);
-
-            // it can be invalid if as a result of the above call new objects have been registered for example
-            it = std::find_if(m_objects.begin(), m_objects.end(), [addr](const ObjectInfo &info) {
-                    return info.addr == addr;
-                });
-            Q_ASSERT(it != m_objects.end());
-            (*it).recursionLock = false;
+            msg >> remoteIndex >> propValue;
+
+            int index = remoteIndex;
+            if (!info->remoteProperties.isEmpty())
+                index = remoteIndex < info->remoteProperties.size() ? info->remoteProperties.at(remoteIndex) : -1;
+            if (index < 0 || index >= info->dirtyProperties.size())
+                continue;
+
+            info->recursionLock = true;
+            mo->property(index + qobjectPropertyOffset()).write(info->obj, propValue);
+
+            // the object might be gone if as a result of the above call objects have been destroyed for example
+            info = m_objects.value(addr);
+            if (!info)
+                break;
+            info->recursionLock = false;
         }
         break;
     }
@@ -188,37 +227,93 @@ void PropertySyncer::propertyChanged()
 {
     const auto *obj = sender();
     Q_ASSERT(obj);
-    const auto it
-        = std::find_if(m_objects.constBegin(), m_objects.constEnd(), [obj](const ObjectInfo &info) {
-        return info.obj == obj;
-    });
-    Q_ASSERT(it != m_objects.constEnd());
+    const auto addrIt = m_objectAddresses.constFind(const_cast<QObject *>(obj));
+    Q_ASSERT(addrIt != m_objectAddresses.constEnd());
+    ObjectInfo *info = m_objects.value(addrIt.value());
+    Q_ASSERT(info);
 
-    if ((*it).recursionLock || !(*it).enabled)
+    if (info->recursionLock || !info->enabled)
         return;
 
-    const auto sigIndex = senderSignalIndex();
-    QVector<QPair<QByteArray, QVariant> > changes;
-    for (int i = qobjectPropertyOffset(); i < obj->metaObject()->propertyCount(); ++i) {
-        const auto prop = obj->metaObject()->property(i);
-        if (prop.notifySignalIndex() != sigIndex)
+    const auto props = info->notifyMap.value(senderSignalIndex());
+    Q_ASSERT(!props.isEmpty());
+
+    const bool wasDirty = info->dirtyProperties.count(true) > 0;
+    foreach (int prop, props)
+        info->dirtyProperties.setBit(prop);
+    if (!wasDirty)
+        m_dirtyObjects.push_back(info->addr);
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start();
+}
+
+void PropertySyncer::flushChanges()
+{
+    const auto dirtyObjects = m_dirtyObjects;
+    m_dirtyObjects.clear();
+
+    foreach (Protocol::ObjectAddress addr, dirtyObjects) {
+        ObjectInfo *info = m_objects.value(addr);
+        if (!info || !info->enabled)
             continue;
-        changes.push_back(qMakePair(QByteArray(prop.name()), prop.read(obj)));
-    }
-    Q_ASSERT(!changes.isEmpty());
+        const QBitArray dirty = info->dirtyProperties;
+        if (dirty.count(true) == 0)
+            continue;
+        info->dirtyProperties.fill(false);
 
-    Message msg(m_address, Protocol::PropertyValuesChanged);
-    msg << (*it).addr << (quint32)changes.size();
-    foreach (const auto &change, changes)
-        msg << change.first << change.second;
-    emit message(msg);
+        Message msg(m_address, Protocol::PropertyValuesChanged);
+        msg << addr << QVector<QByteArray>();
+        writeValues(msg, info, dirty);
+        emit message(msg);
+    }
 }
 
 void PropertySyncer::objectDestroyed(QObject *obj)
 {
-    const auto it = std::find_if(m_objects.begin(), m_objects.end(), [obj](const ObjectInfo &info) {
-        return info.obj == obj;
-    });
-    Q_ASSERT(it != m_objects.end());
-    m_objects.erase(it);
+    const auto it = m_objectAddresses.find(obj);
+    Q_ASSERT(it != m_objectAddresses.end());
+    delete m_objects.take(it.value());
+    m_objectAddresses.erase(it);
+}
+
+void PropertySyncer::writeValues(Message &msg, const ObjectInfo *info,
+                                 const QBitArray &properties) const
+{
+    const auto mo = info->obj->metaObject();
+    msg << static_cast<quint16>(properties.count(true));
+    for (int i = 0; i < properties.size(); ++i) {
+        if (!properties.testBit(i))
+            continue;
+        const auto prop = mo->property(i + qobjectPropertyOffset());
+        msg << static_cast<quint16>(i) << prop.read(info->obj);
+    }
+}
+
+void PropertySyncer::setRemotePropertyNames(ObjectInfo *info,
+                                            const QVector<QByteArray> &names) const
+{
+    // property indexes only match if both sides have the same property layout,
+    // otherwise map them by name once
+    info->remoteLayoutKnown = true;
+    if (names == propertyNames(info)) {
+        info->remoteProperties.clear();
+        return;
+    }
+
+    const auto mo = info->obj->metaObject();
+    info->remoteProperties.resize(names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        const int index = mo->indexOfProperty(names.at(i));
+        info->remoteProperties[i] = index < qobjectPropertyOffset() ? -1 : index - qobjectPropertyOffset();
+    }
+}
+
+QVector<QByteArray> PropertySyncer::propertyNames(const ObjectInfo *info) const
+{
+    const auto mo = info->obj->metaObject();
+    QVector<QByteArray> names;
+    names.reserve(mo->propertyCount() - qobjectPropertyOffset());
+    for (int i = qobjectPropertyOffset(); i < mo->propertyCount(); ++i)
+        names.push_back(QByteArray(mo->property(i).name()));
+    return names;
 }
@@ -33,13 +33,22 @@
 
 #include <common/protocol.h>
 
+#include <QBitArray>
+#include <QHash>
 #include <QObject>
 #include <QVector>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 class Message;
 
-/** Infrastructure for syncing property values between a local and a remote object. */
+/** Infrastructure for syncing property values between a local and a remote object.
+ *  Property changes are collected and sent once per event loop pass, identifying
+ *  properties by their index.
+ */
 class GAMMARAY_COMMON_EXPORT PropertySyncer : public QObject
 {
     Q_OBJECT
@@ -47,7 +56,10 @@ public:
     explicit PropertySyncer(QObject *parent = 0);
     ~PropertySyncer();
 
-    /** Add an object that should be monitored for to be synced property changes. */
+    /** Add an object that should be monitored for to be synced property changes.
+     *  This replaces any object previously added for @p addr, as well as a previous
+     *  registration of @p obj under a different address.
+     */
     void addObject(Protocol::ObjectAddress addr, QObject *obj);
 
     /** Enable property syncing for the object with address @p addr.
@@ -76,6 +88,7 @@ signals:
 private slots:
     void propertyChanged();
     void objectDestroyed(QObject *obj);
+    void flushChanges();
 
 private:
     struct ObjectInfo {
@@ -83,8 +96,24 @@ private:
         QObject *obj;
         bool recursionLock;
         bool enabled;
+        // notify signal index -> property indexes
+        QHash<int, QVector<int> > notifyMap;
+        QBitArray dirtyProperties;
+        // remote property index -> local property index, empty if both sides match
+        QVector<int> remoteProperties;
+        bool remoteLayoutKnown;
     };
-    QVector<ObjectInfo> m_objects;
+
+    /** Stop monitoring the object added for @p addr, returns whether it was enabled. */
+    bool removeObject(Protocol::ObjectAddress addr);
+    void writeValues(Message &msg, const ObjectInfo *info, const QBitArray &properties) const;
+    void setRemotePropertyNames(ObjectInfo *info, const QVector<QByteArray> &names) const;
+    QVector<QByteArray> propertyNames(const ObjectInfo *info) const;
+
+    QHash<Protocol::ObjectAddress, ObjectInfo *> m_objects;
+    QHash<QObject *, Protocol::ObjectAddress> m_objectAddresses;
+    QVector<Protocol::ObjectAddress> m_dirtyObjects;
+    QTimer *m_flushTimer;
     Protocol::ObjectAddress m_address;
     bool m_initialSync;
 };
@@ -63,8 +63,10 @@ enum BuildInMessageType {
 
     // remote model messages
     // client -> server
+    // requests expecting a reply start with a request id, the reply starts with the same id
+    // followed by the server-side processing time in microseconds
     ModelRowColumnCountRequest,
-    ModelContentRequest,
+    ModelContentRequest, // list of (parent, row range, column range, roles, merge) blocks
     ModelHeaderRequest,
     ModelSetDataRequest,
     ModelSortRequest,
@@ -72,8 +74,8 @@ enum BuildInMessageType {
     SelectionModelStateRequest,
 
     // server -> client
-    ModelRowColumnCountReply,
-    ModelContentReply,
+    ModelRowColumnCountReply, // index, row count, column count, for the root index also the lazy roles
+    ModelContentReply, // new icons, removed icon ids, then the requested blocks in column-major order
     ModelContentChanged,
     ModelHeaderReply,
     ModelHeaderChanged,
@@ -90,9 +92,10 @@ enum BuildInMessageType {
     SelectionModelSelect,
     SelectionModelCurrent,
 
-    MethodCall,
-    PropertySyncRequest,
-    PropertyValuesChanged,
+    MethodIdDefinition, // method id, method name; sent once before the first MethodCall using that id
+    MethodCall, // method id, argument count, arguments
+    PropertySyncRequest, // object address, property names of the requesting side
+    PropertyValuesChanged, // object address, property names (initial sync only), list of (property index, value)
 
     ServerInfo,
 
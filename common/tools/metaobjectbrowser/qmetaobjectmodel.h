@@ -47,6 +47,8 @@ namespace QMetaObjectModel
         ObjectInclusiveCountColumn,
         ObjectSelfAliveCountColumn,
         ObjectInclusiveAliveCountColumn,
+        ObjectInclusiveCreationRateColumn,
+        ObjectInclusiveDestructionRateColumn,
         _Last
     };
 }
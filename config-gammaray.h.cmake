@@ -41,6 +41,7 @@
 
 #cmakedefine HAVE_STDINT_H
 #cmakedefine HAVE_BACKTRACE
+#cmakedefine HAVE_MALLOC_USABLE_SIZE
 #cmakedefine HAVE_CXA_DEMANGLE
 
 #cmakedefine HAVE_QT_WIDGETS
@@ -43,6 +43,9 @@
 
 #include <QDebug>
 #include <QMetaEnum>
+#include <QTimer>
+
+#include <algorithm>
 
 using namespace GammaRay;
 
@@ -50,8 +53,13 @@ AggregatedPropertyModel::AggregatedPropertyModel(QObject *parent)
     : QAbstractItemModel(parent)
     , m_rootAdaptor(0)
     , m_inhibitAdaptorCreation(false)
+    , m_updateTimer(new QTimer(this))
+    , m_maximumUpdateRate(0)
 {
     qRegisterMetaType<GammaRay::PropertyAdaptor *>();
+
+    m_updateTimer->setSingleShot(true);
+    connect(m_updateTimer, SIGNAL(timeout()), this, SLOT(flushPendingChanges()));
 }
 
 AggregatedPropertyModel::~AggregatedPropertyModel()
@@ -79,8 +87,27 @@ void AggregatedPropertyModel::setObject(const ObjectInstance &oi)
         endInsertRows();
 }
 
+int AggregatedPropertyModel::maximumUpdateRate() const
+{
+    return m_maximumUpdateRate;
+}
+
+void AggregatedPropertyModel::setMaximumUpdateRate(int rate)
+{
+    m_maximumUpdateRate = qMax(0, rate);
+    if (m_maximumUpdateRate == 0) {
+        m_updateTimer->stop();
+        flushPendingChanges();
+    } else {
+        m_updateTimer->setInterval(1000 / m_maximumUpdateRate);
+    }
+}
+
 void AggregatedPropertyModel::clear()
 {
+    m_updateTimer->stop();
+    m_pendingChanges.clear();
+
     if (!m_rootAdaptor)
         return;
 
@@ -339,6 +366,7 @@ void AggregatedPropertyModel::addPropertyAdaptor(PropertyAdaptor *adaptor) const
     connect(adaptor, SIGNAL(propertyChanged(int,int)), this, SLOT(propertyChanged(int,int)));
     connect(adaptor, SIGNAL(propertyAdded(int,int)), this, SLOT(propertyAdded(int,int)));
     connect(adaptor, SIGNAL(propertyRemoved(int,int)), this, SLOT(propertyRemoved(int,int)));
+    connect(adaptor, SIGNAL(destroyed(QObject*)), this, SLOT(adaptorDestroyed(QObject*)));
 }
 
 void AggregatedPropertyModel::propertyChanged(int first, int last)
@@ -350,11 +378,86 @@ void AggregatedPropertyModel::propertyChanged(int first, int last)
     Q_ASSERT(first >= 0);
     Q_ASSERT(last < adaptor->count());
 
+    if (m_maximumUpdateRate <= 0) {
+        emitPropertyChanged(adaptor, first, last);
+        return;
+    }
+
+    // deliver the first change right away, and only coalesce what follows within the update interval
+    if (!m_updateTimer->isActive()) {
+        emitPropertyChanged(adaptor, first, last);
+        m_updateTimer->start();
+        return;
+    }
+
+    // the values are read when the notification is sent, so recording the index is enough
+    // to only ever transfer the latest value per update interval
+    auto &pending = m_pendingChanges[adaptor];
+    for (int i = first; i <= last; ++i)
+        pending.push_back(i);
+}
+
+void AggregatedPropertyModel::emitPropertyChanged(PropertyAdaptor *adaptor, int first, int last)
+{
     emit dataChanged(createIndex(first, 0, adaptor), createIndex(last, columnCount() - 1, adaptor));
     for (int i = first; i <= last; ++i)
         reloadSubTree(adaptor, i);
 }
 
+void AggregatedPropertyModel::flushPendingChanges()
+{
+    const auto pendingChanges = m_pendingChanges;
+    m_pendingChanges.clear();
+
+    for (auto it = pendingChanges.constBegin(); it != pendingChanges.constEnd(); ++it) {
+        auto adaptor = it.key();
+        // previous iterations might have removed the adaptor
+        if (!m_parentChildrenMap.contains(adaptor))
+            continue;
+        const auto rowCount = m_parentChildrenMap.value(adaptor).size();
+
+        auto rows = it.value();
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        // merge into consecutive ranges, to minimize the number of notifications
+        for (int i = 0; i < rows.size(); ) {
+            const auto first = rows.at(i);
+            auto last = first;
+            while (++i < rows.size() && rows.at(i) == last + 1)
+                ++last;
+            if (last >= rowCount)
+                break;
+            if (!m_parentChildrenMap.contains(adaptor))
+                break;
+            emitPropertyChanged(adaptor, first, last);
+        }
+    }
+
+    // keep limiting the rate while changes keep coming in
+    if (!pendingChanges.isEmpty() && m_maximumUpdateRate > 0)
+        m_updateTimer->start();
+}
+
+void AggregatedPropertyModel::adaptorDestroyed(QObject *obj)
+{
+    // sub-tree adaptors are deleted along with their parent, so we can't rely on reloadSubTree here
+    m_pendingChanges.remove(static_cast<PropertyAdaptor *>(obj));
+}
+
+void AggregatedPropertyModel::invalidatePendingChanges(PropertyAdaptor *adaptor)
+{
+    // row indexes of pending changes are no longer reliable after structural changes,
+    // so refresh all rows of the adaptor instead
+    const auto it = m_pendingChanges.find(adaptor);
+    if (it == m_pendingChanges.end())
+        return;
+    const auto rowCount = m_parentChildrenMap.value(adaptor).size();
+    it.value().clear();
+    for (int i = 0; i < rowCount; ++i)
+        it.value().push_back(i);
+}
+
 void AggregatedPropertyModel::propertyAdded(int first, int last)
 {
     auto adaptor = qobject_cast<PropertyAdaptor *>(sender());
@@ -372,6 +475,7 @@ void AggregatedPropertyModel::propertyAdded(int first, int last)
     else
         children.insert(first, last - first + 1, 0);
     endInsertRows();
+    invalidatePendingChanges(adaptor);
 }
 
 void AggregatedPropertyModel::propertyRemoved(int first, int last)
@@ -388,6 +492,7 @@ void AggregatedPropertyModel::propertyRemoved(int first, int last)
     auto &children = m_parentChildrenMap[adaptor];
     children.remove(first, last - first + 1);
     endRemoveRows();
+    invalidatePendingChanges(adaptor);
 }
 
 void AggregatedPropertyModel::objectInvalidated()
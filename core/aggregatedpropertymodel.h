@@ -35,6 +35,10 @@
 #include <QHash>
 #include <QVector>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 class PropertyAdaptor;
 class PropertyData;
@@ -63,6 +67,14 @@ public:
                         int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
     QMap<int, QVariant> itemData(const QModelIndex &index) const Q_DECL_OVERRIDE;
 
+    /** Maximum update rate of change notifications per second and property.
+     *  Changes occurring faster than this are coalesced, 0 disables this.
+     */
+    int maximumUpdateRate() const;
+
+public slots:
+    void setMaximumUpdateRate(int rate);
+
 private:
     void clear();
     PropertyAdaptor *adaptorForIndex(const QModelIndex &index) const;
@@ -72,9 +84,13 @@ private:
     void reloadSubTree(PropertyAdaptor *parentAdaptor, int index);
     bool isParentEditable(PropertyAdaptor *adaptor) const;
     void propagateWrite(PropertyAdaptor *adaptor);
+    void emitPropertyChanged(PropertyAdaptor *adaptor, int first, int last);
+    void invalidatePendingChanges(PropertyAdaptor *adaptor);
 
 private slots:
     void propertyChanged(int first, int last);
+    void flushPendingChanges();
+    void adaptorDestroyed(QObject *obj);
     void propertyAdded(int first, int last);
     void propertyRemoved(int first, int last);
     void objectInvalidated();
@@ -84,6 +100,10 @@ private:
     PropertyAdaptor *m_rootAdaptor;
     mutable QHash<PropertyAdaptor *, QVector<PropertyAdaptor *> > m_parentChildrenMap;
     bool m_inhibitAdaptorCreation;
+
+    QTimer *m_updateTimer;
+    QHash<PropertyAdaptor *, QVector<int> > m_pendingChanges;
+    int m_maximumUpdateRate;
 };
 }
 
@@ -0,0 +1,225 @@
+/*
+  creationstacktracker.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "creationstacktracker.h"
+#include "probeguard.h"
+
+#include <QObject>
+#include <QThread>
+
+using namespace GammaRay;
+
+namespace GammaRay {
+class CreationStackResolver : public QThread
+{
+public:
+    explicit CreationStackResolver(CreationStackTracker *tracker)
+        : m_tracker(tracker)
+    {
+    }
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        ProbeGuard guard; // resolving creates a QProcess
+        m_tracker->resolveStacks();
+    }
+
+private:
+    CreationStackTracker *m_tracker;
+};
+}
+
+CreationStackTracker::CreationStackTracker()
+    : m_sampleInterval(0)
+    , m_creationCount(0)
+    , m_resolver(Q_NULLPTR)
+    , m_stopResolver(false)
+{
+}
+
+CreationStackTracker::~CreationStackTracker()
+{
+    if (!m_resolver)
+        return;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stopResolver = true;
+        m_resolverCondition.wakeAll();
+    }
+    m_resolver->wait();
+    delete m_resolver;
+}
+
+bool CreationStackTracker::isEnabled() const
+{
+    return m_sampleInterval > 0;
+}
+
+void CreationStackTracker::setSampleInterval(int interval)
+{
+    QMutexLocker lock(&m_mutex);
+    m_sampleInterval = qMax(0, interval);
+    startResolver();
+}
+
+void CreationStackTracker::setClassFilter(const QStringList &classNames)
+{
+    QMutexLocker lock(&m_mutex);
+    m_classFilter.clear();
+    foreach (const QString &className, classNames)
+        m_classFilter.push_back(className.trimmed().toLatin1());
+}
+
+// pre-condition: m_mutex held
+void CreationStackTracker::startResolver()
+{
+    // started here rather than on the first new stack, as creating objects while
+    // we are being notified about an object creation is not possible
+    if (m_resolver || m_sampleInterval <= 0)
+        return;
+    ProbeGuard guard;
+    m_resolver = new CreationStackResolver(this);
+    m_resolver->start(QThread::LowPriority);
+}
+
+void CreationStackTracker::objectCreated(QObject *obj)
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker lock(&m_mutex);
+    if ((m_creationCount++ % m_sampleInterval) != 0)
+        return;
+
+    void *frames[MaxFrames];
+    const int count = captureBacktrace(frames, MaxFrames);
+    if (m_classFilter.isEmpty()) {
+        addStack(obj, frames, count);
+        return;
+    }
+
+    // the type is only known once construction is complete, until then keep the stack out
+    // of the table, so stacks of other types neither take up room there nor get resolved
+    if (count > 0)
+        m_pendingStacks.insert(obj, QByteArray(reinterpret_cast<const char *>(frames),
+                                               count * int(sizeof(void *))));
+}
+
+// pre-condition: m_mutex held
+void CreationStackTracker::addStack(QObject *obj, void *const *frames, int count)
+{
+    const int stackCount = m_stacks.size();
+    const int id = m_stacks.insert(frames, count);
+    if (id < 0)
+        return;
+    m_objectStacks.insert(obj, id);
+    if (m_stacks.size() > stackCount) {
+        m_unresolvedStacks.push_back(id);
+        m_resolverCondition.wakeAll();
+    }
+}
+
+void CreationStackTracker::objectConstructed(QObject *obj)
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker lock(&m_mutex);
+    const QByteArray stack = m_pendingStacks.take(obj);
+    if (stack.isEmpty())
+        return;
+
+    foreach (const QByteArray &className, m_classFilter) {
+        if (obj->inherits(className.constData())) {
+            addStack(obj, reinterpret_cast<void *const *>(stack.constData()),
+                     stack.size() / int(sizeof(void *)));
+            return;
+        }
+    }
+}
+
+void CreationStackTracker::objectRemoved(QObject *obj)
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker lock(&m_mutex);
+    m_objectStacks.remove(obj);
+    m_pendingStacks.remove(obj);
+}
+
+SourceLocation CreationStackTracker::creationLocation(QObject *obj) const
+{
+    if (!isEnabled())
+        return SourceLocation();
+
+    QMutexLocker lock(&m_mutex);
+    const int id = m_objectStacks.value(obj, -1);
+    if (id < 0)
+        return SourceLocation();
+    return m_resolvedLocations.value(id);
+}
+
+void CreationStackTracker::resolveStacks()
+{
+    // wait a bit after the first new stack, so we get larger batches during startup
+    static const unsigned long BatchDelay = 250; // ms
+
+    QMutexLocker lock(&m_mutex);
+    forever {
+        while (m_unresolvedStacks.isEmpty() && !m_stopResolver)
+            m_resolverCondition.wait(&m_mutex);
+        if (m_stopResolver)
+            return;
+        lock.unlock();
+        QThread::msleep(BatchDelay);
+        lock.relock();
+        if (m_stopResolver)
+            return;
+
+        const QVector<int> ids = m_unresolvedStacks;
+        m_unresolvedStacks.clear();
+        QVector<QByteArray> stacks;
+        stacks.reserve(ids.size());
+        foreach (int id, ids)
+            stacks.push_back(m_stacks.stack(id));
+
+        lock.unlock();
+        const QVector<SourceLocation> locations = resolveSourceLocations(stacks);
+        lock.relock();
+
+        for (int i = 0; i < ids.size(); ++i)
+            m_resolvedLocations.insert(ids.at(i), locations.at(i));
+    }
+}
+
+int CreationStackTracker::stackCount() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stacks.size();
+}
@@ -0,0 +1,111 @@
+/*
+  creationstacktracker.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_CREATIONSTACKTRACKER_H
+#define GAMMARAY_CREATIONSTACKTRACKER_H
+
+#include <common/sourcelocation.h>
+#include <core/tools/messagehandler/backtrace.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+class QThread;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** @brief Records sampled creation backtraces of QObjects.
+ *
+ *  Only the raw return addresses are captured when an object is created, identical
+ *  stacks are stored only once. New stacks are resolved to a source location in
+ *  batches in a background thread, creationLocation() never waits for that.
+ *  Disabled by default, see setSampleInterval() and setClassFilter().
+ */
+class CreationStackTracker
+{
+public:
+    CreationStackTracker();
+    ~CreationStackTracker();
+
+    bool isEnabled() const;
+    /** Record the creation of every @p interval-th object, 0 disables recording. */
+    void setSampleInterval(int interval);
+    /** Only keep creation stacks of sampled objects inheriting one of @p classNames.
+     *  The class is only known after construction, so this doesn't save capturing stacks,
+     *  but stacks of other classes are neither stored nor resolved.
+     */
+    void setClassFilter(const QStringList &classNames);
+
+    // pre-condition: object lock held, arbitrary thread
+    void objectCreated(QObject *obj);
+    // pre-condition: object lock held, our thread
+    void objectConstructed(QObject *obj);
+    // pre-condition: object lock held, arbitrary thread
+    void objectRemoved(QObject *obj);
+
+    /** Source location @p obj has been created at, if it has been sampled and has already
+     *  been resolved. Returns an invalid location otherwise.
+     */
+    SourceLocation creationLocation(QObject *obj) const;
+
+    /** Number of distinct creation stacks recorded. */
+    int stackCount() const;
+
+    /// internal, runs in the resolver thread
+    void resolveStacks();
+
+private:
+    void startResolver();
+    void addStack(QObject *obj, void *const *frames, int count);
+
+    enum { MaxFrames = 32 };
+
+    mutable QMutex m_mutex;
+    int m_sampleInterval;
+    quint64 m_creationCount;
+    QVector<QByteArray> m_classFilter;
+
+    QHash<QObject *, int> m_objectStacks;
+    // raw stacks of objects not fully constructed yet, while a class filter is set
+    QHash<QObject *, QByteArray> m_pendingStacks;
+    BacktraceTable m_stacks;
+    QHash<int, SourceLocation> m_resolvedLocations;
+
+    // stack ids waiting for the resolver thread
+    QVector<int> m_unresolvedStacks;
+    QWaitCondition m_resolverCondition;
+    QThread *m_resolver;
+    bool m_stopResolver;
+};
+}
+
+#endif // GAMMARAY_CREATIONSTACKTRACKER_H
@@ -87,8 +87,10 @@ MetaObjectTreeModel::MetaObjectTreeModel(QObject *parent)
     qRegisterMetaType<const QMetaObject *>();
     scanMetaTypes();
 
+    // upper bound for the update rate of the counters
     m_pendingDataChangedTimer->setInterval(100);
     m_pendingDataChangedTimer->setSingleShot(true);
+    m_rateWindow.start();
     connect(m_pendingDataChangedTimer, SIGNAL(timeout()), this, SLOT(emitPendingDataChanged()));
 }
 
@@ -134,6 +136,14 @@ QVariant MetaObjectTreeModel::data(const QModelIndex &index, int role) const
             if (inheritsQObject(object))
                 return m_metaObjectInfoMap.value(object).inclusiveAliveCount;
             return QStringLiteral("-");
+        case QMetaObjectModel::ObjectInclusiveCreationRateColumn:
+            if (inheritsQObject(object))
+                return qRound(m_metaObjectInfoMap.value(object).creationRate * 10) / 10.0;
+            return QStringLiteral("-");
+        case QMetaObjectModel::ObjectInclusiveDestructionRateColumn:
+            if (inheritsQObject(object))
+                return qRound(m_metaObjectInfoMap.value(object).destructionRate * 10) / 10.0;
+            return QStringLiteral("-");
         default:
             break;
         }
@@ -219,27 +229,13 @@ void MetaObjectTreeModel::objectAdded(QObject *obj)
      * - selfCount for that particular @p metaObject
      * - inclusiveCount for @p metaObject and *all* ancestors
      *
-     * Complexity-wise the inclusive count calculation should be okay,
-     * since the number of ancestors should be rather small
-     * (QMetaObject class hierarchy is rather a broad than a deep tree structure)
-     *
-     * If this yields some performance issues, we might need to remove the inclusive
-     * costs calculation altogether (a calculate-on-request pattern should be even slower)
+     * Only the creation is recorded here, updating the counters of the whole ancestor
+     * chain and notifying the views is batched in emitPendingDataChanged(), since
+     * objects tend to be created in bursts.
      */
     m_metaObjectMap.insert(obj, metaObject);
-    auto &info = m_metaObjectInfoMap[metaObject];
-    ++info.selfCount;
-    ++info.selfAliveCount;
-
-    // increase inclusive counts
-    const QMetaObject *current = metaObject;
-    while (current) {
-        auto &info = m_metaObjectInfoMap[current];
-        ++info.inclusiveCount;
-        ++info.inclusiveAliveCount;
-        scheduleDataChange(current);
-        current = current->superClass();
-    }
+    ++m_pendingChanges[metaObject].createdCount;
+    scheduleFlush();
 }
 
 void MetaObjectTreeModel::scanMetaTypes()
@@ -295,31 +291,20 @@ void MetaObjectTreeModel::objectRemoved(QObject *obj)
     if (!metaObject)
         return;
 
-    const QModelIndex metaModelIndex = indexForMetaObject(metaObject);
-    if (!metaModelIndex.isValid()) {
+    if (!isKnownMetaObject(metaObject)) {
         // something went wrong, ignore
         return;
     }
 
-    assert(m_metaObjectInfoMap.contains(metaObject));
-    if (m_metaObjectInfoMap[metaObject].selfAliveCount == 0) {
+    PendingChange &change = m_pendingChanges[metaObject];
+    if (m_metaObjectInfoMap.value(metaObject).selfAliveCount + change.createdCount
+        - change.destroyedCount <= 0) {
         // something went wrong, but let's just ignore this event in case of assert
         return;
     }
 
-    --m_metaObjectInfoMap[metaObject].selfAliveCount;
-    assert(m_metaObjectInfoMap[metaObject].selfAliveCount >= 0);
-
-    // decrease inclusive counts
-    const QMetaObject *current = metaObject;
-    while (current) {
-        --m_metaObjectInfoMap[current].inclusiveAliveCount;
-        assert(m_metaObjectInfoMap[current].inclusiveAliveCount >= 0);
-        scheduleDataChange(current);
-        current = current->superClass();
-    }
-
-    scheduleDataChange(metaObject);
+    ++change.destroyedCount;
+    scheduleFlush();
 }
 
 bool MetaObjectTreeModel::isKnownMetaObject(const QMetaObject *metaObject) const
@@ -355,21 +340,88 @@ const QMetaObject *MetaObjectTreeModel::metaObjectForIndex(const QModelIndex &in
     return metaObject;
 }
 
-void GammaRay::MetaObjectTreeModel::scheduleDataChange(const QMetaObject *mo)
+void GammaRay::MetaObjectTreeModel::scheduleFlush()
 {
-    m_pendingDataChanged.insert(mo);
     if (!m_pendingDataChangedTimer->isActive())
         m_pendingDataChangedTimer->start();
 }
 
 void GammaRay::MetaObjectTreeModel::emitPendingDataChanged()
 {
-    foreach (auto mo, m_pendingDataChanged) {
-        auto index = indexForMetaObject(mo);
+    // start a new rate window when coming out of idle, so the first rate isn't diluted
+    if (m_rateActiveMetaObjects.isEmpty())
+        m_rateWindow.restart();
+
+    QSet<const QMetaObject *> changed;
+    for (auto it = m_pendingChanges.constBegin(); it != m_pendingChanges.constEnd(); ++it) {
+        const PendingChange &change = it.value();
+        auto &info = m_metaObjectInfoMap[it.key()];
+        info.selfCount += change.createdCount;
+        info.selfAliveCount += change.createdCount - change.destroyedCount;
+        assert(info.selfAliveCount >= 0);
+
+        // inclusive counts
+        const QMetaObject *current = it.key();
+        while (current) {
+            auto &info = m_metaObjectInfoMap[current];
+            info.inclusiveCount += change.createdCount;
+            info.inclusiveAliveCount += change.createdCount - change.destroyedCount;
+            assert(info.inclusiveAliveCount >= 0);
+            info.windowCreatedCount += change.createdCount;
+            info.windowDestroyedCount += change.destroyedCount;
+            changed.insert(current);
+            m_rateActiveMetaObjects.insert(current);
+            current = current->superClass();
+        }
+    }
+    m_pendingChanges.clear();
+
+    updateRates(changed);
+
+    // one notification per parent, covering all changed siblings
+    QHash<const QMetaObject *, QPair<int, int> > changedRows;
+    foreach (auto mo, changed) {
+        const auto index = indexForMetaObject(mo);
         if (!index.isValid())
             continue;
-        emit dataChanged(index.sibling(index.row(), QMetaObjectModel::ObjectSelfCountColumn),
-                         index.sibling(index.row(), QMetaObjectModel::ObjectInclusiveCountColumn));
+        const QMetaObject *parentMo = m_childParentMap.value(mo);
+        auto it = changedRows.find(parentMo);
+        if (it == changedRows.end()) {
+            changedRows.insert(parentMo, qMakePair(index.row(), index.row()));
+        } else {
+            it.value().first = qMin(it.value().first, index.row());
+            it.value().second = qMax(it.value().second, index.row());
+        }
+    }
+    for (auto it = changedRows.constBegin(); it != changedRows.constEnd(); ++it) {
+        const auto parentIndex = indexForMetaObject(it.key());
+        emit dataChanged(index(it.value().first, QMetaObjectModel::ObjectSelfCountColumn, parentIndex),
+                         index(it.value().second, QMetaObjectModel::_Last - 1, parentIndex));
+    }
+
+    // keep going until all rates dropped back to zero
+    if (!m_rateActiveMetaObjects.isEmpty())
+        m_pendingDataChangedTimer->start();
+}
+
+void GammaRay::MetaObjectTreeModel::updateRates(QSet<const QMetaObject *> &changed)
+{
+    const qint64 elapsed = m_rateWindow.elapsed();
+    if (elapsed < 1000)
+        return;
+    m_rateWindow.restart();
+
+    for (auto it = m_rateActiveMetaObjects.begin(); it != m_rateActiveMetaObjects.end();) {
+        auto &info = m_metaObjectInfoMap[*it];
+        info.creationRate = info.windowCreatedCount * 1000.0 / elapsed;
+        info.destructionRate = info.windowDestroyedCount * 1000.0 / elapsed;
+        changed.insert(*it);
+        if (info.windowCreatedCount == 0 && info.windowDestroyedCount == 0) {
+            it = m_rateActiveMetaObjects.erase(it);
+        } else {
+            info.windowCreatedCount = 0;
+            info.windowDestroyedCount = 0;
+            ++it;
+        }
     }
-    m_pendingDataChanged.clear();
 }
@@ -29,6 +29,7 @@
 #ifndef GAMMARAY_METAOBJECTTREEMODEL_H
 #define GAMMARAY_METAOBJECTTREEMODEL_H
 
+#include <QElapsedTimer>
 #include <QModelIndex>
 #include <QSet>
 #include <QVector>
@@ -76,7 +77,8 @@ private:
     QModelIndex indexForMetaObject(const QMetaObject *metaObject) const;
     const QMetaObject *metaObjectForIndex(const QModelIndex &index) const;
 
-    void scheduleDataChange(const QMetaObject *mo);
+    void scheduleFlush();
+    void updateRates(QSet<const QMetaObject *> &changed);
 
 private slots:
     void emitPendingDataChanged();
@@ -91,7 +93,11 @@ private:
             : selfCount(0)
             , selfAliveCount(0)
             , inclusiveCount(0)
-            , inclusiveAliveCount(0) {}
+            , inclusiveAliveCount(0)
+            , windowCreatedCount(0)
+            , windowDestroyedCount(0)
+            , creationRate(0.0)
+            , destructionRate(0.0) {}
 
         /// Number of objects of a particular meta object type ever created
         int selfCount;
@@ -104,14 +110,38 @@ private:
         int inclusiveCount;
         /// Inclusive instance count currently alive
         int inclusiveAliveCount;
+        /// Inclusive creations and destructions in the current rate window
+        int windowCreatedCount;
+        int windowDestroyedCount;
+        /// Inclusive creations and destructions per second in the last completed rate window
+        double creationRate;
+        double destructionRate;
     };
     QHash<const QMetaObject*, MetaObjectInfo> m_metaObjectInfoMap;
     /// meta objects at creation time, so we can correctly decrement instance counts
     /// after destruction
     QHash<QObject*, const QMetaObject*> m_metaObjectMap;
 
-    QSet<const QMetaObject *> m_pendingDataChanged;
+    /**
+     * Object creations and destructions not yet accounted for in m_metaObjectInfoMap.
+     * Those only touch the exact meta object, propagating this to all ancestors
+     * and notifying views is done in one go by emitPendingDataChanged().
+     */
+    struct PendingChange
+    {
+        PendingChange()
+            : createdCount(0)
+            , destroyedCount(0) {}
+
+        int createdCount;
+        int destroyedCount;
+    };
+    QHash<const QMetaObject *, PendingChange> m_pendingChanges;
     QTimer *m_pendingDataChangedTimer;
+
+    /// meta objects with a non-zero rate or activity in the current rate window
+    QSet<const QMetaObject *> m_rateActiveMetaObjects;
+    QElapsedTimer m_rateWindow;
 };
 }
 
@@ -29,6 +29,7 @@
 #include "multisignalmapper.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QMetaMethod>
 #include <QMetaObject>
 #include <QVariant>
@@ -39,7 +40,8 @@ class MultiSignalMapperPrivate : public QObject
 public:
     explicit MultiSignalMapperPrivate(MultiSignalMapper *parent)
         : QObject(parent)
-        , q(parent) {}
+        , q(parent)
+        , receiver(0) {}
     ~MultiSignalMapperPrivate() {}
 
     int qt_metacall(QMetaObject::Call call, int methodId, void **args) Q_DECL_OVERRIDE
@@ -49,44 +51,76 @@ public:
             return methodId;
 
         if (call == QMetaObject::InvokeMetaMethod) {
-            Q_ASSERT(sender());
-            const QVector<QVariant> v = convertArguments(sender(), methodId, args);
-            emit q->signalEmitted(sender(), methodId, v);
+            QObject *s = sender();
+            Q_ASSERT(s);
+            // copy, the receiver might connect to further signals and thus modify the hash
+            const QVector<int> types = argumentTypes(s->metaObject(), methodId);
+            if (receiver) {
+                receiver->signalEmitted(s, methodId, types, args);
+            } else {
+                const QVector<QVariant> v = convertArguments(types, args);
+                emit q->signalEmitted(s, methodId, v);
+            }
             return -1; // indicates we handled the call
         }
         return methodId;
     }
 
-    QVector<QVariant> convertArguments(QObject *sender, int signalIndex, void **args)
+    QVector<int> argumentTypes(const QMetaObject *mo, int signalIndex)
     {
-        Q_ASSERT(sender);
+        Q_ASSERT(mo);
         Q_ASSERT(signalIndex >= 0);
 
-        const QMetaMethod signal = sender->metaObject()->method(signalIndex);
+        const auto key = qMakePair(mo, signalIndex);
+        auto it = signalArgumentTypes.constFind(key);
+        if (it != signalArgumentTypes.constEnd())
+            return it.value();
+
+        const QMetaMethod signal = mo->method(signalIndex);
         Q_ASSERT(signal.methodType() == QMetaMethod::Signal);
 
-        QVector<QVariant> v;
         const QList<QByteArray> paramTypes = signal.parameterTypes();
-        for (int i = 0; i < paramTypes.size(); ++i) {
-            int type = QMetaType::type(paramTypes[i]);
+        QVector<int> types;
+        types.reserve(paramTypes.size());
+        foreach (const QByteArray &paramType, paramTypes) {
+            const int type = QMetaType::type(paramType);
             if (type == QMetaType::Void || !type) {
                 qWarning() << Q_FUNC_INFO << "unknown metatype for signal argument type"
-                           << paramTypes[i];
+                           << paramType;
+                types.push_back(QMetaType::Void);
                 continue;
             }
-            v.push_back(QVariant(type, args[i + 1]));
+            types.push_back(type);
         }
+        signalArgumentTypes.insert(key, types);
+        return types;
+    }
 
+    static QVector<QVariant> convertArguments(const QVector<int> &types, void **args)
+    {
+        QVector<QVariant> v;
+        v.reserve(types.size());
+        for (int i = 0; i < types.size(); ++i) {
+            if (types.at(i) == QMetaType::Void)
+                continue;
+            v.push_back(QVariant(types.at(i), args[i + 1]));
+        }
         return v;
     }
 
-private:
     MultiSignalMapper *q;
+    MultiSignalMapper::Receiver *receiver;
+    // argument types per (meta object, signal index), resolved once in connectToSignal
+    QHash<QPair<const QMetaObject *, int>, QVector<int> > signalArgumentTypes;
 };
 }
 
 using namespace GammaRay;
 
+MultiSignalMapper::Receiver::~Receiver()
+{
+}
+
 MultiSignalMapper::MultiSignalMapper(QObject *parent)
     : QObject(parent)
     , d(new MultiSignalMapperPrivate(this))
@@ -99,7 +133,13 @@ MultiSignalMapper::~MultiSignalMapper()
 
 void MultiSignalMapper::connectToSignal(QObject *sender, const QMetaMethod &signal)
 {
+    d->argumentTypes(sender->metaObject(), signal.methodIndex());
     QMetaObject::connect(sender, signal.methodIndex(), d,
                          QObject::metaObject()->methodCount() + signal.methodIndex(), Qt::AutoConnection | Qt::UniqueConnection,
                          0);
 }
+
+void MultiSignalMapper::setReceiver(Receiver *receiver)
+{
+    d->receiver = receiver;
+}
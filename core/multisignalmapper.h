@@ -42,11 +42,35 @@ class MultiSignalMapper : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * Receives mapped signal emissions with the raw signal arguments.
+     * This avoids converting the arguments to QVariants for signalEmitted().
+     */
+    class Receiver
+    {
+    public:
+        virtual ~Receiver();
+        /**
+         * Called for each emission of a mapped signal.
+         * @param argumentTypes The meta type ids of the signal arguments, QMetaType::Void
+         * for arguments of unknown type.
+         * @param args The signal arguments, in the qt_metacall layout (ie. starting at index 1).
+         */
+        virtual void signalEmitted(QObject *sender, int signalIndex,
+                                   const QVector<int> &argumentTypes, void **args) = 0;
+    };
+
     explicit MultiSignalMapper(QObject *parent = 0);
     ~MultiSignalMapper();
 
     void connectToSignal(QObject *sender, const QMetaMethod &signal);
 
+    /**
+     * Deliver signal emissions to @p receiver instead of emitting signalEmitted().
+     * Does not take ownership.
+     */
+    void setReceiver(Receiver *receiver);
+
 signals:
     void signalEmitted(QObject *sender, int signalIndex, const QVector<QVariant> &arguments);
 
@@ -27,6 +27,8 @@
 */
 
 #include "objectdataprovider.h"
+#include "creationstacktracker.h"
+#include "probe.h"
 
 #include <common/sourcelocation.h>
 
@@ -86,6 +88,10 @@ SourceLocation ObjectDataProvider::creationLocation(QObject *obj)
             return loc;
     }
 
+    // plain C++ objects, if sampling of creation backtraces is enabled
+    if (Probe::isInitialized())
+        return Probe::instance()->creationStackTracker()->creationLocation(obj);
+
     return loc;
 }
 
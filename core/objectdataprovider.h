@@ -67,7 +67,12 @@ GAMMARAY_CORE_EXPORT QString name(const QObject *obj);
 /** Returns the type name of @p obj. */
 GAMMARAY_CORE_EXPORT QString typeName(QObject *obj);
 
-/** Returns the source location where this object was created, if known. */
+/** Returns the source location where this object was created, if known.
+ *  For C++ objects this requires creation backtraces to be recorded, by setting the
+ *  CreationStackSampleInterval probe setting, optionally restricted to certain classes
+ *  with CreationStackClassFilter. Those are resolved in the background, until then an
+ *  invalid location is returned.
+ */
 GAMMARAY_CORE_EXPORT SourceLocation creationLocation(QObject *obj);
 
 /** Returns the source location where the type of this object was declared, if known. */
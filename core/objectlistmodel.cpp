@@ -42,8 +42,8 @@ using namespace std;
 ObjectListModel::ObjectListModel(Probe *probe)
     : ObjectModelBase< QAbstractTableModel >(probe)
 {
-    connect(probe, SIGNAL(objectCreated(QObject*)),
-            this, SLOT(objectAdded(QObject*)));
+    connect(probe, SIGNAL(objectsCreated(QVector<QObject*>)),
+            this, SLOT(objectsAdded(QVector<QObject*>)));
     connect(probe, SIGNAL(objectDestroyed(QObject*)),
             this, SLOT(objectRemoved(QObject*)));
 }
@@ -80,23 +80,22 @@ int ObjectListModel::rowCount(const QModelIndex &parent) const
     return m_objects.size();
 }
 
-void ObjectListModel::objectAdded(QObject *obj)
+void ObjectListModel::objectsAdded(const QVector<QObject *> &objects)
 {
-    // see Probe::objectCreated, that promises a valid object in the main thread
+    // see Probe::objectsCreated, that promises to be called in the main thread
     Q_ASSERT(QThread::currentThread() == thread());
-    Q_ASSERT(obj);
-    Q_ASSERT(Probe::instance()->isValidObject(obj));
 
-    QVector<QObject *>::iterator it = std::lower_bound(m_objects.begin(), m_objects.end(), obj);
-    Q_ASSERT(it == m_objects.end() || *it != obj);
-
-    const int row = std::distance(m_objects.begin(), it);
-    Q_ASSERT(row >= 0 && row <= m_objects.size());
+    QVector<QObject *> newObjects;
+    newObjects.reserve(objects.size());
+    foreach (QObject *obj, objects) {
+        // might have been destroyed again while the batch was collected
+        if (Probe::instance()->isValidObject(obj))
+            newObjects.push_back(obj);
+    }
+    std::sort(newObjects.begin(), newObjects.end());
+    newObjects.erase(std::unique(newObjects.begin(), newObjects.end()), newObjects.end());
 
-    beginInsertRows(QModelIndex(), row, row);
-    m_objects.insert(it, obj);
-    Q_ASSERT(m_objects.at(row) == obj);
-    endInsertRows();
+    insertObjects(QModelIndex(), m_objects, newObjects);
 }
 
 void ObjectListModel::objectRemoved(QObject *obj)
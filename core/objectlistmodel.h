@@ -62,7 +62,7 @@ public slots:
     QPair<int, QVariant> defaultSelectedItem() const;
 
 private slots:
-    void objectAdded(QObject *obj);
+    void objectsAdded(const QVector<QObject *> &objects);
     void objectRemoved(QObject *obj);
 
 private:
@@ -47,6 +47,10 @@
 
 #include <QModelIndex>
 #include <QObject>
+#include <QPair>
+#include <QVector>
+
+#include <algorithm>
 
 namespace GammaRay {
 /**
@@ -149,6 +153,47 @@ public:
         }
         return Base::headerData(section, orientation, role);
     }
+
+protected:
+    /**
+     * Merges @p newObjects into the sorted list @p objects holding the rows below @p parent.
+     * @p newObjects has to be sorted and free of duplicates, entries already contained in
+     * @p objects are skipped. Row insertion is announced once per contiguous run of new rows
+     * rather than once per object.
+     */
+    void insertObjects(const QModelIndex &parent, QVector<QObject *> &objects,
+                       const QVector<QObject *> &newObjects)
+    {
+        // single pass over both lists, collecting (row, count) runs
+        QVector<QObject *> added;
+        added.reserve(newObjects.size());
+        QVector<QPair<int, int> > runs;
+        QVector<QObject *>::const_iterator pos = objects.constBegin();
+        foreach (QObject *obj, newObjects) {
+            pos = std::lower_bound(pos, objects.constEnd(), obj);
+            if (pos != objects.constEnd() && *pos == obj)
+                continue;
+            const int row = std::distance(objects.constBegin(), pos);
+            if (!runs.isEmpty() && runs.last().first == row)
+                ++runs.last().second;
+            else
+                runs.push_back(qMakePair(row, 1));
+            added.push_back(obj);
+        }
+
+        // insert back to front, so the rows computed above remain valid
+        int end = added.size();
+        for (int i = runs.size() - 1; i >= 0; --i) {
+            const int row = runs.at(i).first;
+            const int count = runs.at(i).second;
+            end -= count;
+            Base::beginInsertRows(parent, row, row + count - 1);
+            objects.insert(row, count, 0);
+            std::copy(added.constBegin() + end, added.constBegin() + end + count,
+                      objects.begin() + row);
+            Base::endInsertRows();
+        }
+    }
 };
 }
 
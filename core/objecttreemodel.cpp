@@ -32,6 +32,7 @@
 
 #include <QEvent>
 #include <QMutex>
+#include <QSet>
 #include <QThread>
 #include <QCoreApplication>
 
@@ -48,8 +49,8 @@ using namespace GammaRay;
 ObjectTreeModel::ObjectTreeModel(Probe *probe)
     : ObjectModelBase< QAbstractItemModel >(probe)
 {
-    connect(probe, SIGNAL(objectCreated(QObject*)),
-            this, SLOT(objectAdded(QObject*)));
+    connect(probe, SIGNAL(objectsCreated(QVector<QObject*>)),
+            this, SLOT(objectsAdded(QVector<QObject*>)));
     connect(probe, SIGNAL(objectDestroyed(QObject*)),
             this, SLOT(objectRemoved(QObject*)));
     connect(probe, SIGNAL(objectReparented(QObject*)),
@@ -114,6 +115,55 @@ void ObjectTreeModel::objectAdded(QObject *obj)
     endInsertRows();
 }
 
+void ObjectTreeModel::objectsAdded(const QVector<QObject *> &objects)
+{
+    // see Probe::objectsCreated, that promises to be called in the main thread
+    Q_ASSERT(thread() == QThread::currentThread());
+
+    // group by parent, so each sibling list is merged only once
+    QHash<QObject *, QVector<QObject *> > newChildren;
+    QSet<QObject *> pendingObjects;
+    foreach (QObject *obj, objects) {
+        if (!Probe::instance()->isValidObject(obj) || m_childParentMap.contains(obj))
+            continue;
+        newChildren[parentObject(obj)].push_back(obj);
+        pendingObjects.insert(obj);
+    }
+
+    // parents have to be inserted before their children, so defer sibling lists
+    // whose parent is still part of this batch
+    while (!newChildren.isEmpty()) {
+        for (auto it = newChildren.begin(); it != newChildren.end();) {
+            QObject *parentObj = it.key();
+            if (parentObj && !m_childParentMap.contains(parentObj)) {
+                if (pendingObjects.contains(parentObj)) {
+                    ++it;
+                    continue;
+                }
+                // same as in objectAdded, handle a parent we missed so far first
+                objectAdded(parentObj);
+            }
+            foreach (QObject *obj, it.value())
+                pendingObjects.remove(obj);
+            insertChildren(parentObj, it.value());
+            it = newChildren.erase(it);
+        }
+    }
+}
+
+void ObjectTreeModel::insertChildren(QObject *parentObj, QVector<QObject *> children)
+{
+    const QModelIndex index = indexForObject(parentObj);
+    Q_ASSERT(index.isValid() || !parentObj);
+
+    std::sort(children.begin(), children.end());
+    children.erase(std::unique(children.begin(), children.end()), children.end());
+    foreach (QObject *obj, children)
+        m_childParentMap.insert(obj, parentObj);
+
+    insertObjects(index, m_parentChildMap[parentObj], children);
+}
+
 void ObjectTreeModel::objectRemoved(QObject *obj)
 {
     // slot, hence should always land in main thread due to auto connection
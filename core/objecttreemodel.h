@@ -53,11 +53,13 @@ public slots:
 
 private slots:
     void objectAdded(QObject *obj);
+    void objectsAdded(const QVector<QObject *> &objects);
     void objectRemoved(QObject *obj);
     void objectReparented(QObject *obj);
 
 private:
     QModelIndex indexForObject(QObject *object) const;
+    void insertChildren(QObject *parentObj, QVector<QObject *> children);
 
 private:
     QHash<QObject *, QObject *> m_childParentMap;
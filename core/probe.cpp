@@ -31,6 +31,7 @@
 #include <config-gammaray.h>
 
 #include "probe.h"
+#include "creationstacktracker.h"
 #include "enumrepositoryserver.h"
 #include "metaobjectrepository.h"
 #include "objectlistmodel.h"
@@ -60,6 +61,7 @@
 #include <QWindow>
 #endif
 #include <QDir>
+#include <QElapsedTimer>
 #include <QLibrary>
 #include <QMouseEvent>
 #include <QUrl>
@@ -207,7 +209,12 @@ Probe::Probe(QObject *parent)
     , m_objectListModel(new ObjectListModel(this))
     , m_objectTreeModel(new ObjectTreeModel(this))
     , m_window(0)
+    , m_objectCreationBatchDepth(0)
     , m_queueTimer(new QTimer(this))
+    , m_discoveryTimer(new QTimer(this))
+    , m_discoveredObjectCount(0)
+    , m_probeController(Q_NULLPTR)
+    , m_creationStackTracker(new CreationStackTracker)
     , m_server(Q_NULLPTR)
 {
     Q_ASSERT(thread() == qApp->thread());
@@ -216,10 +223,17 @@ Probe::Probe(QObject *parent)
     StreamOperators::registerOperators();
     ProbeSettings::receiveSettings();
 
+    m_creationStackTracker->setSampleInterval(
+        ProbeSettings::value(QStringLiteral("CreationStackSampleInterval"), 0).toInt());
+    m_creationStackTracker->setClassFilter(
+        ProbeSettings::value(QStringLiteral("CreationStackClassFilter"), QString()).toString()
+        .split(QLatin1Char(','), QString::SkipEmptyParts));
+
     m_server = new Server(this);
 
     ObjectBroker::setSelectionModelFactoryCallback(selectionModelFactory);
-    ObjectBroker::registerObject<ProbeControllerInterface *>(new ProbeController(this));
+    m_probeController = new ProbeController(this);
+    ObjectBroker::registerObject<ProbeControllerInterface *>(m_probeController);
     m_toolManager = new ToolManager(this);
     ObjectBroker::registerObject<ToolManagerInterface *>(m_toolManager);
 
@@ -239,6 +253,11 @@ Probe::Probe(QObject *parent)
     connect(m_queueTimer, SIGNAL(timeout()),
             this, SLOT(processQueuedObjectChanges()));
 
+    m_discoveryTimer->setSingleShot(true);
+    m_discoveryTimer->setInterval(0);
+    connect(m_discoveryTimer, SIGNAL(timeout()),
+            this, SLOT(processObjectDiscovery()));
+
     m_previousSignalSpyCallbackSet.signalBeginCallback
         = qt_signal_spy_callback_set.signal_begin_callback;
     m_previousSignalSpyCallbackSet.signalEndCallback
@@ -268,6 +287,7 @@ Probe::~Probe()
     VariantHandler::clear();
 
     s_instance = QAtomicPointer<Probe>(0);
+    delete m_creationStackTracker;
 }
 
 void Probe::setWindow(QObject *window)
@@ -338,6 +358,7 @@ void Probe::createProbe(bool findExisting)
         Q_ASSERT(!instance());
 
         s_instance = QAtomicPointer<Probe>(probe);
+        probe->beginObjectCreationBatch();
 
         // add objects to the probe that were tracked before its creation
         foreach (QObject *obj, s_listener()->addedBeforeProbeInstance)
@@ -347,6 +368,8 @@ void Probe::createProbe(bool findExisting)
         // try to find existing objects by other means
         if (findExisting)
             probe->findExistingObjects();
+
+        probe->endObjectCreationBatch();
     }
 
     // eventually initialize the rest
@@ -501,6 +524,11 @@ bool Probe::isValidObject(QObject *obj) const
     return m_validObjects.contains(obj);
 }
 
+CreationStackTracker *Probe::creationStackTracker() const
+{
+    return m_creationStackTracker;
+}
+
 QMutex *Probe::objectLock()
 {
     return s_lock();
@@ -574,6 +602,13 @@ void Probe::objectAdded(QObject *obj, bool fromCtor)
     Q_ASSERT(!obj->parent() || instance()->m_validObjects.contains(obj->parent()));
 
     instance()->m_validObjects << obj;
+    if (fromCtor) {
+        instance()->m_creationStackTracker->objectCreated(obj);
+        foreach (const ObjectLifetimeCallbackSet &callbacks, instance()->m_objectLifetimeCallbacks) {
+            if (callbacks.objectCreatedCallback)
+                callbacks.objectCreatedCallback(obj);
+        }
+    }
     if (!instance()->hasReliableObjectTracking()) {
         // when we did not use a preload variant that
         // overwrites qt_removeObject we must track object
@@ -612,16 +647,19 @@ void Probe::processQueuedObjectChanges()
     // must be called from the main thread via timeout
     Q_ASSERT(QThread::currentThread() == thread());
 
+    beginObjectCreationBatch();
     foreach (const auto &change, m_queuedObjectChanges) {
         switch (change.type) {
         case ObjectChange::Create:
             objectFullyConstructed(change.obj);
             break;
         case ObjectChange::Destroy:
+            flushCreatedObjects();
             emit objectDestroyed(change.obj);
             break;
         }
     }
+    endObjectCreationBatch();
 
     IF_DEBUG(cout << Q_FUNC_INFO << " done" << endl;
              )
@@ -656,6 +694,13 @@ void Probe::objectFullyConstructed(QObject *obj)
         // the parent might not have been set properly yet. hence
         // apply the filter again
         m_validObjects.remove(obj);
+        m_creationStackTracker->objectRemoved(obj);
+        // the lifetime callbacks saw the creation already from the ctor, and won't see the
+        // destruction of an object we no longer track
+        foreach (const ObjectLifetimeCallbackSet &callbacks, m_objectLifetimeCallbacks) {
+            if (callbacks.objectDestroyedCallback)
+                callbacks.objectDestroyedCallback(obj);
+        }
         IF_DEBUG(cout << "now filtered fully constructed: " << hex << obj << endl;
                  )
         return;
@@ -679,9 +724,14 @@ void Probe::objectFullyConstructed(QObject *obj)
     if (obj->inherits("QQuickItem"))
         connect(obj, SIGNAL(parentChanged(QQuickItem*)), this, SLOT(objectParentChanged()));
 
+    m_creationStackTracker->objectConstructed(obj);
     m_toolManager->objectAdded(obj);
 
     emit objectCreated(obj);
+
+    m_createdObjects.push_back(obj);
+    if (!m_objectCreationBatchDepth)
+        flushCreatedObjects();
 }
 
 /*
@@ -727,13 +777,21 @@ void Probe::objectRemoved(QObject *obj)
         return;
     }
 
+    foreach (const ObjectLifetimeCallbackSet &callbacks, instance()->m_objectLifetimeCallbacks) {
+        if (callbacks.objectDestroyedCallback)
+            callbacks.objectDestroyedCallback(obj);
+    }
+    instance()->m_creationStackTracker->objectRemoved(obj);
+
     instance()->purgeChangesForObject(obj);
     EXPENSIVE_ASSERT(!instance()->isObjectCreationQueued(obj));
 
-    if (instance()->thread() == QThread::currentThread())
+    if (instance()->thread() == QThread::currentThread()) {
+        instance()->flushCreatedObjects();
         emit instance()->objectDestroyed(obj);
-    else
+    } else {
         instance()->queueDestroyedObject(obj);
+    }
 }
 
 void Probe::handleObjectDestroyed(QObject *obj)
@@ -790,6 +848,37 @@ void Probe::purgeChangesForObject(QObject *obj)
     }
 }
 
+// pre-condition: we have the lock, our thread
+void Probe::beginObjectCreationBatch()
+{
+    Q_ASSERT(thread() == QThread::currentThread());
+    ++m_objectCreationBatchDepth;
+}
+
+// pre-condition: we have the lock, our thread
+void Probe::endObjectCreationBatch()
+{
+    Q_ASSERT(m_objectCreationBatchDepth > 0);
+    if (--m_objectCreationBatchDepth == 0)
+        flushCreatedObjects();
+}
+
+// pre-condition: we have the lock, our thread
+void Probe::flushCreatedObjects()
+{
+    Q_ASSERT(thread() == QThread::currentThread());
+    if (m_createdObjects.isEmpty())
+        return;
+
+    IF_DEBUG(cout << "flushing " << m_createdObjects.size() << " created objects" << endl;
+             )
+
+    // swap out first, receivers might trigger further object creation
+    QVector<QObject *> objects;
+    objects.swap(m_createdObjects);
+    emit objectsCreated(objects);
+}
+
 // pre-condition: we have the lock, arbitrary thread
 void Probe::notifyQueuedObjectChanges()
 {
@@ -887,18 +976,84 @@ bool Probe::eventFilter(QObject *receiver, QEvent *event)
     return QObject::eventFilter(receiver, event);
 }
 
+// walking the entire object tree of a large application at once can block it for
+// seconds, so we only add the roots here and search the rest in time slices
 void Probe::findExistingObjects()
 {
-    discoverObject(QCoreApplication::instance());
+    queueObjectDiscovery(QCoreApplication::instance());
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
     if (auto guiApp = qobject_cast<QGuiApplication *>(QCoreApplication::instance())) {
         foreach (auto window, guiApp->allWindows())
-            discoverObject(window);
+            queueObjectDiscovery(window);
     }
 #endif
 }
 
+// pre-condition: our thread
+void Probe::queueObjectDiscovery(QObject *obj)
+{
+    if (!obj)
+        return;
+
+    QMutexLocker lock(s_lock());
+    if (m_validObjects.contains(obj))
+        return;
+
+    objectAdded(obj);
+    if (!m_validObjects.contains(obj)) // filtered
+        return;
+
+    ++m_discoveredObjectCount;
+    m_discoveryQueue.push_back(obj);
+    if (!m_discoveryTimer->isActive())
+        m_discoveryTimer->start();
+    m_probeController->setObjectDiscoveryActive(true);
+    m_probeController->setDiscoveredObjectCount(m_discoveredObjectCount);
+}
+
+void Probe::processObjectDiscovery()
+{
+    // budget per event loop iteration, keeps the host application responsive
+    static const qint64 timeSlice = 10; // ms
+
+    QMutexLocker lock(s_lock());
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    beginObjectCreationBatch();
+    while (!m_discoveryQueue.isEmpty() && timer.elapsed() < timeSlice) {
+        QObject *obj = m_discoveryQueue.takeLast();
+        if (!m_validObjects.contains(obj)) // destroyed meanwhile
+            continue;
+
+        foreach (QObject *child, obj->children()) {
+            if (m_validObjects.contains(child))
+                continue;
+            objectAdded(child);
+            if (!m_validObjects.contains(child)) // filtered, so are all its children
+                continue;
+            ++m_discoveredObjectCount;
+            m_discoveryQueue.push_back(child);
+        }
+    }
+    endObjectCreationBatch();
+
+    IF_DEBUG(cout << "discovered " << m_discoveredObjectCount << " objects, "
+                  << m_discoveryQueue.size() << " pending" << endl;
+             )
+
+    m_probeController->setDiscoveredObjectCount(m_discoveredObjectCount);
+    if (m_discoveryQueue.isEmpty()) {
+        m_discoveryQueue.squeeze();
+        m_probeController->setObjectDiscoveryActive(false);
+    } else {
+        m_discoveryTimer->start();
+    }
+}
+
 void Probe::discoverObject(QObject *obj)
 {
     if (!obj)
@@ -908,9 +1063,15 @@ void Probe::discoverObject(QObject *obj)
     if (m_validObjects.contains(obj))
         return;
 
+    // object discovery from event filters can happen in any thread
+    const bool batch = thread() == QThread::currentThread();
+    if (batch)
+        beginObjectCreationBatch();
     objectAdded(obj);
     foreach (QObject *child, obj->children())
         discoverObject(child);
+    if (batch)
+        endObjectCreationBatch();
 }
 
 void Probe::installGlobalEventFilter(QObject *filter)
@@ -973,6 +1134,14 @@ void Probe::registerSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks)
     setupSignalSpyCallbacks();
 }
 
+void Probe::registerObjectLifetimeCallbackSet(const ObjectLifetimeCallbackSet &callbacks)
+{
+    if (callbacks.isNull())
+        return;
+    QMutexLocker lock(s_lock());
+    m_objectLifetimeCallbacks.push_back(callbacks);
+}
+
 void Probe::setupSignalSpyCallbacks()
 {
     QSignalSpyCallbackSet cbs = { 0, 0, 0, 0 };
@@ -30,6 +30,7 @@
 #define GAMMARAY_PROBE_H
 
 #include "gammaray_core_export.h"
+#include "objectlifetimecallbackset.h"
 #include "probeinterface.h"
 #include "signalspycallbackset.h"
 
@@ -48,9 +49,11 @@ class QMutex;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class CreationStackTracker;
 class ProbeCreator;
 class ObjectListModel;
 class ObjectTreeModel;
+class ProbeController;
 class MainWindow;
 class BenchSuite;
 class Server;
@@ -86,6 +89,7 @@ public:
                       const QPoint &pos = QPoint()) Q_DECL_OVERRIDE;
     void selectObject(void *object, const QString &typeName) Q_DECL_OVERRIDE;
     void registerSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks) Q_DECL_OVERRIDE;
+    void registerObjectLifetimeCallbackSet(const ObjectLifetimeCallbackSet &callbacks) Q_DECL_OVERRIDE;
 
     QObject *window() const;
     void setWindow(QObject *window);
@@ -107,6 +111,9 @@ public:
 
     bool filterObject(QObject *obj) const Q_DECL_OVERRIDE;
 
+    /// internal, see ObjectDataProvider::creationLocation()
+    CreationStackTracker *creationStackTracker() const;
+
     /// internal
     static void startupHookReceived();
     template<typename Func> static void executeSignalCallback(const Func &func);
@@ -138,6 +145,23 @@ signals:
      */
     void objectCreated(QObject *obj);
 
+    /**
+     * Emitted for newly created QObjects, in batches.
+     *
+     * This carries the same objects as objectCreated(), but collected over one round of
+     * queued object changes or object discovery. This is meant for consumers like the
+     * object models where per-object processing does not scale.
+     *
+     * Note:
+     * - This signal is always emitted from the thread the probe exists in.
+     * - Pending batches are emitted before any objectDestroyed() or objectReparented()
+     *   signal, so the order of object changes is preserved.
+     * - Objects might have been destroyed again between objectCreated() and this signal
+     *   being emitted, check with isValidObject() before accessing them.
+     * - The objectLock() is locked.
+     */
+    void objectsCreated(const QVector<QObject *> &objects);
+
     /**
      * Emitted for destroyed objects.
      *
@@ -157,6 +181,7 @@ protected:
 
 private slots:
     void delayedInit();
+    void processObjectDiscovery();
     void processQueuedObjectChanges();
     void handleObjectDestroyed(QObject *obj);
     void objectParentChanged();
@@ -179,7 +204,12 @@ private:
     void purgeChangesForObject(QObject *obj);
     void notifyQueuedObjectChanges();
 
+    void beginObjectCreationBatch();
+    void endObjectCreationBatch();
+    void flushCreatedObjects();
+
     void findExistingObjects();
+    void queueObjectDiscovery(QObject *obj);
 
     /** Check if we are capable of showing widgets. */
     static bool canShowWidgets();
@@ -210,11 +240,23 @@ private:
     };
     QVector<ObjectChange> m_queuedObjectChanges;
 
+    // objects announced via objectCreated but not yet via objectsCreated
+    QVector<QObject *> m_createdObjects;
+    int m_objectCreationBatchDepth;
+
     QList<QObject *> m_pendingReparents;
     QTimer *m_queueTimer;
+
+    // known objects whose children still need to be searched for pre-existing objects
+    QVector<QObject *> m_discoveryQueue;
+    QTimer *m_discoveryTimer;
+    int m_discoveredObjectCount;
+    ProbeController *m_probeController;
     QVector<QObject *> m_globalEventFilters;
     QVector<SignalSpyCallbackSet> m_signalSpyCallbacks;
     SignalSpyCallbackSet m_previousSignalSpyCallbackSet;
+    QVector<ObjectLifetimeCallbackSet> m_objectLifetimeCallbacks;
+    CreationStackTracker *m_creationStackTracker;
     Server *m_server;
 };
 }
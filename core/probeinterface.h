@@ -47,6 +47,7 @@ class QString;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+struct ObjectLifetimeCallbackSet;
 struct SignalSpyCallbackSet;
 
 /**
@@ -158,6 +159,16 @@ public:
      */
     virtual void registerSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks) = 0;
 
+    /**
+     * Register callbacks for the construction and destruction of all QObjects.
+     * Objects filtered by filterObject() are not reported. Since filtering can depend on the
+     * parent, this is only decided once an object is fully constructed, objects reported as
+     * created and filtered out then are reported as destroyed at that point.
+     *
+     * @since 2.6
+     */
+    virtual void registerObjectLifetimeCallbackSet(const ObjectLifetimeCallbackSet &callbacks) = 0;
+
 private:
     Q_DISABLE_COPY(ProbeInterface)
 };
@@ -31,10 +31,13 @@
 
 #include "common/message.h"
 #include "common/paths.h"
+#include "common/probesettingsfile.h"
 
 #include <QCoreApplication>
+#include <QDataStream>
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
 #include <QLocalSocket>
 #include <QMutex>
 #include <QUrl>
@@ -49,36 +52,84 @@ class ProbeSettingsReceiver;
 struct ProbeSettingsData
 {
     QHash<QByteArray, QByteArray> settings;
+    QMutex mutex; // settings are updated from the receiver thread
+    QWaitCondition waitCondition; // signaled once the socket has delivered settings, or failed
+    bool socketDone;
     ProbeSettingsReceiver *receiver;
 };
 
 Q_GLOBAL_STATIC(ProbeSettingsData, s_probeSettings)
 
+static void setRootPathFromProbePath(const QString &probePath)
+{
+    if (probePath.isEmpty())
+        return;
+
+    QFileInfo fi(probePath);
+    if (fi.isFile())
+        Paths::setRootPath(fi.absolutePath() + QDir::separator() + GAMMARAY_INVERSE_PROBE_DIR);
+    else
+        Paths::setRootPath(probePath + QDir::separator() + GAMMARAY_INVERSE_PROBE_DIR);
+}
+
+// settings file written by the launcher before injecting us, see Launcher::writeProbeSettingsFile
+static bool readSettingsFile()
+{
+    const QString path = ProbeSettingsFile::path(ProbeSettings::launcherIdentifier());
+    QByteArray data;
+    if (path.isEmpty() || !ProbeSettingsFile::read(path, &data))
+        return false;
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_4_8);
+    qint32 version;
+    stream >> version;
+    if (version != Protocol::version()) {
+        qWarning() << "Ignoring probe settings file with mismatching protocol version (expected:"
+                   << Protocol::version() << "got:" << version << ")";
+        return false;
+    }
+
+    QHash<QByteArray, QByteArray> settings;
+    stream >> settings;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    QMutexLocker lock(&s_probeSettings()->mutex);
+    s_probeSettings()->settings = settings;
+    return true;
+}
+
+/** Talks to the launcher via a local socket in a separate thread. This is used for
+ *  sending the server address back, and for settings that could not be passed via
+ *  the environment or settings file.
+ */
 class ProbeSettingsReceiver : public QObject
 {
     Q_OBJECT
 public:
-    explicit ProbeSettingsReceiver(QObject *parent = Q_NULLPTR);
+    explicit ProbeSettingsReceiver(bool haveSettings, QObject *parent = Q_NULLPTR);
     ~ProbeSettingsReceiver();
+    Q_INVOKABLE void run();
     Q_INVOKABLE void sendServerAddress(const QUrl &address);
 
-    void waitForSettingsReceived();
-
 private slots:
+    void connected();
     void readyRead();
-    void settingsReceivedFallback();
+    void connectionFailed();
 
 private:
-    Q_INVOKABLE void run();
-    void setRootPathFromProbePath(const QString &probePath);
+    void writeServerAddress();
+
     QLocalSocket *m_socket;
-    QWaitCondition m_waitCondition;
-    QMutex m_mutex;
+    QUrl m_serverAddress;
+    bool m_haveSettings;
 };
 
-ProbeSettingsReceiver::ProbeSettingsReceiver(QObject *parent)
+ProbeSettingsReceiver::ProbeSettingsReceiver(bool haveSettings, QObject *parent)
     : QObject(parent)
     , m_socket(Q_NULLPTR)
+    , m_haveSettings(haveSettings)
 {
 }
 
@@ -89,29 +140,31 @@ ProbeSettingsReceiver::~ProbeSettingsReceiver()
 
 void ProbeSettingsReceiver::run()
 {
-    m_mutex.lock(); // we only need this for ordering run after waitForSettingsReceived
-    m_mutex.unlock();
-
     m_socket = new QLocalSocket;
-    connect(m_socket, SIGNAL(disconnected()), this, SLOT(settingsReceivedFallback()));
+    connect(m_socket, SIGNAL(connected()), this, SLOT(connected()));
     connect(m_socket, SIGNAL(error(QLocalSocket::LocalSocketError)), this,
-            SLOT(settingsReceivedFallback()));
+            SLOT(connectionFailed()));
     connect(m_socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
     m_socket->connectToServer(QStringLiteral("gammaray-")
                               + QString::number(ProbeSettings::launcherIdentifier()));
-    if (!m_socket->waitForConnected(10000)) {
+}
+
+void ProbeSettingsReceiver::connected()
+{
+    if (!m_serverAddress.isEmpty())
+        writeServerAddress();
+}
+
+void ProbeSettingsReceiver::connectionFailed()
+{
+    if (!m_haveSettings) {
         qWarning() << "Failed to connect to launcher, can't receive probe settings!"
                    << m_socket->errorString();
-        settingsReceivedFallback();
     }
-}
 
-void ProbeSettingsReceiver::waitForSettingsReceived()
-{
-    m_mutex.lock();
-    QMetaObject::invokeMethod(this, "run", Qt::QueuedConnection);
-    m_waitCondition.wait(&m_mutex);
-    m_mutex.unlock();
+    QMutexLocker lock(&s_probeSettings()->mutex);
+    s_probeSettings()->socketDone = true;
+    s_probeSettings()->waitCondition.wakeAll();
 }
 
 void ProbeSettingsReceiver::readyRead()
@@ -129,20 +182,30 @@ void ProbeSettingsReceiver::readyRead()
                         "Unable to receive probe settings, mismatching protocol versions (expected:"
                         << Protocol::version() << "got:" << version << ")";
                 qWarning() << "Continuing anyway, but this is likely going to fail.";
-                settingsReceivedFallback();
                 return;
             }
             break;
         }
         case Protocol::ProbeSettings:
         {
-            msg >> s_probeSettings()->settings;
-            // qDebug() << Q_FUNC_INFO << s_probeSettings()->settings;
-            const QString probePath = ProbeSettings::value(QStringLiteral("ProbePath")).toString();
-            setRootPathFromProbePath(probePath);
-
-            m_waitCondition.wakeAll();
-            return;
+            if (m_haveSettings) // same content as what we got from the settings file
+                break;
+
+            // late settings, only apply what we didn't get from elsewhere yet
+            QHash<QByteArray, QByteArray> settings;
+            msg >> settings;
+            {
+                QMutexLocker lock(&s_probeSettings()->mutex);
+                for (auto it = settings.constBegin(); it != settings.constEnd(); ++it) {
+                    if (!s_probeSettings()->settings.contains(it.key()))
+                        s_probeSettings()->settings.insert(it.key(), it.value());
+                }
+                s_probeSettings()->socketDone = true;
+                s_probeSettings()->waitCondition.wakeAll();
+            }
+            m_haveSettings = true;
+            setRootPathFromProbePath(ProbeSettings::value(QStringLiteral("ProbePath")).toString());
+            break;
         }
         default:
             continue;
@@ -152,11 +215,16 @@ void ProbeSettingsReceiver::readyRead()
 
 void ProbeSettingsReceiver::sendServerAddress(const QUrl &address)
 {
-    if (!m_socket || m_socket->state() != QLocalSocket::ConnectedState)
-        return;
+    m_serverAddress = address;
+    // otherwise this is done once we are connected
+    if (m_socket && m_socket->state() == QLocalSocket::ConnectedState)
+        writeServerAddress();
+}
 
+void ProbeSettingsReceiver::writeServerAddress()
+{
     Message msg(Protocol::LauncherAddress, Protocol::ServerAddress);
-    msg << address;
+    msg << m_serverAddress;
     msg.write(m_socket);
 
     m_socket->waitForBytesWritten();
@@ -166,32 +234,15 @@ void ProbeSettingsReceiver::sendServerAddress(const QUrl &address)
     s_probeSettings()->receiver = Q_NULLPTR;
     thread()->quit();
 }
-
-void ProbeSettingsReceiver::settingsReceivedFallback()
-{
-    // see if we got fallback data via environment variables
-    const QString probePath = ProbeSettings::value(QStringLiteral("ProbePath")).toString();
-    setRootPathFromProbePath(probePath);
-
-    m_waitCondition.wakeAll();
-}
-
-void ProbeSettingsReceiver::setRootPathFromProbePath(const QString &probePath)
-{
-    if (probePath.isEmpty())
-        return;
-
-    QFileInfo fi(probePath);
-    if (fi.isFile())
-        Paths::setRootPath(fi.absolutePath() + QDir::separator() + GAMMARAY_INVERSE_PROBE_DIR);
-    else
-        Paths::setRootPath(probePath + QDir::separator() + GAMMARAY_INVERSE_PROBE_DIR);
-}
 }
 
 QVariant ProbeSettings::value(const QString &key, const QVariant &defaultValue)
 {
-    QByteArray v = s_probeSettings()->settings.value(key.toUtf8());
+    QByteArray v;
+    {
+        QMutexLocker lock(&s_probeSettings()->mutex);
+        v = s_probeSettings()->settings.value(key.toUtf8());
+    }
     if (v.isEmpty())
         v = qgetenv("GAMMARAY_" + key.toLocal8Bit());
     if (v.isEmpty())
@@ -211,13 +262,36 @@ QVariant ProbeSettings::value(const QString &key, const QVariant &defaultValue)
 
 void ProbeSettings::receiveSettings()
 {
+    // settings are available either from the environment (when launched), or from the
+    // file the launcher wrote before injecting us (when attaching), neither needs waiting
+    // for the launcher, unlike the socket connection
+    const bool haveSettingsFile = readSettingsFile();
+    const bool haveSettings = haveSettingsFile || !qgetenv("GAMMARAY_ProbePath").isEmpty();
+    setRootPathFromProbePath(value(QStringLiteral("ProbePath")).toString());
+
     auto t = new QThread;
     QObject::connect(t, SIGNAL(finished()), t, SLOT(deleteLater()));
     t->start();
-    auto receiver = new ProbeSettingsReceiver;
+    auto receiver = new ProbeSettingsReceiver(haveSettings);
     s_probeSettings()->receiver = receiver;
+    s_probeSettings()->socketDone = false;
     receiver->moveToThread(t);
-    receiver->waitForSettingsReceived();
+    QMetaObject::invokeMethod(receiver, "run", Qt::QueuedConnection);
+
+    if (haveSettings)
+        return;
+
+    // no settings file (e.g. a different temporary directory in the target) and not launched
+    // by us either, so the socket is the only source and the probe path is needed right away
+    // for finding plugins. The launcher runs on the same machine and answers right away, if it
+    // doesn't within a few hundred ms it is most likely gone, and blocking the host application
+    // any longer doesn't help. Settings arriving later are still applied by the receiver.
+    {
+        QMutexLocker lock(&s_probeSettings()->mutex);
+        if (!s_probeSettings()->socketDone)
+            s_probeSettings()->waitCondition.wait(&s_probeSettings()->mutex, 300);
+    }
+    setRootPathFromProbePath(value(QStringLiteral("ProbePath")).toString());
 }
 
 qint64 ProbeSettings::launcherIdentifier()
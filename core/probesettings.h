@@ -42,8 +42,9 @@ namespace GammaRay {
 namespace ProbeSettings {
 GAMMARAY_CORE_EXPORT QVariant value(const QString &key, const QVariant &defaultValue = QString());
 
-/** Call if using runtime attaching to obtain settings provided via shared memory.
- *  This method blocks until communication with the launcher is complete.
+/** Call if using runtime attaching to obtain settings provided by the launcher.
+ *  Settings that are only available via the launcher connection are applied asynchronously
+ *  once they arrive. Only if there are no settings at all, this waits up to 300 ms for them.
  */
 void receiveSettings();
 
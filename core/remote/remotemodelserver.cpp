@@ -38,8 +38,13 @@
 #include <QDataStream>
 #include <QDebug>
 #include <QBuffer>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QIcon>
+#include <QImage>
+#include <QPixmap>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace GammaRay;
@@ -47,14 +52,30 @@ using namespace std;
 
 void(*RemoteModelServer::s_registerServerCallback)() = 0;
 
+namespace {
+/** Cached result of RemoteModelServer::canSerialize for a given metatype. */
+enum SerializationCheck {
+    Serializable,
+    NotSerializable,
+    SerializableContainer // container type itself is fine, but the elements need to be checked
+};
+}
+
+typedef QHash<int, SerializationCheck> SerializationCheckCache;
+Q_GLOBAL_STATIC(SerializationCheckCache, s_serializationChecks)
+
 RemoteModelServer::RemoteModelServer(const QString &objectName, QObject *parent)
     : QObject(parent)
     , m_model(0)
     , m_dummyBuffer(new QBuffer(&m_dummyData, this))
     , m_monitored(false)
+    , m_nextIconId(1)
+    , m_iconUseCounter(0)
 {
     setObjectName(objectName);
     m_dummyBuffer->open(QIODevice::WriteOnly);
+    m_lazyRoles << Qt::ToolTipRole << Qt::StatusTipRole << Qt::WhatsThisRole;
+    std::sort(m_lazyRoles.begin(), m_lazyRoles.end());
     registerServer();
 }
 
@@ -162,17 +183,25 @@ void RemoteModelServer::disconnectModel()
     disconnect(m_model, SIGNAL(destroyed(QObject*)), this, SLOT(modelDeleted()));
 }
 
+static quint32 elapsedMicroseconds(const QElapsedTimer &timer)
+{
+    return timer.nsecsElapsed() / 1000;
+}
+
 void RemoteModelServer::newRequest(const GammaRay::Message &msg)
 {
     if (!m_model && msg.type() != Protocol::ModelSyncBarrier)
         return;
 
     ProbeGuard g;
+    QElapsedTimer timer;
+    timer.start();
     switch (msg.type()) {
     case Protocol::ModelRowColumnCountRequest:
     {
+        quint32 requestId;
         Protocol::ModelIndex index;
-        msg >> index;
+        msg >> requestId >> index;
         const QModelIndex qmIndex = Protocol::toQModelIndex(m_model, index);
 
         qint32 rowCount = -1, columnCount = -1;
@@ -182,36 +211,58 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
         }
 
         Message msg(m_myAddress, Protocol::ModelRowColumnCountReply);
-        msg << index << rowCount << columnCount;
+        msg << requestId << elapsedMicroseconds(timer) << index << rowCount << columnCount;
+        if (index.isEmpty()) // role negotiation, this is the first request of every client
+            msg << m_lazyRoles;
         sendMessage(msg);
         break;
     }
 
     case Protocol::ModelContentRequest:
     {
-        quint32 size;
-        msg >> size;
-        Q_ASSERT(size > 0);
-
-        QVector<QModelIndex> indexes;
-        indexes.reserve(size);
-        for (quint32 i = 0; i < size; ++i) {
-            Protocol::ModelIndex index;
-            msg >> index;
-            const QModelIndex qmIndex = Protocol::toQModelIndex(m_model, index);
-            if (!qmIndex.isValid())
-                continue;
-            indexes.push_back(qmIndex);
+        // a list of blocks of cells below a common parent, each requested with a single index path
+        quint32 requestId, rangeCount;
+        msg >> requestId >> rangeCount;
+        Q_ASSERT(rangeCount > 0);
+
+        // icons are replaced by ids while filtering, so we need to know all new ones
+        // before we can write the reply
+        const auto firstIconUse = m_iconUseCounter + 1;
+        QVector<ContentRange> ranges;
+        ranges.reserve(rangeCount);
+        for (quint32 i = 0; i < rangeCount; ++i) {
+            ContentRange range;
+            msg >> range.parent >> range.firstRow >> range.lastRow >> range.firstColumn
+            >> range.lastColumn >> range.roles >> range.mergeRoles;
+            if (fetchContentRange(range))
+                ranges.push_back(range);
         }
-        if (indexes.isEmpty())
+        if (ranges.isEmpty())
             break;
+        evictIcons(firstIconUse);
 
+        // serialization is not included in the processing time
         Message msg(m_myAddress, Protocol::ModelContentReply);
-        msg << quint32(indexes.size());
-        foreach (const auto &qmIndex, indexes)
-            msg << Protocol::fromQModelIndex(qmIndex)
-                          << filterItemData(m_model->itemData(qmIndex))
-                          << qint32(m_model->flags(qmIndex));
+        msg << requestId << elapsedMicroseconds(timer);
+        msg << quint32(m_pendingIcons.size());
+        foreach (const auto &icon, m_pendingIcons)
+            msg << icon.first << icon.second;
+        m_pendingIcons.clear();
+        msg << m_removedIcons;
+        m_removedIcons.clear();
+
+        // columnar layout: range header, then flags and cell data column by column
+        msg << quint32(ranges.size());
+        foreach (const auto &range, ranges) {
+            msg << range.parent << range.firstRow << range.lastRow << range.firstColumn
+                << range.lastColumn << range.roles << range.mergeRoles;
+            const int rows = range.lastRow - range.firstRow + 1;
+            for (int column = 0; column <= range.lastColumn - range.firstColumn; ++column) {
+                msg << range.flags.mid(column * rows, rows);
+                for (int row = 0; row < rows; ++row)
+                    msg << range.itemData.at(column * rows + row) << range.iconIds.at(column * rows + row);
+            }
+        }
 
         sendMessage(msg);
         break;
@@ -219,9 +270,10 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
 
     case Protocol::ModelHeaderRequest:
     {
+        quint32 requestId;
         qint8 orientation;
         qint32 section;
-        msg >> orientation >> section;
+        msg >> requestId >> orientation >> section;
         Q_ASSERT(orientation == Qt::Horizontal || orientation == Qt::Vertical);
         Q_ASSERT(section >= 0);
 
@@ -235,7 +287,7 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
                                         Qt::ToolTipRole));
 
         Message msg(m_myAddress, Protocol::ModelHeaderReply);
-        msg << orientation << section << data;
+        msg << requestId << elapsedMicroseconds(timer) << orientation << section << data;
         sendMessage(msg);
         break;
     }
@@ -271,7 +323,62 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
     }
 }
 
-QMap<int, QVariant> RemoteModelServer::filterItemData(const QMap< int, QVariant > &data) const
+void RemoteModelServer::setLazyRoles(const QVector<int> &roles)
+{
+    m_lazyRoles.clear();
+    foreach (auto role, roles)
+        m_lazyRoles.push_back(role);
+    std::sort(m_lazyRoles.begin(), m_lazyRoles.end());
+}
+
+bool RemoteModelServer::fetchContentRange(RemoteModelServer::ContentRange &range)
+{
+    const QModelIndex qmParent = Protocol::toQModelIndex(m_model, range.parent);
+    if (!range.parent.isEmpty() && !qmParent.isValid())
+        return false;
+
+    // the client might not have processed all structure changes yet
+    range.lastRow = std::min(range.lastRow, m_model->rowCount(qmParent) - 1);
+    range.lastColumn = std::min(range.lastColumn, m_model->columnCount(qmParent) - 1);
+    if (range.firstRow < 0 || range.firstColumn < 0 || range.firstRow > range.lastRow
+        || range.firstColumn > range.lastColumn)
+        return false;
+
+    const int cellCount = (range.lastRow - range.firstRow + 1)
+                          * (range.lastColumn - range.firstColumn + 1);
+    range.itemData.resize(cellCount);
+    range.iconIds.resize(cellCount);
+    range.flags.resize(cellCount);
+    int cell = 0;
+    for (int column = range.firstColumn; column <= range.lastColumn; ++column) {
+        for (int row = range.firstRow; row <= range.lastRow; ++row, ++cell) {
+            const QModelIndex qmIndex = m_model->index(row, column, qmParent);
+            range.itemData[cell] = filterItemData(itemData(qmIndex, range.roles), &range.iconIds[cell]);
+            range.flags[cell] = qint32(m_model->flags(qmIndex));
+        }
+    }
+    return true;
+}
+
+QMap<int, QVariant> RemoteModelServer::itemData(const QModelIndex &index,
+                                                const QVector<qint32> &roles) const
+{
+    if (roles.isEmpty()) {
+        auto data = m_model->itemData(index);
+        foreach (auto role, m_lazyRoles)
+            data.remove(role);
+        return data;
+    }
+
+    // only compute what the client actually uses, itemData() evaluates everything
+    QMap<int, QVariant> data;
+    foreach (auto role, roles)
+        data.insert(role, m_model->data(index, role));
+    return data;
+}
+
+QMap<int, QVariant> RemoteModelServer::filterItemData(const QMap< int, QVariant > &data,
+                                                      QHash<qint32, quint32> *iconIds)
 {
     QMap<int, QVariant> itemData(data);
     for (QMap<int, QVariant>::iterator it = itemData.begin(); it != itemData.end();) {
@@ -280,10 +387,9 @@ QMap<int, QVariant> RemoteModelServer::filterItemData(const QMap< int, QVariant
         } else if (it.value().userType() == qMetaTypeId<QIcon>()) {
             // see also: https://bugreports.qt-project.org/browse/QTBUG-33321
             const QIcon icon = it.value().value<QIcon>();
-            ///TODO: what size to use? icon.availableSizes is empty...
             if (!icon.isNull())
-                it.value() = icon.pixmap(QSize(16, 16));
-            ++it;
+                iconIds->insert(it.key(), iconId(icon));
+            it = itemData.erase(it);
         } else if (canSerialize(it.value())) {
             ++it;
         } else {
@@ -294,35 +400,160 @@ QMap<int, QVariant> RemoteModelServer::filterItemData(const QMap< int, QVariant
     return itemData;
 }
 
+quint32 RemoteModelServer::iconId(const QIcon &icon)
+{
+    const auto keyIt = m_iconKeys.find(icon.cacheKey());
+    if (keyIt != m_iconKeys.end()) {
+        keyIt.value().lastUse = ++m_iconUseCounter;
+        return keyIt.value().id;
+    }
+
+    // models creating a new QIcon instance on every data() call defeat the cache key lookup,
+    // so deduplicate on the rasterized content as well, that bounds the table the client has to hold
+    ///TODO: what size to use? icon.availableSizes is empty...
+    const QPixmap pixmap = icon.pixmap(QSize(16, 16));
+    const QImage img = pixmap.toImage();
+    // only keep a digest of the content around, the pixel data of every icon ever seen adds up
+    const QByteArray digest = QCryptographicHash::hash(
+        QByteArray::fromRawData(reinterpret_cast<const char *>(img.constBits()), img.byteCount()),
+        QCryptographicHash::Md5);
+    auto contentIt = m_iconContents.find(digest);
+    if (contentIt == m_iconContents.end()) {
+        IconContentInfo content;
+        content.id = m_nextIconId++;
+        content.keyCount = 0;
+        contentIt = m_iconContents.insert(digest, content);
+        m_pendingIcons.push_back(qMakePair(content.id, pixmap));
+    }
+    ++contentIt.value().keyCount;
+
+    IconKeyInfo key;
+    key.id = contentIt.value().id;
+    key.lastUse = ++m_iconUseCounter;
+    key.digest = digest;
+    m_iconKeys.insert(icon.cacheKey(), key);
+    return key.id;
+}
+
+void RemoteModelServer::evictIcons(quint64 firstUse)
+{
+    // don't grow unbounded with short-lived icons, evict down to 3/4 of the limit,
+    // so we don't have to do this on every request
+    static const int maximumIconKeys = 1024;
+    if (m_iconKeys.size() <= maximumIconKeys)
+        return;
+
+    QVector<quint64> uses;
+    uses.reserve(m_iconKeys.size());
+    foreach (const auto &key, m_iconKeys)
+        uses.push_back(key.lastUse);
+    const auto cutOff = uses.begin() + (m_iconKeys.size() - maximumIconKeys * 3 / 4);
+    std::nth_element(uses.begin(), cutOff, uses.end());
+    const auto lastEvictedUse = std::min(*cutOff, firstUse);
+
+    for (auto it = m_iconKeys.begin(); it != m_iconKeys.end();) {
+        if (it.value().lastUse >= lastEvictedUse) {
+            ++it;
+            continue;
+        }
+        const auto contentIt = m_iconContents.find(it.value().digest);
+        Q_ASSERT(contentIt != m_iconContents.end());
+        if (--contentIt.value().keyCount == 0) {
+            m_removedIcons.push_back(contentIt.value().id);
+            m_iconContents.erase(contentIt);
+        }
+        it = m_iconKeys.erase(it);
+    }
+}
+
+void RemoteModelServer::clearIconTable()
+{
+    m_iconKeys.clear();
+    m_iconContents.clear();
+    m_pendingIcons.clear();
+    m_removedIcons.clear();
+    m_nextIconId = 1;
+}
+
 bool RemoteModelServer::canSerialize(const QVariant &value) const
 {
+    const auto it = s_serializationChecks()->constFind(value.userType());
+    if (it != s_serializationChecks()->constEnd()) {
+        switch (it.value()) {
+        case Serializable:
+            return true;
+        case NotSerializable:
+            return false;
+        case SerializableContainer:
+            return canSerializeElements(value);
+        }
+    }
+
     if (qstrcmp(value.typeName(), "QJSValue") == 0) {
         // QJSValue tries to serialize nested elements and asserts if that fails
         // too bad it can contain QObject* as nested element, which obviously can't be serialized...
+        s_serializationChecks()->insert(value.userType(), NotSerializable);
         return false;
     }
 
-    // recurse into containers
+    // check the elements before trying the container, serializing a container with
+    // non-serializable content might assert
+    const bool isContainer = isSequentialContainer(value) || isAssociativeContainer(value);
+    if (isContainer && !canSerializeElements(value))
+        return false; // depends on the content, so we can't cache anything for the container type
+
+    // ugly, but there doesn't seem to be a better way atm to find out without trying
+    // we do this only once per type though, the result only depends on registered stream operators
+    m_dummyBuffer->seek(0);
+    QDataStream stream(m_dummyBuffer);
+    const bool result = QMetaType::save(stream, value.userType(), value.constData());
+    if (!result)
+        s_serializationChecks()->insert(value.userType(), NotSerializable);
+    else
+        s_serializationChecks()->insert(value.userType(), isContainer ? SerializableContainer : Serializable);
+    return result;
+}
+
+bool RemoteModelServer::canSerializeElements(const QVariant &value) const
+{
 #if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
-    if (value.canConvert<QVariantList>()) {
+    if (isSequentialContainer(value)) {
         QSequentialIterable it = value.value<QSequentialIterable>();
         foreach (const QVariant &v, it) {
             if (!canSerialize(v))
                 return false;
         }
-    } else if (value.canConvert<QVariantMap>()) {
+    } else if (isAssociativeContainer(value)) {
         auto iterable = value.value<QAssociativeIterable>();
         for (auto it = iterable.begin(); it != iterable.end(); ++it) {
             if (!canSerialize(it.value()))
                 return false;
         }
     }
+#else
+    Q_UNUSED(value);
 #endif
+    return true;
+}
 
-    // ugly, but there doesn't seem to be a better way atm to find out without trying
-    m_dummyBuffer->seek(0);
-    QDataStream stream(m_dummyBuffer);
-    return QMetaType::save(stream, value.userType(), value.constData());
+bool RemoteModelServer::isSequentialContainer(const QVariant &value)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    return value.canConvert<QVariantList>();
+#else
+    Q_UNUSED(value);
+    return false;
+#endif
+}
+
+bool RemoteModelServer::isAssociativeContainer(const QVariant &value)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    return !value.canConvert<QVariantList>() && value.canConvert<QVariantMap>();
+#else
+    Q_UNUSED(value);
+    return false;
+#endif
 }
 
 void RemoteModelServer::modelMonitored(bool monitored)
@@ -330,6 +561,8 @@ void RemoteModelServer::modelMonitored(bool monitored)
     if (m_monitored == monitored)
         return;
     m_monitored = monitored;
+    if (!m_monitored)
+        clearIconTable(); // a new client doesn't know about any of the icons we sent so far
     if (m_model) {
         if (m_monitored)
             connectModel();
@@ -484,7 +717,8 @@ void RemoteModelServer::registerServer()
         return;
     }
     m_myAddress = Server::instance()->registerObject(objectName(), this, Server::ExportProperties);
-    Server::instance()->registerMessageHandler(m_myAddress, this, "newRequest");
+    Server::instance()->registerMessageHandler<RemoteModelServer, &RemoteModelServer::newRequest>(
+        m_myAddress, this);
     Server::instance()->registerMonitorNotifier(m_myAddress, this, "modelMonitored");
     connect(Endpoint::instance(), SIGNAL(disconnected()), this, SLOT(modelMonitored()));
 }
@@ -31,13 +31,16 @@
 
 #include <common/protocol.h>
 
+#include <QHash>
 #include <QObject>
+#include <QPixmap>
 #include <QPointer>
 #include <QRegExp>
 
 QT_BEGIN_NAMESPACE
 class QBuffer;
 class QAbstractItemModel;
+class QIcon;
 QT_END_NAMESPACE
 
 namespace GammaRay {
@@ -65,6 +68,12 @@ public:
     QAbstractItemModel *model() const;
     /** Set the source model for this model server instance. */
     void setModel(QAbstractItemModel *model);
+    /** Roles of the source model that are only sent when the client explicitly asks for them,
+     *  rather than with every content request. Only use this for roles that are expensive to
+     *  compute and never read synchronously by client code, such as tool tips (the default).
+     *  This has to be set before the client connects.
+     */
+    void setLazyRoles(const QVector<int> &roles);
 
 public slots:
     void newRequest(const GammaRay::Message &msg);
@@ -81,11 +90,49 @@ private:
     void sendMoveMessage(Protocol::MessageType type, const Protocol::ModelIndex &sourceParent,
                          int sourceStart, int sourceEnd,
                          const Protocol::ModelIndex &destinationParent, int destinationIndex);
-    QMap< int, QVariant > filterItemData(const QMap< int, QVariant > &data) const;
+    /** A block of cells below a common parent, as requested by ModelContentRequest.
+     *  Cell content is stored column by column.
+     */
+    struct ContentRange {
+        Protocol::ModelIndex parent;
+        qint32 firstRow;
+        qint32 lastRow;
+        qint32 firstColumn;
+        qint32 lastColumn;
+        QVector<qint32> roles; // empty for all roles
+        bool mergeRoles; // passed through to the client
+        QVector<QMap<int, QVariant> > itemData;
+        QVector<QHash<qint32, quint32> > iconIds;
+        QVector<qint32> flags;
+    };
+    /** Clamps @p range to the current model dimensions and fills in its content.
+     *  Returns @c false if nothing of @p range exists anymore.
+     */
+    bool fetchContentRange(ContentRange &range);
+    /** Returns the data for @p roles of @p index, or all but the lazy roles if @p roles is empty. */
+    QMap<int, QVariant> itemData(const QModelIndex &index, const QVector<qint32> &roles) const;
+    /** Strips everything we cannot transfer from @p data.
+     *  Icons are moved out into @p iconIds as role -> icon table id.
+     */
+    QMap< int, QVariant > filterItemData(const QMap< int, QVariant > &data,
+                                         QHash<qint32, quint32> *iconIds);
+    /** Returns the icon table id for @p icon, registering it as pending for transfer if new. */
+    quint32 iconId(const QIcon &icon);
+    /** Drops the least recently used icons if the icon table exceeds its size limit.
+     *  Icons used since @p firstUse are kept, as the pending reply refers to them.
+     */
+    void evictIcons(quint64 firstUse);
+    void clearIconTable();
     void sendLayoutChanged(
         const QVector<Protocol::ModelIndex> &parents = QVector<Protocol::ModelIndex>(),
         quint32 hint = 0);
+    /** Checks whether @p value can be serialized.
+     *  The result is cached per metatype, only container content is checked per value.
+     */
     bool canSerialize(const QVariant &value) const;
+    bool canSerializeElements(const QVariant &value) const;
+    static bool isSequentialContainer(const QVariant &value);
+    static bool isAssociativeContainer(const QVariant &value);
 
     // proxy model settings
     bool proxyDynamicSortFilter() const;
@@ -131,10 +178,29 @@ private slots:
 
 private:
     QPointer<QAbstractItemModel> m_model;
-    // those two are used for canSerialize, since recreating the QBuffer is somewhat expensive,
-    // especially since being a QObject triggers all kind of GammaRay internals
+    // those two are used for canSerialize on the first encounter of a type, since recreating the
+    // QBuffer is somewhat expensive, especially since being a QObject triggers all kind of GammaRay internals
     QByteArray m_dummyData;
     QBuffer *m_dummyBuffer;
+    // icon table, icons are only transferred once per client and referred to by id afterwards
+    // both tables are bounded by evicting the least recently used cache keys, and the content
+    // entries no cache key refers to anymore, the client is told to drop those as well
+    struct IconKeyInfo {
+        quint32 id;
+        quint64 lastUse;
+        QByteArray digest;
+    };
+    struct IconContentInfo {
+        quint32 id;
+        int keyCount;
+    };
+    QHash<qint64, IconKeyInfo> m_iconKeys; // QIcon::cacheKey -> icon
+    QHash<QByteArray, IconContentInfo> m_iconContents; // digest of the rasterized image data -> id
+    QVector<QPair<quint32, QPixmap> > m_pendingIcons; // not yet sent to the client
+    QVector<quint32> m_removedIcons; // evicted, but not yet announced to the client
+    quint32 m_nextIconId;
+    quint64 m_iconUseCounter;
+    QVector<qint32> m_lazyRoles; // sorted, announced to the client with the root row/column count
     // converted model indexes from aboutToBeX signals, needed in cases where the operation changes
     // the serialized index (move to sub-tree of source parent for example)
     // as operations can occur nested, we need to have a stack for this
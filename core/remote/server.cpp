@@ -74,14 +74,14 @@ Server::Server(QObject *parent)
     connect(m_broadcastTimer, SIGNAL(timeout()), SLOT(broadcast()));
     connect(this, SIGNAL(disconnected()), m_broadcastTimer, SLOT(start()));
 
-    connect(m_signalMapper, SIGNAL(signalEmitted(QObject*,int,QVector<QVariant>)),
-            this, SLOT(forwardSignal(QObject*,int,QVector<QVariant>)));
+    m_signalMapper->setReceiver(this);
 
     Endpoint::addObjectNameAddressMapping(QStringLiteral(
                                               "com.kdab.GammaRay.PropertySyncer"), ++m_nextAddress);
     m_propertySyncer->setAddress(m_nextAddress);
     Endpoint::registerObject(QStringLiteral("com.kdab.GammaRay.PropertySyncer"), m_propertySyncer);
-    registerMessageHandler(m_nextAddress, m_propertySyncer, "handleMessage");
+    registerMessageHandler<PropertySyncer, &PropertySyncer::handleMessage>(m_nextAddress,
+                                                                          m_propertySyncer);
 }
 
 Server::~Server()
@@ -260,29 +260,50 @@ Protocol::ObjectAddress Server::registerObject(const QString &name, QObject *obj
     return address;
 }
 
-void Server::forwardSignal(QObject *sender, int signalIndex, const QVector< QVariant > &args)
+void Server::signalEmitted(QObject *sender, int signalIndex, const QVector<int> &argumentTypes,
+                           void **args)
 {
     if (!isConnected())
         return;
 
     Q_ASSERT(sender);
     Q_ASSERT(signalIndex >= 0);
-    const QMetaMethod signal = sender->metaObject()->method(signalIndex);
-    Q_ASSERT(signal.methodType() == QMetaMethod::Signal);
 
+    const auto key = qMakePair(sender->metaObject(), signalIndex);
+    auto it = m_signalNames.constFind(key);
+    if (it == m_signalNames.constEnd()) {
+        const QMetaMethod signal = sender->metaObject()->method(signalIndex);
+        Q_ASSERT(signal.methodType() == QMetaMethod::Signal);
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-    QByteArray name = signal.signature();
+        QByteArray name = signal.signature();
 #else
-    QByteArray name = signal.methodSignature();
+        QByteArray name = signal.methodSignature();
 #endif
-    // get the name of the function to invoke, excluding the parens and function arguments.
-    name = name.mid(0, name.indexOf('('));
-
-    QVariantList v;
-    v.reserve(args.size());
-    foreach (const QVariant &arg, args)
-        v.push_back(arg);
-    Endpoint::invokeObject(sender->objectName(), name, v);
+        // get the name of the function to invoke, excluding the parens and function arguments.
+        name = name.mid(0, name.indexOf('('));
+        it = m_signalNames.insert(key, name);
+    }
+
+    quint16 methodId;
+    const auto addr = remoteMethodId(sender->objectName(), it.value(), &methodId);
+    if (addr == Protocol::InvalidObjectAddress)
+        return;
+
+    // serialize the arguments straight into the message, the argument types have been
+    // resolved once by the signal mapper
+    quint8 argCount = 0;
+    foreach (int type, argumentTypes) {
+        if (type != QMetaType::Void)
+            ++argCount;
+    }
+    Message msg(addr, Protocol::MethodCall);
+    msg << methodId << argCount;
+    for (int i = 0; i < argumentTypes.size(); ++i) {
+        if (argumentTypes.at(i) == QMetaType::Void)
+            continue;
+        msg << QVariant(argumentTypes.at(i), args[i + 1]);
+    }
+    send(msg);
 }
 
 void Server::registerMonitorNotifier(Protocol::ObjectAddress address, QObject *receiver,
@@ -31,6 +31,8 @@
 
 #include "gammaray_core_export.h"
 
+#include "multisignalmapper.h"
+
 #include <common/endpoint.h>
 #include <common/objectbroker.h>
 
@@ -41,11 +43,10 @@ class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
-class MultiSignalMapper;
 class ServerDevice;
 
 /** Server side connection endpoint. */
-class GAMMARAY_CORE_EXPORT Server : public Endpoint
+class GAMMARAY_CORE_EXPORT Server : public Endpoint, private MultiSignalMapper::Receiver
 {
     Q_OBJECT
 public:
@@ -114,13 +115,14 @@ private slots:
     void newConnection();
     void broadcast();
 
+private:
+    void sendServerGreeting();
+
     /**
      * Forward the signal that triggered the call to this slot to the remote client if connected.
      */
-    void forwardSignal(QObject *sender, int signalIndex, const QVector<QVariant> &args);
-
-private:
-    void sendServerGreeting();
+    void signalEmitted(QObject *sender, int signalIndex, const QVector<int> &argumentTypes,
+                       void **args) Q_DECL_OVERRIDE;
 
 private:
     ServerDevice *m_serverDevice;
@@ -131,6 +133,7 @@ private:
     QTimer *m_broadcastTimer;
 
     MultiSignalMapper *m_signalMapper;
+    QHash<QPair<const QMetaObject *, int>, QByteArray> m_signalNames;
 };
 }
 
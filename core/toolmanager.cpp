@@ -40,6 +40,7 @@
 #include "tools/resourcebrowser/resourcebrowser.h"
 #include "tools/messagehandler/messagehandler.h"
 #include "tools/metaobjectbrowser/metaobjectbrowser.h"
+#include "tools/stalldetector/stalldetector.h"
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include "tools/standardpaths/standardpaths.h"
 #endif
@@ -62,6 +63,7 @@ ToolManager::ToolManager(QObject *parent)
     addToolFactory(new MetaTypeBrowserFactory(this));
     addToolFactory(new MessageHandlerFactory(this));
     addToolFactory(new LocaleInspectorFactory(this));
+    addToolFactory(new StallDetectorFactory(this));
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
     addToolFactory(new StandardPathsFactory(this));
 #endif
@@ -150,20 +152,29 @@ QVector<QString> ToolManager::toolsForObject(QObject *object) const
     if (!object)
         return QVector<QString>();
 
+    const QVector<ToolFactory *> &tools = selectableTools(object->metaObject());
     QVector<QString> ret;
-    QSet<ToolFactory *> knownTools;
-    const QMetaObject *metaObject = object->metaObject();
-    while (metaObject) {
-        for (int i = 0; i < m_tools.size(); i++) {
-            ToolFactory *factory = m_tools.at(i);
-            if (factory && !factory->isHidden() && factory->selectableTypes().contains(metaObject->className()) && !knownTools.contains(factory)) {
-                knownTools << factory;
-                ret.append(factory->id());
-            }
+    ret.reserve(tools.size());
+    foreach (ToolFactory *factory, tools)
+        ret.push_back(factory->id());
+    return ret;
+}
+
+const QVector<ToolFactory *> &ToolManager::selectableTools(const QMetaObject *mo) const
+{
+    auto it = m_selectableToolsCache.constFind(mo);
+    if (it != m_selectableToolsCache.constEnd())
+        return it.value();
+
+    // tools for this class first, followed by those of the base classes not already covered
+    QVector<ToolFactory *> tools = m_toolsBySelectableType.value(mo->className());
+    if (mo->superClass()) {
+        foreach (ToolFactory *factory, selectableTools(mo->superClass())) {
+            if (!tools.contains(factory))
+                tools.push_back(factory);
         }
-        metaObject = metaObject->superClass();
     }
-    return ret;
+    return m_selectableToolsCache.insert(mo, tools).value();
 }
 
 QVector<QString> ToolManager::toolsForObject(const void *object, const QString &typeName) const
@@ -174,12 +185,8 @@ QVector<QString> ToolManager::toolsForObject(const void *object, const QString &
     QVector<QString> ret;
     const MetaObject *metaObject = MetaObjectRepository::instance()->metaObject(typeName);
     while (metaObject) {
-        for (int i = 0; i < m_tools.size(); i++) {
-            ToolFactory *factory = m_tools.at(i);
-            if (factory && !factory->isHidden()
-                && factory->selectableTypes().contains(metaObject->className().toUtf8()))
-                ret.append(factory->id());
-        }
+        foreach (ToolFactory *factory, m_toolsBySelectableType.value(metaObject->className().toUtf8()))
+            ret.append(factory->id());
         metaObject = metaObject->superClass();
     }
     return ret;
@@ -191,24 +198,28 @@ void ToolManager::objectAdded(QObject *obj)
     Q_ASSERT(Probe::instance()->isValidObject(obj));
 
     // m_knownMetaObjects allows us to skip the expensive recursive search for matching tools
-    if (!m_knownMetaObjects.contains(obj->metaObject())) {
+    if (!m_knownMetaObjects.contains(obj->metaObject()))
         objectAdded(obj->metaObject());
-        m_knownMetaObjects.insert(obj->metaObject());
-    }
 }
 
 void ToolManager::objectAdded(const QMetaObject *mo)
 {
     Q_ASSERT(thread() == QThread::currentThread());
+    if (m_knownMetaObjects.contains(mo))
+        return;
+    m_knownMetaObjects.insert(mo);
+
     // as plugins can depend on each other, start from the base classes
     if (mo->superClass())
         objectAdded(mo->superClass());
-    foreach (ToolFactory *factory, m_disabledTools) {
-        if (factory->supportedTypes().contains(mo->className())) {
-            m_disabledTools.remove(factory);
-            factory->init(Probe::instance());
-            emit toolEnabled(factory->id());
-        }
+    if (m_disabledTools.isEmpty())
+        return;
+    foreach (ToolFactory *factory, m_toolsBySupportedType.value(mo->className())) {
+        if (!m_disabledTools.contains(factory))
+            continue;
+        m_disabledTools.remove(factory);
+        factory->init(Probe::instance());
+        emit toolEnabled(factory->id());
     }
 }
 
@@ -216,6 +227,20 @@ void ToolManager::addToolFactory(ToolFactory *tool)
 {
     m_tools.push_back(tool);
     m_disabledTools.insert(tool);
+
+    foreach (const QByteArray &type, tool->supportedTypes()) {
+        auto &tools = m_toolsBySupportedType[type];
+        if (!tools.contains(tool))
+            tools.push_back(tool);
+    }
+    if (!tool->isHidden()) {
+        foreach (const QByteArray &type, tool->selectableTypes()) {
+            auto &tools = m_toolsBySelectableType[type];
+            if (!tools.contains(tool))
+                tools.push_back(tool);
+        }
+    }
+    m_selectableToolsCache.clear();
 }
 
 ToolPluginManager *ToolManager::toolPluginManager() const
@@ -34,6 +34,9 @@
 #include <common/toolmanagerinterface.h>
 #include <common/pluginmanager.h>
 
+#include <QHash>
+#include <QSet>
+
 namespace GammaRay {
 class ToolFactory;
 class ProxyToolFactory;
@@ -81,10 +84,17 @@ public slots:
 private:
     void addToolFactory(ToolFactory *tool);
     ToolData toolInfoForFactory(ToolFactory *factory) const;
+    /** Selectable tools for @p mo, including those of its base classes, best match first. */
+    const QVector<ToolFactory *> &selectableTools(const QMetaObject *mo) const;
 
     QVector<ToolFactory *> m_tools;
     QSet<ToolFactory *> m_disabledTools;
+    // type name -> tools, as a fast alternative to searching all tools for each type
+    QHash<QByteArray, QVector<ToolFactory *> > m_toolsBySupportedType;
+    QHash<QByteArray, QVector<ToolFactory *> > m_toolsBySelectableType;
+    // meta objects (including base classes) that have been checked for enabling tools already
     QSet<const QMetaObject *> m_knownMetaObjects;
+    mutable QHash<const QMetaObject *, QVector<ToolFactory *> > m_selectableToolsCache;
     QScopedPointer<ToolPluginManager> m_toolPluginManager;
 };
 }
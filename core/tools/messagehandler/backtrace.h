@@ -30,10 +30,86 @@
 #ifndef GAMMARAY_MESSAGEHANDLER_BACKTRACE_H
 #define GAMMARAY_MESSAGEHANDLER_BACKTRACE_H
 
+#include "gammaray_core_export.h"
+
+#include <common/sourcelocation.h>
+
+#include <QByteArray>
+#include <QHash>
 #include <QStringList>
+#include <QVector>
 
 typedef QStringList Backtrace;
 
-Backtrace getBacktrace(int levels = -1);
+GAMMARAY_CORE_EXPORT Backtrace getBacktrace(int levels = -1);
+
+/** Stores up to @p maxFrames raw return addresses of the calling thread in @p frames.
+ *  This is much cheaper than getBacktrace(), use symbolizeBacktrace() to resolve the
+ *  addresses later on. Returns the number of frames stored.
+ */
+GAMMARAY_CORE_EXPORT int captureBacktrace(void **frames, int maxFrames);
+
+/** Resolves addresses obtained by captureBacktrace(). */
+GAMMARAY_CORE_EXPORT Backtrace symbolizeBacktrace(void *const *frames, int count);
+
+namespace GammaRay {
+/** Stores raw stacks obtained by captureBacktrace(), identical stacks only once.
+ *  The table holds at most a fixed number of distinct stacks, to keep memory bounded
+ *  if they are recorded from a huge number of different places. Not thread-safe.
+ */
+class GAMMARAY_CORE_EXPORT BacktraceTable
+{
+public:
+    explicit BacktraceTable(int maxStacks = 16384);
+
+    /** Captures up to @p maxFrames frames of the calling thread and adds them, see insert(). */
+    int capture(int maxFrames = 32);
+    /** Returns the id of the stack of @p count frames, adding it if not known yet.
+     *  Returns -1 if the stack is empty, or if it is new and the table is full.
+     */
+    int insert(void *const *frames, int count);
+
+    /** The raw addresses of stack @p id, for symbolizeBacktrace() or resolveSourceLocations(). */
+    QByteArray stack(int id) const;
+    /** Number of distinct stacks stored, ids range from 0 to size() - 1. */
+    int size() const;
+    /** Drops all stacks, previously returned ids become invalid. */
+    void clear();
+
+private:
+    int m_maxStacks;
+    QHash<QByteArray, int> m_ids;
+    QVector<QByteArray> m_stacks;
+};
+}
+
+/** Returns for each of @p stacks the source location of its first frame outside of Qt and
+ *  GammaRay. A stack holds the raw addresses obtained by captureBacktrace().
+ *  This needs debug information and runs addr2line once per involved module, so it blocks
+ *  for a while. Don't call it from the GUI thread, and cache the results.
+ *  Locations that cannot be determined are invalid.
+ *  @note Not supported on Windows, all locations are invalid there.
+ */
+GAMMARAY_CORE_EXPORT QVector<GammaRay::SourceLocation> resolveSourceLocations(const QVector<QByteArray> &stacks);
+
+/** Platform specific identification of a thread for getThreadBacktrace(). */
+typedef quintptr BacktraceThread;
+
+/** Returns the calling thread for use with getThreadBacktrace().
+ *  This also does all preparations that must not happen while that thread is interrupted,
+ *  so call this before the backtrace is needed.
+ */
+GAMMARAY_CORE_EXPORT BacktraceThread currentBacktraceThread();
+
+/** Releases what currentBacktraceThread() acquired for @p thread,
+ *  once no more backtraces of it are needed.
+ */
+GAMMARAY_CORE_EXPORT void releaseBacktraceThread(BacktraceThread thread);
+
+/** Retrieves the backtrace of another, possibly blocked, thread.
+ *  Returns an empty backtrace if this is not supported on this platform,
+ *  or if @p thread did not respond in time.
+ */
+GAMMARAY_CORE_EXPORT Backtrace getThreadBacktrace(BacktraceThread thread, int levels = -1);
 
 #endif // BACKTRACE_H
@@ -33,3 +33,39 @@ Backtrace getBacktrace(int levels)
     Q_UNUSED(levels);
     return Backtrace();
 }
+
+int captureBacktrace(void **frames, int maxFrames)
+{
+    Q_UNUSED(frames);
+    Q_UNUSED(maxFrames);
+    return 0;
+}
+
+Backtrace symbolizeBacktrace(void *const *frames, int count)
+{
+    Q_UNUSED(frames);
+    Q_UNUSED(count);
+    return Backtrace();
+}
+
+QVector<GammaRay::SourceLocation> resolveSourceLocations(const QVector<QByteArray> &stacks)
+{
+    return QVector<GammaRay::SourceLocation>(stacks.size());
+}
+
+BacktraceThread currentBacktraceThread()
+{
+    return 0;
+}
+
+void releaseBacktraceThread(BacktraceThread thread)
+{
+    Q_UNUSED(thread);
+}
+
+Backtrace getThreadBacktrace(BacktraceThread thread, int levels)
+{
+    Q_UNUSED(thread);
+    Q_UNUSED(levels);
+    return Backtrace();
+}
@@ -31,8 +31,23 @@
 #include <config-gammaray.h>
 #include "backtrace.h"
 
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QProcess>
 #include <QString>
+#include <QUrl>
+#include <dlfcn.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#ifdef HAVE_ELF_H
+#include <elf.h>
+#include <link.h>
+#endif
 
 #ifdef HAVE_BACKTRACE
 #include <execinfo.h>
@@ -68,13 +83,11 @@ static QString maybeDemangleName(char *name)
 
 #endif
 
-Backtrace getBacktrace(int levels)
+#ifdef HAVE_BACKTRACE
+static Backtrace symbolize(void *const *trace, int n, int levels)
 {
     QStringList s;
-#ifdef HAVE_BACKTRACE
-    void *trace[256];
-    int n = backtrace(trace, 256);
-    if (!n)
+    if (n <= 0)
         return s;
     char **strings = backtrace_symbols(trace, n);
 
@@ -87,9 +100,229 @@ Backtrace getBacktrace(int levels)
 
     if (strings)
         free(strings);
+    return s;
+}
+
+namespace {
+enum {
+    MaxFrames = 256,
+    // the signal handler and the signal trampoline
+    SignalHandlerFrames = 2
+};
+
+// state shared with the signal handler, only plain data and atomics in here
+struct ThreadCapture
+{
+    QBasicAtomicInt requested;
+    QBasicAtomicInt done;
+    pthread_t target;
+    void *frames[MaxFrames];
+    int frameCount;
+};
+}
+
+static ThreadCapture s_threadCapture;
+static struct sigaction s_previousAction;
+static QMutex s_threadCaptureMutex;
+static bool s_handlerInstalled = false;
+
+// SIGPROF is rarely used by applications, we forward anything not requested by us nevertheless
+static void captureSignalHandler(int sig, siginfo_t *info, void *context)
+{
+    if (pthread_equal(pthread_self(), s_threadCapture.target)
+        && s_threadCapture.requested.testAndSetAcquire(1, 0)) {
+        s_threadCapture.frameCount = backtrace(s_threadCapture.frames, MaxFrames);
+        s_threadCapture.done.storeRelease(1);
+        return;
+    }
+
+    if (s_previousAction.sa_flags & SA_SIGINFO) {
+        if (s_previousAction.sa_sigaction)
+            s_previousAction.sa_sigaction(sig, info, context);
+    } else if (s_previousAction.sa_handler != SIG_DFL && s_previousAction.sa_handler != SIG_IGN) {
+        s_previousAction.sa_handler(sig);
+    }
+}
+#endif
 
+Backtrace getBacktrace(int levels)
+{
+#ifdef HAVE_BACKTRACE
+    void *trace[256];
+    const int n = backtrace(trace, 256);
+    return symbolize(trace, n, levels);
 #else
     Q_UNUSED(levels);
+    return QStringList();
+#endif
+}
+
+int captureBacktrace(void **frames, int maxFrames)
+{
+#ifdef HAVE_BACKTRACE
+    return backtrace(frames, maxFrames);
+#else
+    Q_UNUSED(frames);
+    Q_UNUSED(maxFrames);
+    return 0;
+#endif
+}
+
+Backtrace symbolizeBacktrace(void *const *frames, int count)
+{
+#ifdef HAVE_BACKTRACE
+    return symbolize(frames, count, -1);
+#else
+    Q_UNUSED(frames);
+    Q_UNUSED(count);
+    return Backtrace();
+#endif
+}
+
+static bool isQtOrGammaRayModule(const char *fileName)
+{
+    const QString name = QFileInfo(QString::fromLocal8Bit(fileName)).fileName();
+    return name.startsWith(QLatin1String("libQt")) || name.contains(QLatin1String("gammaray"));
+}
+
+// "file:line", optionally followed by " (discriminator n)", or "??:0" if unknown
+static GammaRay::SourceLocation parseAddr2lineOutput(QString line)
+{
+    const int discriminatorPos = line.indexOf(QLatin1String(" ("));
+    if (discriminatorPos > 0)
+        line.truncate(discriminatorPos);
+    const int separatorPos = line.lastIndexOf(QLatin1Char(':'));
+    if (separatorPos <= 0 || line.startsWith(QLatin1String("??")))
+        return GammaRay::SourceLocation();
+    bool ok;
+    const int lineNumber = line.mid(separatorPos + 1).toInt(&ok);
+    if (!ok || lineNumber <= 0)
+        return GammaRay::SourceLocation();
+    return GammaRay::SourceLocation(QUrl::fromLocalFile(line.left(separatorPos)), lineNumber);
+}
+
+/// resolves all @p addresses within @p module with a single addr2line run
+static QVector<GammaRay::SourceLocation> addr2line(const QString &module,
+                                                   const QVector<quintptr> &addresses)
+{
+    QStringList args;
+    args.reserve(addresses.size() + 2);
+    args << QStringLiteral("-e") << module;
+    foreach (quintptr address, addresses)
+        args << QStringLiteral("0x%1").arg(address, 0, 16);
+
+    QVector<GammaRay::SourceLocation> locations(addresses.size());
+    QProcess proc;
+    proc.start(QStringLiteral("addr2line"), args);
+    if (!proc.waitForFinished(30000) || proc.exitStatus() != QProcess::NormalExit
+        || proc.exitCode() != 0)
+        return locations;
+
+    // one line per address, in order
+    const QStringList lines = QString::fromLocal8Bit(proc.readAllStandardOutput()).split(
+        QLatin1Char('\n'));
+    for (int i = 0; i < addresses.size() && i < lines.size(); ++i)
+        locations[i] = parseAddr2lineOutput(lines.at(i).trimmed());
+    return locations;
+}
+
+QVector<GammaRay::SourceLocation> resolveSourceLocations(const QVector<QByteArray> &stacks)
+{
+    // module -> (stack index, address) of the first relevant frame of each stack
+    QHash<QString, QVector<QPair<int, quintptr> > > modules;
+    for (int i = 0; i < stacks.size(); ++i) {
+        void *const *frames = reinterpret_cast<void *const *>(stacks.at(i).constData());
+        const int count = stacks.at(i).size() / int(sizeof(void *));
+        for (int j = 0; j < count; ++j) {
+            Dl_info info;
+            if (dladdr(frames[j], &info) == 0 || !info.dli_fname || !info.dli_fbase)
+                continue;
+            if (isQtOrGammaRayModule(info.dli_fname))
+                continue;
+
+            // return addresses point behind the call instruction
+            quintptr address = reinterpret_cast<quintptr>(frames[j]) - 1;
+#ifdef HAVE_ELF_H
+            // addr2line wants offsets for position independent code, but absolute addresses otherwise
+            if (reinterpret_cast<const ElfW(Ehdr) *>(info.dli_fbase)->e_type != ET_EXEC)
+#endif
+            address -= reinterpret_cast<quintptr>(info.dli_fbase);
+            modules[QString::fromLocal8Bit(info.dli_fname)].push_back(qMakePair(i, address));
+            break;
+        }
+    }
+
+    QVector<GammaRay::SourceLocation> locations(stacks.size());
+    for (auto it = modules.constBegin(); it != modules.constEnd(); ++it) {
+        QVector<quintptr> addresses;
+        addresses.reserve(it.value().size());
+        foreach (const auto &frame, it.value())
+            addresses.push_back(frame.second);
+        const auto moduleLocations = addr2line(it.key(), addresses);
+        for (int i = 0; i < it.value().size(); ++i)
+            locations[it.value().at(i).first] = moduleLocations.at(i);
+    }
+    return locations;
+}
+
+BacktraceThread currentBacktraceThread()
+{
+#ifdef HAVE_BACKTRACE
+    QMutexLocker lock(&s_threadCaptureMutex);
+    if (!s_handlerInstalled) {
+        // backtrace() loads libgcc on first use, which must not happen inside the signal handler
+        void *trace[1];
+        backtrace(trace, 1);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = captureSignalHandler;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        s_handlerInstalled = sigaction(SIGPROF, &action, &s_previousAction) == 0;
+    }
+#endif
+    return (BacktraceThread)pthread_self();
+}
+
+void releaseBacktraceThread(BacktraceThread thread)
+{
+    Q_UNUSED(thread);
+}
+
+Backtrace getThreadBacktrace(BacktraceThread thread, int levels)
+{
+#ifdef HAVE_BACKTRACE
+    QMutexLocker lock(&s_threadCaptureMutex);
+    if (!s_handlerInstalled)
+        return Backtrace();
+
+    s_threadCapture.target = (pthread_t)thread;
+    s_threadCapture.frameCount = 0;
+    s_threadCapture.done.store(0);
+    s_threadCapture.requested.storeRelease(1);
+    if (pthread_kill((pthread_t)thread, SIGPROF) != 0) {
+        s_threadCapture.requested.store(0);
+        return Backtrace();
+    }
+
+    for (int i = 0; i < 100 && !s_threadCapture.done.loadAcquire(); ++i)
+        usleep(1000);
+    if (!s_threadCapture.done.loadAcquire()) {
+        // withdraw the request unless the handler is already running, it won't take long then
+        if (s_threadCapture.requested.testAndSetRelaxed(1, 0))
+            return Backtrace();
+        while (!s_threadCapture.done.loadAcquire())
+            usleep(100);
+    }
+
+    if (s_threadCapture.frameCount <= SignalHandlerFrames)
+        return Backtrace();
+    return symbolize(s_threadCapture.frames + SignalHandlerFrames,
+                     s_threadCapture.frameCount - SignalHandlerFrames, levels);
+#else
+    Q_UNUSED(thread);
+    Q_UNUSED(levels);
+    return Backtrace();
 #endif
-    return s;
 }
@@ -30,13 +30,15 @@
 #include "backtrace.h"
 #include <StackWalker/StackWalker.h>
 
+#include <QMutex>
+
 class StackWalkerToQStringList : public StackWalker
 {
 public:
-    QStringList getStackWalkerBacktrace()
+    QStringList getStackWalkerBacktrace(HANDLE thread = GetCurrentThread())
     {
         m_stackTrace.clear();
-        ShowCallstack();
+        ShowCallstack(thread);
         return m_stackTrace;
     }
 
@@ -72,3 +74,59 @@ Backtrace getBacktrace(int /*levels*/)
         stackWalkerToQStringList = new StackWalkerToQStringList();
     return stackWalkerToQStringList->getStackWalkerBacktrace();
 }
+
+int captureBacktrace(void **frames, int maxFrames)
+{
+    return CaptureStackBackTrace(0, maxFrames, frames, NULL);
+}
+
+Backtrace symbolizeBacktrace(void *const *frames, int count)
+{
+    // StackWalker only resolves complete call stacks, so we can only provide the addresses here
+    Backtrace backtrace;
+    backtrace.reserve(count);
+    for (int i = 0; i < count; ++i)
+        backtrace.push_back(QStringLiteral("0x%1").arg(quintptr(frames[i]), 0, 16));
+    return backtrace;
+}
+
+QVector<GammaRay::SourceLocation> resolveSourceLocations(const QVector<QByteArray> &stacks)
+{
+    // StackWalker only provides line information for complete stack walks of a live thread
+    return QVector<GammaRay::SourceLocation>(stacks.size());
+}
+
+// separate instance for other threads, as those are captured from a different thread than getBacktrace()
+static StackWalkerToQStringList *threadStackWalker = 0;
+static QMutex threadStackWalkerMutex;
+
+BacktraceThread currentBacktraceThread()
+{
+    QMutexLocker lock(&threadStackWalkerMutex);
+    if (!threadStackWalker) {
+        threadStackWalker = new StackWalkerToQStringList();
+        // loading modules while the target thread is suspended can deadlock on the loader lock
+        threadStackWalker->LoadModules();
+    }
+
+    // GetCurrentThread() returns a pseudo handle that is only meaningful in the calling thread
+    HANDLE thread = 0;
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &thread,
+                    0, FALSE, DUPLICATE_SAME_ACCESS);
+    return reinterpret_cast<BacktraceThread>(thread);
+}
+
+void releaseBacktraceThread(BacktraceThread thread)
+{
+    if (thread)
+        CloseHandle(reinterpret_cast<HANDLE>(thread));
+}
+
+Backtrace getThreadBacktrace(BacktraceThread thread, int /*levels*/)
+{
+    QMutexLocker lock(&threadStackWalkerMutex);
+    if (!threadStackWalker || !thread)
+        return Backtrace();
+    // StackWalker suspends the thread while walking its stack
+    return threadStackWalker->getStackWalkerBacktrace(reinterpret_cast<HANDLE>(thread));
+}
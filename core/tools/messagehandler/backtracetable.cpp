@@ -0,0 +1,83 @@
+/*
+  backtracetable.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "backtrace.h"
+
+#include <QVarLengthArray>
+
+using namespace GammaRay;
+
+BacktraceTable::BacktraceTable(int maxStacks)
+    : m_maxStacks(maxStacks)
+{
+}
+
+int BacktraceTable::capture(int maxFrames)
+{
+    QVarLengthArray<void *, 32> frames(maxFrames);
+    const int count = captureBacktrace(frames.data(), maxFrames);
+    return insert(frames.constData(), count);
+}
+
+int BacktraceTable::insert(void *const *frames, int count)
+{
+    if (count <= 0)
+        return -1;
+
+    // look up without copying, this is the common case
+    const QByteArray key = QByteArray::fromRawData(reinterpret_cast<const char *>(frames),
+                                                   count * int(sizeof(void *)));
+    const auto it = m_ids.constFind(key);
+    if (it != m_ids.constEnd())
+        return it.value();
+    if (m_stacks.size() >= m_maxStacks)
+        return -1;
+
+    const QByteArray stack(key.constData(), key.size()); // deep copy
+    const int id = m_stacks.size();
+    m_stacks.push_back(stack);
+    m_ids.insert(stack, id);
+    return id;
+}
+
+QByteArray BacktraceTable::stack(int id) const
+{
+    if (id < 0 || id >= m_stacks.size())
+        return QByteArray();
+    return m_stacks.at(id);
+}
+
+int BacktraceTable::size() const
+{
+    return m_stacks.size();
+}
+
+void BacktraceTable::clear()
+{
+    m_ids.clear();
+    m_stacks.clear();
+}
@@ -44,6 +44,10 @@ PropertiesExtension::PropertiesExtension(PropertyController *controller)
     , m_aggregatedPropertyModel(new AggregatedPropertyModel(this))
 {
     controller->registerModel(m_aggregatedPropertyModel, QStringLiteral("properties"));
+
+    m_aggregatedPropertyModel->setMaximumUpdateRate(controller->maximumUpdateRate());
+    connect(controller, SIGNAL(maximumUpdateRateChanged(int)),
+            m_aggregatedPropertyModel, SLOT(setMaximumUpdateRate(int)));
 }
 
 PropertiesExtension::~PropertiesExtension()
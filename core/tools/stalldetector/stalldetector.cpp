@@ -0,0 +1,92 @@
+/*
+  stalldetector.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stalldetector.h"
+#include "stallmodel.h"
+#include "stallwatchdog.h"
+
+#include <core/probeinterface.h>
+#include <core/probesettings.h>
+
+#include <QTimer>
+
+using namespace GammaRay;
+
+StallDetector::StallDetector(ProbeInterface *probe, QObject *parent)
+    : StallDetectorInterface(parent)
+    , m_model(new StallModel(this))
+    , m_histogramModel(new StallHistogramModel(this))
+    , m_watchdog(new StallWatchdog(this))
+    , m_heartbeatTimer(new QTimer(this))
+{
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.StallModel"), m_model);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.StallHistogramModel"),
+                         m_histogramModel);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    m_heartbeatTimer->setTimerType(Qt::PreciseTimer);
+#endif
+    connect(m_heartbeatTimer, SIGNAL(timeout()), this, SLOT(heartbeat()));
+    connect(this, SIGNAL(thresholdChanged()), this, SLOT(updateThreshold()));
+
+    setThreshold(ProbeSettings::value(QStringLiteral("StallThreshold"), 250).toInt());
+}
+
+StallDetector::~StallDetector()
+{
+}
+
+void StallDetector::clear()
+{
+    m_model->clear();
+    m_histogramModel->clear();
+}
+
+void StallDetector::heartbeat()
+{
+    Backtrace backtrace;
+    const qint64 elapsed = m_watchdog->heartbeat(&backtrace);
+    const qint64 duration = elapsed - m_heartbeatTimer->interval();
+    if (threshold() <= 0 || duration < threshold())
+        return;
+
+    m_model->addStall(duration, backtrace);
+    m_histogramModel->addStall(duration);
+}
+
+void StallDetector::updateThreshold()
+{
+    m_watchdog->setThreshold(threshold());
+    if (threshold() <= 0) {
+        m_heartbeatTimer->stop();
+        return;
+    }
+
+    m_heartbeatTimer->start(StallWatchdog::heartbeatInterval(threshold()));
+    if (!m_watchdog->isRunning())
+        m_watchdog->start(QThread::HighPriority);
+}
@@ -0,0 +1,79 @@
+/*
+  stalldetector.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_STALLDETECTOR_STALLDETECTOR_H
+#define GAMMARAY_STALLDETECTOR_STALLDETECTOR_H
+
+#include "toolfactory.h"
+
+#include <common/tools/stalldetector/stalldetectorinterface.h>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+class StallHistogramModel;
+class StallModel;
+class StallWatchdog;
+
+/** Detects periods in which the event loop of the GUI thread did not run. */
+class StallDetector : public StallDetectorInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(GammaRay::StallDetectorInterface)
+public:
+    explicit StallDetector(ProbeInterface *probe, QObject *parent = 0);
+    ~StallDetector();
+
+public slots:
+    void clear() Q_DECL_OVERRIDE;
+
+private slots:
+    void heartbeat();
+    void updateThreshold();
+
+private:
+    StallModel *m_model;
+    StallHistogramModel *m_histogramModel;
+    StallWatchdog *m_watchdog;
+    QTimer *m_heartbeatTimer;
+};
+
+class StallDetectorFactory : public QObject, public StandardToolFactory<QObject, StallDetector>
+{
+    Q_OBJECT
+    Q_INTERFACES(GammaRay::ToolFactory)
+public:
+    explicit StallDetectorFactory(QObject *parent)
+        : QObject(parent)
+    {
+    }
+};
+}
+
+#endif // GAMMARAY_STALLDETECTOR_STALLDETECTOR_H
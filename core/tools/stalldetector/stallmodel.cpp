@@ -0,0 +1,249 @@
+/*
+  stallmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stallmodel.h"
+
+using namespace GammaRay;
+
+static const int MaxStalls = 100;
+
+// upper bounds in milliseconds, the last bucket takes everything above
+static const qint64 histogram_buckets[] = { 100, 250, 500, 1000, 2000, 5000, 10000 };
+static const int histogram_bucket_count = sizeof(histogram_buckets) / sizeof(qint64) + 1;
+
+StallModel::StallModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_firstSerial(0)
+{
+}
+
+StallModel::~StallModel()
+{
+}
+
+void StallModel::addStall(qint64 duration, const Backtrace &backtrace)
+{
+    if (m_stalls.size() == MaxStalls) {
+        beginRemoveRows(QModelIndex(), 0, 0);
+        m_stalls.remove(0);
+        ++m_firstSerial;
+        endRemoveRows();
+    }
+
+    Stall stall;
+    stall.startTime = QDateTime::currentDateTime().addMSecs(-duration);
+    stall.duration = duration;
+    stall.backtrace = backtrace;
+
+    beginInsertRows(QModelIndex(), m_stalls.size(), m_stalls.size());
+    m_stalls.push_back(stall);
+    endInsertRows();
+}
+
+void StallModel::clear()
+{
+    beginResetModel();
+    m_firstSerial += m_stalls.size();
+    m_stalls.clear();
+    endResetModel();
+}
+
+int StallModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int StallModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_stalls.size();
+    if (parent.internalId() || parent.column() != 0)
+        return 0;
+    return m_stalls.at(parent.row()).backtrace.size();
+}
+
+QModelIndex StallModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= COLUMN_COUNT)
+        return QModelIndex();
+    if (!parent.isValid()) {
+        if (row >= m_stalls.size())
+            return QModelIndex();
+        return createIndex(row, column);
+    }
+    if (parent.internalId() || row >= m_stalls.at(parent.row()).backtrace.size())
+        return QModelIndex();
+    // frames store the serial number of their stall + 1, so top-level rows can use 0
+    return createIndex(row, column, quintptr(m_firstSerial + parent.row() + 1));
+}
+
+QModelIndex StallModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || !child.internalId())
+        return QModelIndex();
+    const int row = int(quint32(child.internalId() - 1) - m_firstSerial);
+    if (row < 0 || row >= m_stalls.size())
+        return QModelIndex();
+    return createIndex(row, 0);
+}
+
+QVariant StallModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (!index.internalId()) {
+        const Stall &stall = m_stalls.at(index.row());
+        if (role == Qt::DisplayRole) {
+            switch (index.column()) {
+            case TimeColumn:
+                return stall.startTime.toString(QStringLiteral("hh:mm:ss.zzz"));
+            case DurationColumn:
+                return stall.duration;
+            case LocationColumn:
+                if (stall.backtrace.isEmpty())
+                    return tr("<no backtrace available>");
+                return stall.backtrace.first();
+            }
+        } else if (role == Qt::TextAlignmentRole && index.column() == DurationColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return QVariant();
+    }
+
+    const QModelIndex parentIndex = parent(index);
+    if (!parentIndex.isValid())
+        return QVariant();
+    const Backtrace &backtrace = m_stalls.at(parentIndex.row()).backtrace;
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case TimeColumn:
+            return QStringLiteral("#%1").arg(index.row());
+        case LocationColumn:
+            return backtrace.at(index.row());
+        }
+    }
+    return QVariant();
+}
+
+QVariant StallModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case TimeColumn:
+            return tr("Time");
+        case DurationColumn:
+            return tr("Duration [ms]");
+        case LocationColumn:
+            return tr("Location");
+        }
+    }
+    return QVariant();
+}
+
+StallHistogramModel::StallHistogramModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_counts(histogram_bucket_count, 0)
+{
+}
+
+StallHistogramModel::~StallHistogramModel()
+{
+}
+
+void StallHistogramModel::addStall(qint64 duration)
+{
+    int bucket = 0;
+    while (bucket < histogram_bucket_count - 1 && duration >= histogram_buckets[bucket])
+        ++bucket;
+    ++m_counts[bucket];
+    emit dataChanged(index(bucket, CountColumn), index(bucket, CountColumn));
+}
+
+void StallHistogramModel::clear()
+{
+    m_counts.fill(0);
+    emit dataChanged(index(0, CountColumn), index(histogram_bucket_count - 1, CountColumn));
+}
+
+int StallHistogramModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int StallHistogramModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return histogram_bucket_count;
+}
+
+static QString formatDuration(qint64 msecs)
+{
+    if (msecs >= 1000)
+        return QStringLiteral("%1 s").arg(msecs / 1000);
+    return QStringLiteral("%1 ms").arg(msecs);
+}
+
+QVariant StallHistogramModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const int bucket = index.row();
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case DurationColumn:
+            if (bucket == 0)
+                return tr("< %1").arg(formatDuration(histogram_buckets[0]));
+            if (bucket == histogram_bucket_count - 1)
+                return tr(">= %1").arg(formatDuration(histogram_buckets[bucket - 1]));
+            return tr("%1 - %2").arg(formatDuration(histogram_buckets[bucket - 1]),
+                                     formatDuration(histogram_buckets[bucket]));
+        case CountColumn:
+            return m_counts.at(bucket);
+        }
+    } else if (role == Qt::TextAlignmentRole && index.column() == CountColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant StallHistogramModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case DurationColumn:
+            return tr("Duration");
+        case CountColumn:
+            return tr("Stalls");
+        }
+    }
+    return QVariant();
+}
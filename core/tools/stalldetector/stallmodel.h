@@ -0,0 +1,105 @@
+/*
+  stallmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_STALLDETECTOR_STALLMODEL_H
+#define GAMMARAY_STALLDETECTOR_STALLMODEL_H
+
+#include <core/tools/messagehandler/backtrace.h>
+
+#include <QAbstractItemModel>
+#include <QDateTime>
+#include <QVector>
+
+namespace GammaRay {
+/** The most recent stalls, with the backtrace frames as children. */
+class StallModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        TimeColumn,
+        DurationColumn,
+        LocationColumn,
+        COLUMN_COUNT
+    };
+
+    explicit StallModel(QObject *parent = 0);
+    ~StallModel();
+
+    /** Adds a stall that just ended, dropping the oldest one if the model is full. */
+    void addStall(qint64 duration, const Backtrace &backtrace);
+    void clear();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QModelIndex index(int row, int column,
+                      const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QModelIndex parent(const QModelIndex &child) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    struct Stall {
+        QDateTime startTime;
+        qint64 duration;
+        Backtrace backtrace;
+    };
+    QVector<Stall> m_stalls;
+    // serial number of m_stalls.first(), frames refer to their stall by serial number
+    quint32 m_firstSerial;
+};
+
+/** Number of stalls by duration. */
+class StallHistogramModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        DurationColumn,
+        CountColumn,
+        COLUMN_COUNT
+    };
+
+    explicit StallHistogramModel(QObject *parent = 0);
+    ~StallHistogramModel();
+
+    void addStall(qint64 duration);
+    void clear();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    QVector<int> m_counts;
+};
+}
+
+#endif // GAMMARAY_STALLDETECTOR_STALLMODEL_H
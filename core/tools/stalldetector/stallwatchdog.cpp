@@ -0,0 +1,114 @@
+/*
+  stallwatchdog.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stallwatchdog.h"
+
+#include <limits>
+
+using namespace GammaRay;
+
+StallWatchdog::StallWatchdog(QObject *parent)
+    : QThread(parent)
+    , m_thread(currentBacktraceThread())
+    , m_lastHeartbeat(0)
+    , m_beat(0)
+    , m_capturedBeat(std::numeric_limits<quint64>::max())
+    , m_threshold(0)
+    , m_stop(false)
+{
+    m_clock.start();
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+    wait();
+    releaseBacktraceThread(m_thread);
+}
+
+int StallWatchdog::heartbeatInterval(int threshold)
+{
+    return qBound(10, threshold / 4, 250);
+}
+
+void StallWatchdog::setThreshold(int threshold)
+{
+    QMutexLocker lock(&m_mutex);
+    m_threshold = threshold;
+    m_lastHeartbeat = m_clock.elapsed();
+    ++m_beat;
+    m_waitCondition.wakeAll();
+}
+
+qint64 StallWatchdog::heartbeat(Backtrace *backtrace)
+{
+    QMutexLocker lock(&m_mutex);
+    const qint64 now = m_clock.elapsed();
+    const qint64 elapsed = now - m_lastHeartbeat;
+    m_lastHeartbeat = now;
+    if (m_capturedBeat == m_beat) {
+        backtrace->swap(m_backtrace);
+        m_backtrace.clear();
+    }
+    ++m_beat;
+    return elapsed;
+}
+
+void StallWatchdog::stop()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stop = true;
+    m_waitCondition.wakeAll();
+}
+
+void StallWatchdog::run()
+{
+    QMutexLocker lock(&m_mutex);
+    while (!m_stop) {
+        if (m_threshold <= 0) {
+            m_waitCondition.wait(&m_mutex);
+            continue;
+        }
+
+        const int interval = heartbeatInterval(m_threshold);
+        m_waitCondition.wait(&m_mutex, interval);
+        if (m_stop || m_threshold <= 0 || m_capturedBeat == m_beat)
+            continue;
+        if (m_clock.elapsed() - m_lastHeartbeat < m_threshold + interval)
+            continue;
+
+        // capture outside of the lock, so the heartbeat isn't blocked on us once the thread resumes
+        const quint64 beat = m_beat;
+        lock.unlock();
+        Backtrace backtrace = getThreadBacktrace(m_thread, 64);
+        lock.relock();
+        if (beat != m_beat)
+            continue;
+        m_capturedBeat = beat;
+        m_backtrace.swap(backtrace);
+    }
+}
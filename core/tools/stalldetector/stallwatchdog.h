@@ -0,0 +1,79 @@
+/*
+  stallwatchdog.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_STALLDETECTOR_STALLWATCHDOG_H
+#define GAMMARAY_STALLDETECTOR_STALLWATCHDOG_H
+
+#include <core/tools/messagehandler/backtrace.h>
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+namespace GammaRay {
+/** Watches the heartbeat of the thread it was created in, and captures the backtrace
+ *  of that thread once the heartbeat is late by more than the threshold.
+ */
+class StallWatchdog : public QThread
+{
+    Q_OBJECT
+public:
+    explicit StallWatchdog(QObject *parent = 0);
+    ~StallWatchdog();
+
+    /** Interval in which heartbeat() is expected to be called, for the given threshold. */
+    static int heartbeatInterval(int threshold);
+
+    /** Threshold in milliseconds, 0 suspends watching. */
+    void setThreshold(int threshold);
+
+    /** Called from the monitored thread, returns the time in milliseconds since the previous
+     *  heartbeat. If a backtrace was captured meanwhile, it's moved into @p backtrace.
+     */
+    qint64 heartbeat(Backtrace *backtrace);
+
+    void stop();
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    BacktraceThread m_thread;
+    QElapsedTimer m_clock;
+    QMutex m_mutex; // protects all members below
+    QWaitCondition m_waitCondition;
+    qint64 m_lastHeartbeat;
+    quint64 m_beat;
+    quint64 m_capturedBeat;
+    Backtrace m_backtrace;
+    int m_threshold;
+    bool m_stop;
+};
+}
+
+#endif // GAMMARAY_STALLDETECTOR_STALLWATCHDOG_H
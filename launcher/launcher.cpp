@@ -36,10 +36,14 @@
 
 #include <common/endpoint.h>
 #include <common/message.h>
+#include <common/probesettingsfile.h>
 
 #include <QByteArray>
 #include <QCoreApplication>
+#include <QDataStream>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QLocalServer>
 #include <QLocalSocket>
@@ -85,6 +89,7 @@ struct LauncherPrivate
     QTimer safetyTimer;
     AbstractInjector::Ptr injector;
     QUrl serverAddress;
+    QString settingsFile;
     QString errorMessage;
     int state;
     int exitCode;
@@ -109,6 +114,7 @@ Launcher::~Launcher()
 {
     stop();
     d->client.waitForFinished();
+    removeProbeSettingsFile();
     delete d;
 }
 
@@ -133,6 +139,7 @@ bool Launcher::start()
     }
 
     sendLauncherId();
+    writeProbeSettingsFile();
     setupProbeSettingsServer();
 
     if (d->options.uiMode() != LaunchOptions::InProcessUi)
@@ -213,6 +220,35 @@ void Launcher::sendLauncherId()
         d->options.setProbeSetting(QStringLiteral("LAUNCHER_ID"), instanceIdentifier());
 }
 
+void Launcher::writeProbeSettingsFile()
+{
+    // the probe reads this right away on startup, rather than waiting for the local socket
+    // connection below, which remains as a fallback and for the server address reply
+    d->settingsFile = ProbeSettingsFile::path(instanceIdentifier());
+    if (d->settingsFile.isEmpty())
+        return;
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream << Protocol::version() << d->options.probeSettings();
+
+    // the directory is private, so anything there is a leftover of an earlier launcher with our id
+    QFile::remove(d->settingsFile);
+    if (!ProbeSettingsFile::write(d->settingsFile, data)) {
+        qWarning() << "Unable to write probe settings file" << d->settingsFile;
+        d->settingsFile.clear();
+    }
+}
+
+void Launcher::removeProbeSettingsFile()
+{
+    if (d->settingsFile.isEmpty())
+        return;
+    QFile::remove(d->settingsFile);
+    d->settingsFile.clear();
+}
+
 void Launcher::setupProbeSettingsServer()
 {
     d->server = new QLocalServer(this);
@@ -327,6 +363,8 @@ void Launcher::readyRead()
     if (d->serverAddress.isEmpty())
         return;
 
+    // the probe is up and running, so it has read the settings by now
+    removeProbeSettingsFile();
     d->safetyTimer.stop();
     std::cout << "GammaRay server listening on: " << qPrintable(d->serverAddress.toString())
               << std::endl;
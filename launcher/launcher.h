@@ -85,6 +85,8 @@ private slots:
 
 private:
     void sendLauncherId();
+    void writeProbeSettingsFile();
+    void removeProbeSettingsFile();
     void setupProbeSettingsServer();
     void checkDone();
 
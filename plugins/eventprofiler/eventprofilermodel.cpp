@@ -0,0 +1,273 @@
+/*
+  eventprofilermodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventprofilermodel.h"
+
+#include <QEvent>
+#include <QMetaEnum>
+#include <QMetaObject>
+#include <QTimer>
+
+using namespace GammaRay;
+
+static QString eventTypeName(int type)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 5, 0)
+    const QMetaObject &mo = QEvent::staticMetaObject;
+    const QMetaEnum me = mo.enumerator(mo.indexOfEnumerator("Type"));
+    if (const char *key = me.valueToKey(type))
+        return QString::fromLatin1(key);
+#endif
+    if (type >= QEvent::User && type <= QEvent::MaxUser)
+        return QStringLiteral("User + %1").arg(type - QEvent::User);
+    return QString::number(type);
+}
+
+EventProfilerModel::EventProfilerModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_updateTimer(new QTimer(this))
+{
+    m_updateTimer->setInterval(1000);
+    connect(m_updateTimer, SIGNAL(timeout()), this, SLOT(update()));
+    m_updateTimer->start();
+}
+
+EventProfilerModel::~EventProfilerModel()
+{
+}
+
+int EventProfilerModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int EventProfilerModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant EventProfilerModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return displayData(index.row(), index.column());
+    if (role == Qt::TextAlignmentRole && index.column() >= CountColumn)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    return QVariant();
+}
+
+QVariant EventProfilerModel::displayData(int row, int column) const
+{
+    const Row &r = m_rows.at(row);
+    switch (column) {
+    case EventTypeColumn:
+        return eventTypeName(r.key.eventType);
+    case ReceiverColumn:
+        return QString::fromLatin1(r.key.receiverType->className());
+    case CountColumn:
+        return r.stats.count;
+    case TotalTimeColumn:
+        return r.stats.totalTime / 1000000.0;
+    case ExclusiveTimeColumn:
+        return r.stats.exclusiveTime / 1000000.0;
+    case AverageTimeColumn:
+        if (!r.stats.count)
+            return QVariant();
+        return r.stats.totalTime / 1000.0 / r.stats.count;
+    case MedianTimeColumn:
+        return r.stats.percentile(0.5) / 1000.0;
+    case P90TimeColumn:
+        return r.stats.percentile(0.9) / 1000.0;
+    case P99TimeColumn:
+        return r.stats.percentile(0.99) / 1000.0;
+    case MaxTimeColumn:
+        return r.stats.maxTime / 1000.0;
+    }
+    return QVariant();
+}
+
+QVariant EventProfilerModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case EventTypeColumn:
+            return tr("Event");
+        case ReceiverColumn:
+            return tr("Receiver");
+        case CountColumn:
+            return tr("Count");
+        case TotalTimeColumn:
+            return tr("Total [ms]");
+        case ExclusiveTimeColumn:
+            return tr("Self [ms]");
+        case AverageTimeColumn:
+            return tr("Average [uSecs]");
+        case MedianTimeColumn:
+            return tr("Median [uSecs]");
+        case P90TimeColumn:
+            return tr("90% [uSecs]");
+        case P99TimeColumn:
+            return tr("99% [uSecs]");
+        case MaxTimeColumn:
+            return tr("Max. [uSecs]");
+        }
+    }
+    if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        switch (section) {
+        case TotalTimeColumn:
+            return tr("Time spent delivering the event, including nested event deliveries.");
+        case ExclusiveTimeColumn:
+            return tr("Time spent delivering the event, excluding nested event deliveries.");
+        case MedianTimeColumn:
+        case P90TimeColumn:
+        case P99TimeColumn:
+            return tr("Estimated from a logarithmic histogram, accurate to a factor of two.");
+        }
+    }
+    return QVariant();
+}
+
+void EventProfilerModel::clear()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_rowIndex.clear();
+    endResetModel();
+}
+
+void EventProfilerModel::update()
+{
+    const auto snapshot = EventProfilerRecorder::snapshot();
+
+    QVector<Row> newRows;
+    for (auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+        const auto rowIt = m_rowIndex.constFind(it.key());
+        if (rowIt != m_rowIndex.constEnd()) {
+            m_rows[rowIt.value()].stats = it.value();
+        } else {
+            Row row;
+            row.key = it.key();
+            row.stats = it.value();
+            newRows.push_back(row);
+        }
+    }
+
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, CountColumn), index(m_rows.size() - 1, COLUMN_COUNT - 1));
+
+    if (newRows.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + newRows.size() - 1);
+    foreach (const Row &row, newRows) {
+        m_rowIndex.insert(row.key, m_rows.size());
+        m_rows.push_back(row);
+    }
+    endInsertRows();
+}
+
+EventQueueModel::EventQueueModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_updateTimer(new QTimer(this))
+{
+    // sampled more often than the statistics, queues tend to drain quickly
+    m_updateTimer->setInterval(250);
+    connect(m_updateTimer, SIGNAL(timeout()), this, SLOT(update()));
+    m_updateTimer->start();
+}
+
+EventQueueModel::~EventQueueModel()
+{
+}
+
+int EventQueueModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int EventQueueModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_threads.size();
+}
+
+QVariant EventQueueModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const EventQueueDepth &depth = m_threads.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ThreadColumn:
+            return depth.threadName;
+        case PendingColumn:
+            return depth.pending;
+        case MaxPendingColumn:
+            return depth.maxPending;
+        }
+    }
+    if (role == Qt::TextAlignmentRole && index.column() != ThreadColumn)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    return QVariant();
+}
+
+QVariant EventQueueModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ThreadColumn:
+            return tr("Thread");
+        case PendingColumn:
+            return tr("Posted Events");
+        case MaxPendingColumn:
+            return tr("Max. Posted Events");
+        }
+    }
+    return QVariant();
+}
+
+void EventQueueModel::update()
+{
+    const QVector<EventQueueDepth> threads = EventProfilerRecorder::queueDepths();
+    if (threads.size() != m_threads.size()) {
+        beginResetModel();
+        m_threads = threads;
+        endResetModel();
+        return;
+    }
+
+    m_threads = threads;
+    if (!m_threads.isEmpty())
+        emit dataChanged(index(0, 0), index(m_threads.size() - 1, COLUMN_COUNT - 1));
+}
@@ -0,0 +1,118 @@
+/*
+  eventprofilermodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTPROFILERMODEL_H
+#define GAMMARAY_EVENTPROFILERMODEL_H
+
+#include "eventprofilerrecorder.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Periodically collected event delivery statistics per event type and receiver class. */
+class EventProfilerModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        EventTypeColumn,
+        ReceiverColumn,
+        CountColumn,
+        TotalTimeColumn,
+        ExclusiveTimeColumn,
+        AverageTimeColumn,
+        MedianTimeColumn,
+        P90TimeColumn,
+        P99TimeColumn,
+        MaxTimeColumn,
+        COLUMN_COUNT
+    };
+
+    explicit EventProfilerModel(QObject *parent = 0);
+    ~EventProfilerModel();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+public slots:
+    /** Resets the displayed data, the recorder has to be cleared separately. */
+    void clear();
+
+private slots:
+    void update();
+
+private:
+    QVariant displayData(int row, int column) const;
+
+    struct Row {
+        EventProfilerKey key;
+        EventProfilerStats stats;
+    };
+    QVector<Row> m_rows;
+    QHash<EventProfilerKey, int> m_rowIndex;
+    QTimer *m_updateTimer;
+};
+
+/** Posted event queue length per thread. */
+class EventQueueModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        ThreadColumn,
+        PendingColumn,
+        MaxPendingColumn,
+        COLUMN_COUNT
+    };
+
+    explicit EventQueueModel(QObject *parent = 0);
+    ~EventQueueModel();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private slots:
+    void update();
+
+private:
+    QVector<EventQueueDepth> m_threads;
+    QTimer *m_updateTimer;
+};
+}
+
+#endif // GAMMARAY_EVENTPROFILERMODEL_H
@@ -0,0 +1,442 @@
+/*
+  eventprofilerrecorder.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventprofilerrecorder.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QMutex>
+#include <QPointer>
+#include <QThread>
+#include <QThreadStorage>
+
+#include <private/qobject_p.h>
+#include <private/qthread_p.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace GammaRay;
+
+EventProfilerKey::EventProfilerKey()
+    : eventType(QEvent::None)
+    , receiverType(0)
+{
+}
+
+bool EventProfilerKey::operator==(const EventProfilerKey &other) const
+{
+    return eventType == other.eventType && receiverType == other.receiverType;
+}
+
+uint GammaRay::qHash(const EventProfilerKey &key)
+{
+    quint64 h = quintptr(key.receiverType);
+    h = h * 31 + uint(key.eventType);
+    return uint(h ^ (h >> 32));
+}
+
+EventProfilerStats::EventProfilerStats()
+    : count(0)
+    , totalTime(0)
+    , exclusiveTime(0)
+    , maxTime(0)
+{
+    std::fill(histogram, histogram + HistogramSize, 0);
+}
+
+EventProfilerStats &EventProfilerStats::operator+=(const EventProfilerStats &other)
+{
+    count += other.count;
+    totalTime += other.totalTime;
+    exclusiveTime += other.exclusiveTime;
+    maxTime = std::max(maxTime, other.maxTime);
+    for (int i = 0; i < HistogramSize; ++i)
+        histogram[i] += other.histogram[i];
+    return *this;
+}
+
+void EventProfilerStats::record(qint64 duration, qint64 exclusiveDuration)
+{
+    ++count;
+    totalTime += duration;
+    exclusiveTime += exclusiveDuration;
+    maxTime = std::max(maxTime, duration);
+
+    int bucket = 0;
+    for (quint64 d = std::max<qint64>(duration, 0); d > 1 && bucket < HistogramSize - 1; d >>= 1)
+        ++bucket;
+    ++histogram[bucket];
+}
+
+qint64 EventProfilerStats::percentile(double fraction) const
+{
+    if (!count)
+        return 0;
+
+    const quint64 threshold = std::max<quint64>(1, quint64(std::ceil(fraction * count)));
+    quint64 sum = 0;
+    for (int i = 0; i < HistogramSize - 1; ++i) {
+        sum += histogram[i];
+        if (sum >= threshold)
+            return std::min(maxTime, (qint64(1) << (i + 1)) - 1);
+    }
+    return maxTime;
+}
+
+EventQueueDepth::EventQueueDepth()
+    : pending(0)
+    , maxPending(0)
+{
+}
+
+namespace {
+enum {
+    MaxEntriesPerThread = 2048
+};
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+typedef QScopedScopeLevelCounter ScopeLevelCounter;
+#else
+typedef QScopedLoopLevelCounter ScopeLevelCounter;
+#endif
+
+struct ThreadData
+{
+    ThreadData()
+        : generation(0)
+        , dropped(0)
+        , childTime(0)
+        , maxPending(0)
+    {
+    }
+
+    QMutex mutex; // taken by the owning thread per event, and by the collector per update
+    QHash<EventProfilerKey, EventProfilerStats> stats;
+    int generation; // stats are discarded on the next event if this is outdated
+    quint64 dropped;
+
+    qint64 *childTime; // time spent in nested deliveries, only used by the owning thread
+    QPointer<QThread> thread;
+    QAtomicInt finished;
+    int maxPending; // only used by the collector
+};
+
+// owned by QThreadStorage, hands the data over to the collector once its thread ends
+struct ThreadDataHolder
+{
+    explicit ThreadDataHolder(ThreadData *d)
+        : data(d)
+    {
+    }
+
+    ~ThreadDataHolder()
+    {
+        data->finished.storeRelease(1);
+    }
+
+    ThreadData *data;
+};
+
+struct Registry
+{
+    Registry()
+        : retiredDropped(0)
+        , installed(false)
+    {
+        clock.start();
+    }
+
+    QElapsedTimer clock;
+    QAtomicInt generation;
+    QThreadStorage<ThreadDataHolder *> localData;
+
+    QMutex mutex; // protects the members below
+    QVector<ThreadData *> threads;
+    QHash<EventProfilerKey, EventProfilerStats> retired;
+    quint64 retiredDropped;
+    bool installed;
+};
+
+// accounts the time of a delivery to the enclosing one, also if the receiver throws
+class ChildTimeScope
+{
+public:
+    ChildTimeScope(ThreadData *data, const QElapsedTimer &clock)
+        : m_data(data)
+        , m_clock(clock)
+        , m_parentChildTime(data->childTime)
+        , m_childTime(0)
+        , m_start(clock.nsecsElapsed())
+    {
+        m_data->childTime = &m_childTime;
+    }
+
+    ~ChildTimeScope()
+    {
+        m_data->childTime = m_parentChildTime;
+        if (m_parentChildTime)
+            *m_parentChildTime += duration();
+    }
+
+    qint64 duration() const
+    {
+        return m_clock.nsecsElapsed() - m_start;
+    }
+
+    qint64 childTime() const
+    {
+        return m_childTime;
+    }
+
+private:
+    ThreadData *m_data;
+    const QElapsedTimer &m_clock;
+    qint64 *m_parentChildTime;
+    qint64 m_childTime;
+    qint64 m_start;
+};
+}
+
+Q_GLOBAL_STATIC(Registry, s_registry)
+
+static ThreadData *localThreadData()
+{
+    Registry *registry = s_registry();
+    if (!registry)
+        return 0;
+    if (ThreadDataHolder *holder = registry->localData.localData())
+        return holder->data;
+
+    ThreadData *data = new ThreadData;
+    data->thread = QThread::currentThread();
+    data->generation = registry->generation.loadAcquire();
+    registry->localData.setLocalData(new ThreadDataHolder(data));
+    QMutexLocker lock(&registry->mutex);
+    registry->threads.push_back(data);
+    return data;
+}
+
+static void record(ThreadData *data, const EventProfilerKey &key, qint64 duration,
+                   qint64 exclusiveDuration)
+{
+    const int generation = s_registry()->generation.loadAcquire();
+    QMutexLocker lock(&data->mutex);
+    if (data->generation != generation) {
+        data->stats.clear();
+        data->dropped = 0;
+        data->generation = generation;
+    }
+
+    auto it = data->stats.find(key);
+    if (it == data->stats.end()) {
+        if (data->stats.size() >= MaxEntriesPerThread) {
+            ++data->dropped;
+            return;
+        }
+        it = data->stats.insert(key, EventProfilerStats());
+    }
+    it.value().record(duration, exclusiveDuration);
+}
+
+static bool eventNotifyCallback(void **cbdata)
+{
+    QObject *receiver = reinterpret_cast<QObject *>(cbdata[0]);
+    QEvent *event = reinterpret_cast<QEvent *>(cbdata[1]);
+    bool *result = reinterpret_cast<bool *>(cbdata[2]);
+
+    QCoreApplication *app = QCoreApplication::instance();
+    if (!app || !receiver || !event)
+        return false;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    // notifyInternal2() uses the private doNotify() rather than notify() for these threads,
+    // we can't do the same, so leave delivery to Qt and don't record these events
+    if (!QObjectPrivate::get(receiver)->threadData->requiresCoreApplication)
+        return false;
+#endif
+    ThreadData *data = localThreadData();
+    if (!data)
+        return false;
+
+    // neither of them is guaranteed to survive the delivery
+    EventProfilerKey key;
+    key.eventType = event->type();
+    key.receiverType = receiver->metaObject();
+
+    // this is what notifyInternal2() does in case no callback takes over
+    ScopeLevelCounter scopeLevelCounter(QObjectPrivate::get(receiver)->threadData);
+    qint64 duration;
+    qint64 childTime;
+    {
+        ChildTimeScope scope(data, s_registry()->clock);
+        *result = app->notify(receiver, event);
+        duration = scope.duration();
+        childTime = scope.childTime();
+    }
+
+    record(data, key, duration, duration - childTime);
+    return true;
+}
+
+// there is no way to query registered callbacks, so we send a dummy event through them
+// and see if any of them claims to have delivered it
+static bool hasDeliveringEventNotifyCallback()
+{
+    QObject receiver;
+    QEvent event(QEvent::None);
+    bool result = false;
+    void *cbdata[] = { &receiver, &event, &result };
+    return QInternal::activateCallbacks(QInternal::EventNotifyCallback, cbdata);
+}
+
+bool EventProfilerRecorder::install()
+{
+    Registry *registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    if (registry->installed)
+        return true;
+    if (hasDeliveringEventNotifyCallback())
+        return false;
+    QInternal::registerCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+    registry->installed = true;
+    return true;
+}
+
+void EventProfilerRecorder::uninstall()
+{
+    Registry *registry = s_registry();
+    if (!registry)
+        return;
+    QMutexLocker lock(&registry->mutex);
+    if (!registry->installed)
+        return;
+    QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+    registry->installed = false;
+}
+
+// registry mutex must be locked
+static void retireFinishedThreads(Registry *registry)
+{
+    const int generation = registry->generation.loadAcquire();
+    for (auto it = registry->threads.begin(); it != registry->threads.end();) {
+        ThreadData *data = *it;
+        if (!data->finished.loadAcquire()) {
+            ++it;
+            continue;
+        }
+        if (data->generation == generation) {
+            for (auto statsIt = data->stats.constBegin(); statsIt != data->stats.constEnd(); ++statsIt)
+                registry->retired[statsIt.key()] += statsIt.value();
+            registry->retiredDropped += data->dropped;
+        }
+        delete data;
+        it = registry->threads.erase(it);
+    }
+}
+
+QHash<EventProfilerKey, EventProfilerStats> EventProfilerRecorder::snapshot()
+{
+    Registry *registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    retireFinishedThreads(registry);
+
+    const int generation = registry->generation.loadAcquire();
+    QHash<EventProfilerKey, EventProfilerStats> result = registry->retired;
+    foreach (ThreadData *data, registry->threads) {
+        QMutexLocker threadLock(&data->mutex);
+        if (data->generation != generation)
+            continue;
+        for (auto it = data->stats.constBegin(); it != data->stats.constEnd(); ++it)
+            result[it.key()] += it.value();
+    }
+    return result;
+}
+
+void EventProfilerRecorder::clear()
+{
+    Registry *registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    registry->retired.clear();
+    registry->retiredDropped = 0;
+    foreach (ThreadData *data, registry->threads)
+        data->maxPending = 0;
+    registry->generation.ref();
+}
+
+static QString threadName(QThread *thread)
+{
+    if (!thread->objectName().isEmpty())
+        return thread->objectName();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+        return QStringLiteral("Main Thread");
+    return QStringLiteral("%1 (0x%2)").arg(QString::fromLatin1(thread->metaObject()->className()),
+                                           QString::number(quintptr(thread), 16));
+}
+
+QVector<EventQueueDepth> EventProfilerRecorder::queueDepths()
+{
+    Registry *registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    retireFinishedThreads(registry);
+
+    QVector<EventQueueDepth> result;
+    result.reserve(registry->threads.size());
+    foreach (ThreadData *data, registry->threads) {
+        QThread *thread = data->thread;
+        if (!thread)
+            continue;
+
+        EventQueueDepth depth;
+        QThreadData *threadData = QThreadData::get2(thread);
+        {
+            QMutexLocker queueLock(&threadData->postEventList.mutex);
+            // entries before startOffset are already being delivered by sendPostedEvents()
+            depth.pending = std::max(0, threadData->postEventList.size()
+                                     - threadData->postEventList.startOffset);
+        }
+        data->maxPending = std::max(data->maxPending, depth.pending);
+        depth.maxPending = data->maxPending;
+        depth.threadName = threadName(thread);
+        result.push_back(depth);
+    }
+    return result;
+}
+
+quint64 EventProfilerRecorder::droppedEvents()
+{
+    Registry *registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    const int generation = registry->generation.loadAcquire();
+    quint64 dropped = registry->retiredDropped;
+    foreach (ThreadData *data, registry->threads) {
+        QMutexLocker threadLock(&data->mutex);
+        if (data->generation == generation)
+            dropped += data->dropped;
+    }
+    return dropped;
+}
@@ -0,0 +1,113 @@
+/*
+  eventprofilerrecorder.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTPROFILERRECORDER_H
+#define GAMMARAY_EVENTPROFILERRECORDER_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+struct QMetaObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Identifies the delivery of one event type to one receiver class. */
+struct EventProfilerKey
+{
+    EventProfilerKey();
+    bool operator==(const EventProfilerKey &other) const;
+
+    int eventType;
+    const QMetaObject *receiverType;
+};
+
+uint qHash(const EventProfilerKey &key);
+
+struct EventProfilerStats
+{
+    enum {
+        // bucket i holds durations in [2^i, 2^(i+1)) ns, the last one everything above
+        HistogramSize = 40
+    };
+
+    EventProfilerStats();
+    EventProfilerStats &operator+=(const EventProfilerStats &other);
+
+    void record(qint64 duration, qint64 exclusiveDuration);
+    /** Estimated duration in ns below which @p fraction of all deliveries finished.
+     *  This is the upper bound of the corresponding histogram bucket.
+     */
+    qint64 percentile(double fraction) const;
+
+    quint64 count;
+    qint64 totalTime; // ns
+    qint64 exclusiveTime; // ns
+    qint64 maxTime; // ns
+    quint32 histogram[HistogramSize];
+};
+
+/** Number of posted events waiting to be delivered in one thread. */
+struct EventQueueDepth
+{
+    EventQueueDepth();
+
+    QString threadName;
+    int pending;
+    int maxPending;
+};
+
+/** Measures event delivery times of all threads.
+ *  Qt has no hooks around QCoreApplication::notify(), we therefore use the
+ *  EventNotifyCallback to take over delivery and call notify() ourselves in
+ *  between taking the time. This replaces what notifyInternal2() would have
+ *  done afterwards, and it must be the only event notify callback doing so,
+ *  as Qt runs all of them and events would be delivered repeatedly otherwise.
+ *  Events of threads that don't require a QCoreApplication are not recorded,
+ *  Qt doesn't deliver them through notify().
+ */
+namespace EventProfilerRecorder {
+/** Returns @c false if another event notify callback already takes over delivery.
+ *  Callbacks registered after this are not detected, so nothing else may do so later on.
+ */
+bool install();
+void uninstall();
+
+/** Totals of all threads since the last clear(), can be called from any thread. */
+QHash<EventProfilerKey, EventProfilerStats> snapshot();
+void clear();
+
+/** Current posted event queue length of all threads that delivered events so far. */
+QVector<EventQueueDepth> queueDepths();
+
+/** Number of deliveries not recorded due to too many distinct event/receiver combinations. */
+quint64 droppedEvents();
+}
+}
+
+#endif // GAMMARAY_EVENTPROFILERRECORDER_H
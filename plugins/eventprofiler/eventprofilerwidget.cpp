@@ -0,0 +1,86 @@
+/*
+  eventprofilerwidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventprofilerwidget.h"
+#include "ui_eventprofilerwidget.h"
+#include "eventprofilerclient.h"
+#include "eventprofilermodel.h"
+
+#include <ui/searchlinecontroller.h>
+
+#include <common/objectbroker.h>
+
+#include <QSortFilterProxyModel>
+
+using namespace GammaRay;
+
+static QObject *eventProfilerClientFactory(const QString &, QObject *parent)
+{
+    return new EventProfilerClient(parent);
+}
+
+EventProfilerWidget::EventProfilerWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::EventProfilerWidget)
+    , m_stateManager(this)
+    , m_interface(0)
+{
+    ObjectBroker::registerClientObjectFactoryCallback<EventProfilerInterface *>(
+        eventProfilerClientFactory);
+    m_interface = ObjectBroker::object<EventProfilerInterface *>();
+
+    ui->setupUi(this);
+
+    auto sortModel = new QSortFilterProxyModel(this);
+    sortModel->setSourceModel(ObjectBroker::model(QStringLiteral(
+                                                      "com.kdab.GammaRay.EventProfilerModel")));
+    sortModel->setDynamicSortFilter(true);
+    sortModel->setSortRole(Qt::DisplayRole);
+    new SearchLineController(ui->searchLine, sortModel);
+
+    ui->profileView->header()->setObjectName("profileViewHeader");
+    ui->profileView->setDeferredResizeMode(EventProfilerModel::EventTypeColumn, QHeaderView::Stretch);
+    ui->profileView->setDeferredResizeMode(EventProfilerModel::ReceiverColumn, QHeaderView::Stretch);
+    for (int i = EventProfilerModel::CountColumn; i < EventProfilerModel::COLUMN_COUNT; ++i)
+        ui->profileView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    ui->profileView->setModel(sortModel);
+    ui->profileView->sortByColumn(EventProfilerModel::ExclusiveTimeColumn, Qt::DescendingOrder);
+
+    ui->queueView->header()->setObjectName("queueViewHeader");
+    ui->queueView->setDeferredResizeMode(EventQueueModel::ThreadColumn, QHeaderView::Stretch);
+    ui->queueView->setDeferredResizeMode(EventQueueModel::PendingColumn, QHeaderView::ResizeToContents);
+    ui->queueView->setDeferredResizeMode(EventQueueModel::MaxPendingColumn, QHeaderView::ResizeToContents);
+    ui->queueView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.EventQueueModel")));
+
+    m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "75%" << "25%");
+
+    connect(ui->clearButton, SIGNAL(clicked()), m_interface, SLOT(clear()));
+}
+
+EventProfilerWidget::~EventProfilerWidget()
+{
+}
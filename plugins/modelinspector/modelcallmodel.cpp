@@ -0,0 +1,467 @@
+/*
+  modelcallmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "modelcallmodel.h"
+
+using namespace GammaRay;
+
+static QString formatDuration(qint64 nsecs)
+{
+    if (nsecs >= 1000000000)
+        return QStringLiteral("%1 s").arg(nsecs / 1000000000.0, 0, 'g', 3);
+    if (nsecs >= 1000000)
+        return QStringLiteral("%1 ms").arg(nsecs / 1000000.0, 0, 'g', 3);
+    if (nsecs >= 1000)
+        return QStringLiteral("%1 us").arg(nsecs / 1000.0, 0, 'g', 3);
+    return QStringLiteral("%1 ns").arg(nsecs);
+}
+
+static const char *itemDataRoleName(int role)
+{
+    switch (role) {
+    case Qt::DisplayRole:
+        return "Qt::DisplayRole";
+    case Qt::DecorationRole:
+        return "Qt::DecorationRole";
+    case Qt::EditRole:
+        return "Qt::EditRole";
+    case Qt::ToolTipRole:
+        return "Qt::ToolTipRole";
+    case Qt::StatusTipRole:
+        return "Qt::StatusTipRole";
+    case Qt::WhatsThisRole:
+        return "Qt::WhatsThisRole";
+    case Qt::FontRole:
+        return "Qt::FontRole";
+    case Qt::TextAlignmentRole:
+        return "Qt::TextAlignmentRole";
+    case Qt::BackgroundRole:
+        return "Qt::BackgroundRole";
+    case Qt::ForegroundRole:
+        return "Qt::ForegroundRole";
+    case Qt::CheckStateRole:
+        return "Qt::CheckStateRole";
+    case Qt::AccessibleTextRole:
+        return "Qt::AccessibleTextRole";
+    case Qt::AccessibleDescriptionRole:
+        return "Qt::AccessibleDescriptionRole";
+    case Qt::SizeHintRole:
+        return "Qt::SizeHintRole";
+    case Qt::InitialSortOrderRole:
+        return "Qt::InitialSortOrderRole";
+    }
+    return 0;
+}
+
+ModelCallModel::ModelCallModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+ModelCallModel::~ModelCallModel()
+{
+}
+
+void ModelCallModel::setStats(const ModelCallStats &stats, const QHash<int, QByteArray> &roleNames)
+{
+    m_stats = stats;
+    m_roleNames = roleNames;
+
+    for (int method = ModelCallStats::DataMethod; method <= ModelCallStats::HeaderDataMethod; ++method) {
+        QVector<int> *knownRoles = roles(method);
+        QVector<int> newRoles;
+        const QHash<int, ModelCallLatency> *latencies = roleStats(method);
+        for (auto it = latencies->constBegin(); it != latencies->constEnd(); ++it) {
+            if (!knownRoles->contains(it.key()))
+                newRoles.push_back(it.key());
+        }
+
+        const QModelIndex parent = index(method, 0);
+        if (!knownRoles->isEmpty())
+            emit dataChanged(index(0, CallsColumn, parent),
+                             index(knownRoles->size() - 1, COLUMN_COUNT - 1, parent));
+        if (newRoles.isEmpty())
+            continue;
+        beginInsertRows(parent, knownRoles->size(), knownRoles->size() + newRoles.size() - 1);
+        *knownRoles += newRoles;
+        endInsertRows();
+    }
+
+    emit dataChanged(index(0, CallsColumn), index(ModelCallStats::MethodCount - 1, COLUMN_COUNT - 1));
+}
+
+void ModelCallModel::clear()
+{
+    beginResetModel();
+    m_stats = ModelCallStats();
+    m_dataRoles.clear();
+    m_headerDataRoles.clear();
+    endResetModel();
+}
+
+ModelCallLatency ModelCallModel::latency(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return ModelCallLatency();
+    if (index.internalId() == 0)
+        return m_stats.methods[index.row()];
+    const int method = index.internalId() - 1;
+    const QVector<int> &roles = method == ModelCallStats::DataMethod ? m_dataRoles : m_headerDataRoles;
+    return roleStats(method)->value(roles.at(index.row()));
+}
+
+const QHash<int, ModelCallLatency> *ModelCallModel::roleStats(int method) const
+{
+    return method == ModelCallStats::DataMethod ? &m_stats.dataRoles : &m_stats.headerDataRoles;
+}
+
+QVector<int> *ModelCallModel::roles(int method)
+{
+    return method == ModelCallStats::DataMethod ? &m_dataRoles : &m_headerDataRoles;
+}
+
+QString ModelCallModel::roleName(int role) const
+{
+    const QByteArray name = m_roleNames.value(role);
+    if (!name.isEmpty())
+        return QString::fromLatin1(name);
+    if (const char *itemDataRole = itemDataRoleName(role))
+        return QString::fromLatin1(itemDataRole);
+    return QString::number(role);
+}
+
+int ModelCallModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int ModelCallModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return ModelCallStats::MethodCount;
+    if (parent.internalId() != 0 || parent.column() != 0)
+        return 0;
+    if (parent.row() == ModelCallStats::DataMethod)
+        return m_dataRoles.size();
+    if (parent.row() == ModelCallStats::HeaderDataMethod)
+        return m_headerDataRoles.size();
+    return 0;
+}
+
+QModelIndex ModelCallModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+    // top-level rows have id 0, roles the method they belong to + 1
+    return createIndex(row, column, quintptr(parent.isValid() ? parent.row() + 1 : 0));
+}
+
+QModelIndex ModelCallModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == 0)
+        return QModelIndex();
+    return createIndex(int(child.internalId() - 1), 0, quintptr(0));
+}
+
+QVariant ModelCallModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        const ModelCallLatency l = latency(index);
+        switch (index.column()) {
+        case MethodColumn:
+            if (index.internalId() == 0)
+                return QString::fromLatin1(ModelCallStats::methodName(index.row()));
+            return roleName(index.internalId() - 1 == ModelCallStats::DataMethod
+                            ? m_dataRoles.at(index.row()) : m_headerDataRoles.at(index.row()));
+        case CallsColumn:
+            return l.count;
+        case TotalTimeColumn:
+            return qRound(l.total / 10000.0) / 100.0;
+        case AverageTimeColumn:
+            if (!l.count)
+                return QVariant();
+            return qRound(l.total / 10.0 / l.count) / 100.0;
+        case MaxTimeColumn:
+            return qRound(l.max / 10.0) / 100.0;
+        }
+    } else if (role == Qt::TextAlignmentRole && index.column() >= CallsColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant ModelCallModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case MethodColumn:
+            return tr("Method");
+        case CallsColumn:
+            return tr("Calls");
+        case TotalTimeColumn:
+            return tr("Total [ms]");
+        case AverageTimeColumn:
+            return tr("Average [us]");
+        case MaxTimeColumn:
+            return tr("Max [us]");
+        }
+    }
+    return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+ModelViewCallModel::ModelViewCallModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+ModelViewCallModel::~ModelViewCallModel()
+{
+}
+
+void ModelViewCallModel::setStats(const ModelCallStats &stats)
+{
+    QVector<QObject *> newViews;
+    for (auto it = stats.views.constBegin(); it != stats.views.constEnd(); ++it) {
+        if (!m_calls.contains(it.key()))
+            newViews.push_back(it.key());
+    }
+    m_calls = stats.views;
+
+    if (!m_views.isEmpty())
+        emit dataChanged(index(0, 0), index(m_views.size() - 1, COLUMN_COUNT - 1));
+    if (newViews.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_views.size(), m_views.size() + newViews.size() - 1);
+    m_views += newViews;
+    endInsertRows();
+}
+
+void ModelViewCallModel::clear()
+{
+    beginResetModel();
+    m_views.clear();
+    m_calls.clear();
+    endResetModel();
+}
+
+ModelViewCalls ModelViewCallModel::viewCalls(int row) const
+{
+    if (row < 0 || row >= m_views.size())
+        return ModelViewCalls();
+    return m_calls.value(m_views.at(row));
+}
+
+int ModelViewCallModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int ModelViewCallModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_views.size();
+}
+
+QVariant ModelViewCallModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        const ModelViewCalls calls = viewCalls(index.row());
+        switch (index.column()) {
+        case ViewColumn:
+            return calls.viewName;
+        case RepaintsColumn:
+            return calls.repaints;
+        case CallsPerRepaintColumn:
+            if (!calls.repaints)
+                return QVariant();
+            return qRound(calls.calls * 10.0 / calls.repaints) / 10.0;
+        case MaxCallsColumn:
+            return calls.maxCalls;
+        case TimePerRepaintColumn:
+            if (!calls.repaints)
+                return QVariant();
+            return qRound(calls.time / 10000.0 / calls.repaints) / 100.0;
+        }
+    } else if (role == Qt::TextAlignmentRole && index.column() >= RepaintsColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant ModelViewCallModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ViewColumn:
+            return tr("View");
+        case RepaintsColumn:
+            return tr("Repaints");
+        case CallsPerRepaintColumn:
+            return tr("Calls/Repaint");
+        case MaxCallsColumn:
+            return tr("Max Calls");
+        case TimePerRepaintColumn:
+            return tr("Model Time/Repaint [ms]");
+        }
+    }
+    if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        switch (section) {
+        case RepaintsColumn:
+            return tr("Repaints of the view that called into the model.");
+        case TimePerRepaintColumn:
+            return tr("Average time spent in the model per repaint.");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+ModelCallHistogramModel::ModelCallHistogramModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_isLatency(true)
+{
+}
+
+ModelCallHistogramModel::~ModelCallHistogramModel()
+{
+}
+
+void ModelCallHistogramModel::setLatency(const ModelCallLatency &latency)
+{
+    QVector<QString> labels;
+    QVector<quint32> counts;
+    for (int i = 0; i < ModelCallLatency::Buckets; ++i) {
+        labels.push_back(i == ModelCallLatency::Buckets - 1
+                         ? tr(">= %1").arg(formatDuration(ModelCallLatency::bucketUpperBound(i - 1)))
+                         : tr("< %1").arg(formatDuration(ModelCallLatency::bucketUpperBound(i))));
+        counts.push_back(latency.histogram[i]);
+    }
+    setBuckets(labels, counts, true);
+}
+
+void ModelCallHistogramModel::setViewCalls(const ModelViewCalls &calls)
+{
+    QVector<QString> labels;
+    QVector<quint32> counts;
+    for (int i = 0; i < ModelViewCalls::Buckets; ++i) {
+        const quint32 lower = i == 0 ? 1 : ModelViewCalls::bucketUpperBound(i - 1);
+        if (i == ModelViewCalls::Buckets - 1)
+            labels.push_back(tr(">= %1").arg(lower));
+        else if (i == 0)
+            labels.push_back(QString::number(lower));
+        else
+            labels.push_back(tr("%1 - %2").arg(lower).arg(ModelViewCalls::bucketUpperBound(i) - 1));
+        counts.push_back(calls.histogram[i]);
+    }
+    setBuckets(labels, counts, false);
+}
+
+void ModelCallHistogramModel::setBuckets(const QVector<QString> &labels,
+                                         const QVector<quint32> &counts, bool isLatency)
+{
+    // only show the range that actually has entries
+    int first = 0;
+    while (first < counts.size() && !counts.at(first))
+        ++first;
+    int last = counts.size() - 1;
+    while (last > first && !counts.at(last))
+        --last;
+
+    const QVector<QString> newLabels = first < counts.size() ? labels.mid(first, last - first + 1) : QVector<QString>();
+    if (newLabels == m_labels && isLatency == m_isLatency) {
+        m_counts = counts.mid(first, newLabels.size());
+        if (!m_counts.isEmpty())
+            emit dataChanged(index(0, CountColumn), index(m_counts.size() - 1, CountColumn));
+        return;
+    }
+
+    beginResetModel();
+    m_isLatency = isLatency;
+    m_labels = newLabels;
+    m_counts = counts.mid(first, newLabels.size());
+    endResetModel();
+}
+
+void ModelCallHistogramModel::clear()
+{
+    beginResetModel();
+    m_labels.clear();
+    m_counts.clear();
+    endResetModel();
+}
+
+int ModelCallHistogramModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int ModelCallHistogramModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_counts.size();
+}
+
+QVariant ModelCallHistogramModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case BucketColumn:
+            return m_labels.at(index.row());
+        case CountColumn:
+            return m_counts.at(index.row());
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant ModelCallHistogramModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case BucketColumn:
+            return m_isLatency ? tr("Latency") : tr("Calls per Repaint");
+        case CountColumn:
+            return m_isLatency ? tr("Calls") : tr("Repaints");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
@@ -0,0 +1,146 @@
+/*
+  modelcallmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_MODELINSPECTOR_MODELCALLMODEL_H
+#define GAMMARAY_MODELINSPECTOR_MODELCALLMODEL_H
+
+#include "modelcallprofiler.h"
+
+#include <QAbstractItemModel>
+#include <QVector>
+
+namespace GammaRay {
+/** Calls per model method, with the data() and headerData() calls split up by role. */
+class ModelCallModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        MethodColumn,
+        CallsColumn,
+        TotalTimeColumn,
+        AverageTimeColumn,
+        MaxTimeColumn,
+        COLUMN_COUNT
+    };
+
+    explicit ModelCallModel(QObject *parent = 0);
+    ~ModelCallModel();
+
+    /** Update to @p stats, using @p roleNames to label roles. */
+    void setStats(const ModelCallStats &stats, const QHash<int, QByteArray> &roleNames);
+    void clear();
+    /** Latency distribution of the method or role at @p index. */
+    ModelCallLatency latency(const QModelIndex &index) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QModelIndex index(int row, int column,
+                      const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QModelIndex parent(const QModelIndex &child) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    const QHash<int, ModelCallLatency> *roleStats(int method) const;
+    QVector<int> *roles(int method);
+    QString roleName(int role) const;
+
+    ModelCallStats m_stats;
+    QHash<int, QByteArray> m_roleNames;
+    // in order of appearance, so updates only ever append rows
+    QVector<int> m_dataRoles;
+    QVector<int> m_headerDataRoles;
+};
+
+/** Calls views made into a model per repaint. */
+class ModelViewCallModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        ViewColumn,
+        RepaintsColumn,
+        CallsPerRepaintColumn,
+        MaxCallsColumn,
+        TimePerRepaintColumn,
+        COLUMN_COUNT
+    };
+
+    explicit ModelViewCallModel(QObject *parent = 0);
+    ~ModelViewCallModel();
+
+    void setStats(const ModelCallStats &stats);
+    void clear();
+    ModelViewCalls viewCalls(int row) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    QVector<QObject *> m_views;
+    QHash<QObject *, ModelViewCalls> m_calls;
+};
+
+/** Histogram of either call latencies or calls per repaint. */
+class ModelCallHistogramModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        BucketColumn,
+        CountColumn,
+        COLUMN_COUNT
+    };
+
+    explicit ModelCallHistogramModel(QObject *parent = 0);
+    ~ModelCallHistogramModel();
+
+    void setLatency(const ModelCallLatency &latency);
+    void setViewCalls(const ModelViewCalls &calls);
+    void clear();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    void setBuckets(const QVector<QString> &labels, const QVector<quint32> &counts, bool isLatency);
+
+    QVector<QString> m_labels;
+    QVector<quint32> m_counts;
+    bool m_isLatency;
+};
+}
+
+#endif // GAMMARAY_MODELINSPECTOR_MODELCALLMODEL_H
@@ -0,0 +1,581 @@
+/*
+  modelcallprofiler.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// krazy:excludeall=cpp since lots of low-level stuff in here
+
+#include "modelcallprofiler.h"
+
+#include <core/util.h>
+
+#include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QMutex>
+#include <QThread>
+
+#include <cstring>
+
+// patching virtual method tables relies on the Itanium C++ ABI, and we need to
+// know the memory protection of the table to restore it afterwards
+#if defined(Q_OS_LINUX) && defined(__GNUC__)
+#define HAVE_VTABLE_PATCHING
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace GammaRay;
+
+ModelCallLatency::ModelCallLatency()
+    : count(0)
+    , total(0)
+    , max(0)
+{
+    memset(histogram, 0, sizeof(histogram));
+}
+
+void ModelCallLatency::add(qint64 nsecs)
+{
+    ++count;
+    total += nsecs;
+    max = qMax(max, nsecs);
+    int bucket = 0;
+    while (bucket < Buckets - 1 && (qint64(1) << (bucket + 1)) <= nsecs)
+        ++bucket;
+    ++histogram[bucket];
+}
+
+qint64 ModelCallLatency::bucketUpperBound(int bucket)
+{
+    return qint64(1) << (bucket + 1);
+}
+
+ModelViewCalls::ModelViewCalls()
+    : repaints(0)
+    , calls(0)
+    , maxCalls(0)
+    , time(0)
+{
+    memset(histogram, 0, sizeof(histogram));
+}
+
+void ModelViewCalls::addRepaint(quint32 callCount, qint64 nsecs)
+{
+    ++repaints;
+    calls += callCount;
+    maxCalls = qMax(maxCalls, callCount);
+    time += nsecs;
+    int bucket = 0;
+    while (bucket < Buckets - 1 && (quint32(1) << (bucket + 1)) <= callCount)
+        ++bucket;
+    ++histogram[bucket];
+}
+
+quint32 ModelViewCalls::bucketUpperBound(int bucket)
+{
+    return quint32(1) << (bucket + 1);
+}
+
+const char *ModelCallStats::methodName(int method)
+{
+    switch (method) {
+    case IndexMethod:
+        return "index";
+    case ParentMethod:
+        return "parent";
+    case RowCountMethod:
+        return "rowCount";
+    case ColumnCountMethod:
+        return "columnCount";
+    case HasChildrenMethod:
+        return "hasChildren";
+    case DataMethod:
+        return "data";
+    case HeaderDataMethod:
+        return "headerData";
+    case FlagsMethod:
+        return "flags";
+    }
+    return "";
+}
+
+// guards everything below as well as the profiler's model hash, trampolines can be
+// called from any thread for unprofiled instances of a patched class
+Q_GLOBAL_STATIC(QMutex, s_mutex)
+static ModelCallProfiler *s_profiler = 0;
+
+#ifdef HAVE_VTABLE_PATCHING
+
+namespace {
+typedef QModelIndex (QAbstractItemModel::*IndexFunc)(int, int, const QModelIndex &) const;
+typedef QModelIndex (QAbstractItemModel::*ParentFunc)(const QModelIndex &) const;
+typedef int (QAbstractItemModel::*CountFunc)(const QModelIndex &) const;
+typedef bool (QAbstractItemModel::*HasChildrenFunc)(const QModelIndex &) const;
+typedef QVariant (QAbstractItemModel::*DataFunc)(const QModelIndex &, int) const;
+typedef QVariant (QAbstractItemModel::*HeaderDataFunc)(int, Qt::Orientation, int) const;
+typedef Qt::ItemFlags (QAbstractItemModel::*FlagsFunc)(const QModelIndex &) const;
+
+// Itanium ABI representation of a pointer to member function
+struct MemberFunction
+{
+    quintptr ptr;
+    qptrdiff adj;
+};
+
+template<typename Func>
+int vtableSlot(Func func)
+{
+    MemberFunction mf;
+    Q_STATIC_ASSERT(sizeof(Func) == sizeof(MemberFunction));
+    memcpy(&mf, &func, sizeof(mf));
+#ifdef Q_PROCESSOR_ARM
+    // the ARM variant marks virtual functions in adj, as ptr can be odd for Thumb code
+    if (!(mf.adj & 1))
+        return -1;
+    return mf.ptr / sizeof(void *);
+#else
+    if (!(mf.ptr & 1))
+        return -1;
+    return (mf.ptr - 1) / sizeof(void *);
+#endif
+}
+
+template<typename Func>
+void *functionAddress(Func func)
+{
+    MemberFunction mf;
+    memcpy(&mf, &func, sizeof(mf));
+    return reinterpret_cast<void *>(mf.ptr);
+}
+
+template<typename Func>
+Func fromAddress(void *address)
+{
+    MemberFunction mf;
+    mf.ptr = reinterpret_cast<quintptr>(address);
+    mf.adj = 0;
+    Func func;
+    memcpy(&func, &mf, sizeof(func));
+    return func;
+}
+
+struct PatchedVTable
+{
+    void *original[ModelCallStats::MethodCount];
+    int profiledModels;
+};
+
+// entries are never removed, a trampoline might still be running in another thread
+typedef QHash<void **, PatchedVTable> PatchedVTables;
+Q_GLOBAL_STATIC(PatchedVTables, s_patchedVTables)
+
+// one call into a model, looks up the original implementation and records the call
+class ModelCall
+{
+public:
+    ModelCall(const void *object, int method, int role = -1)
+        : m_model(static_cast<const QAbstractItemModel *>(object))
+        , m_method(method)
+        , m_role(role)
+    {
+        void **vtable = *static_cast<void **const *>(object);
+        QMutexLocker lock(s_mutex());
+        const auto it = s_patchedVTables()->constFind(vtable);
+        Q_ASSERT(it != s_patchedVTables()->constEnd());
+        m_original = it->original[method];
+        m_timer.start();
+    }
+
+    ~ModelCall()
+    {
+        const qint64 nsecs = m_timer.nsecsElapsed();
+        QMutexLocker lock(s_mutex());
+        if (s_profiler)
+            s_profiler->record(m_model, m_method, m_role, nsecs);
+    }
+
+    const QAbstractItemModel *model() const
+    {
+        return m_model;
+    }
+
+    template<typename Func>
+    Func original() const
+    {
+        return fromAddress<Func>(m_original);
+    }
+
+private:
+    const QAbstractItemModel *m_model;
+    int m_method;
+    int m_role;
+    void *m_original;
+    QElapsedTimer m_timer;
+};
+
+// the member functions of this replace the model's virtual methods, 'this' is the model
+class ModelTrampolines
+{
+public:
+    QModelIndex index(int row, int column, const QModelIndex &parent) const
+    {
+        ModelCall call(this, ModelCallStats::IndexMethod);
+        return (call.model()->*call.original<IndexFunc>())(row, column, parent);
+    }
+
+    QModelIndex parent(const QModelIndex &child) const
+    {
+        ModelCall call(this, ModelCallStats::ParentMethod);
+        return (call.model()->*call.original<ParentFunc>())(child);
+    }
+
+    int rowCount(const QModelIndex &parent) const
+    {
+        ModelCall call(this, ModelCallStats::RowCountMethod);
+        return (call.model()->*call.original<CountFunc>())(parent);
+    }
+
+    int columnCount(const QModelIndex &parent) const
+    {
+        ModelCall call(this, ModelCallStats::ColumnCountMethod);
+        return (call.model()->*call.original<CountFunc>())(parent);
+    }
+
+    bool hasChildren(const QModelIndex &parent) const
+    {
+        ModelCall call(this, ModelCallStats::HasChildrenMethod);
+        return (call.model()->*call.original<HasChildrenFunc>())(parent);
+    }
+
+    QVariant data(const QModelIndex &index, int role) const
+    {
+        ModelCall call(this, ModelCallStats::DataMethod, role);
+        return (call.model()->*call.original<DataFunc>())(index, role);
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const
+    {
+        ModelCall call(this, ModelCallStats::HeaderDataMethod, role);
+        return (call.model()->*call.original<HeaderDataFunc>())(section, orientation, role);
+    }
+
+    Qt::ItemFlags flags(const QModelIndex &index) const
+    {
+        ModelCall call(this, ModelCallStats::FlagsMethod);
+        return (call.model()->*call.original<FlagsFunc>())(index);
+    }
+};
+
+struct VTableLayout
+{
+    VTableLayout()
+    {
+        slots[ModelCallStats::IndexMethod] = vtableSlot<IndexFunc>(&QAbstractItemModel::index);
+        slots[ModelCallStats::ParentMethod] = vtableSlot<ParentFunc>(&QAbstractItemModel::parent);
+        slots[ModelCallStats::RowCountMethod] = vtableSlot<CountFunc>(&QAbstractItemModel::rowCount);
+        slots[ModelCallStats::ColumnCountMethod] = vtableSlot<CountFunc>(&QAbstractItemModel::columnCount);
+        slots[ModelCallStats::HasChildrenMethod] = vtableSlot<HasChildrenFunc>(&QAbstractItemModel::hasChildren);
+        slots[ModelCallStats::DataMethod] = vtableSlot<DataFunc>(&QAbstractItemModel::data);
+        slots[ModelCallStats::HeaderDataMethod] = vtableSlot<HeaderDataFunc>(&QAbstractItemModel::headerData);
+        slots[ModelCallStats::FlagsMethod] = vtableSlot<FlagsFunc>(&QAbstractItemModel::flags);
+
+        trampolines[ModelCallStats::IndexMethod] = functionAddress(&ModelTrampolines::index);
+        trampolines[ModelCallStats::ParentMethod] = functionAddress(&ModelTrampolines::parent);
+        trampolines[ModelCallStats::RowCountMethod] = functionAddress(&ModelTrampolines::rowCount);
+        trampolines[ModelCallStats::ColumnCountMethod] = functionAddress(&ModelTrampolines::columnCount);
+        trampolines[ModelCallStats::HasChildrenMethod] = functionAddress(&ModelTrampolines::hasChildren);
+        trampolines[ModelCallStats::DataMethod] = functionAddress(&ModelTrampolines::data);
+        trampolines[ModelCallStats::HeaderDataMethod] = functionAddress(&ModelTrampolines::headerData);
+        trampolines[ModelCallStats::FlagsMethod] = functionAddress(&ModelTrampolines::flags);
+
+        minSlot = maxSlot = slots[0];
+        valid = true;
+        for (int i = 0; i < ModelCallStats::MethodCount; ++i) {
+            valid = valid && slots[i] >= 0;
+            minSlot = qMin(minSlot, slots[i]);
+            maxSlot = qMax(maxSlot, slots[i]);
+        }
+    }
+
+    int slots[ModelCallStats::MethodCount];
+    void *trampolines[ModelCallStats::MethodCount];
+    int minSlot;
+    int maxSlot;
+    bool valid;
+};
+Q_GLOBAL_STATIC(VTableLayout, s_layout)
+
+// protection of the mapping containing [begin, end), -1 if not a single mapping
+int memoryProtection(quintptr begin, quintptr end)
+{
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (!maps)
+        return -1;
+
+    int protection = -1;
+    char line[512];
+    while (fgets(line, sizeof(line), maps)) {
+        unsigned long long mapBegin, mapEnd;
+        char perms[5];
+        if (sscanf(line, "%llx-%llx %4s", &mapBegin, &mapEnd, perms) != 3)
+            continue;
+        if (begin < mapBegin || begin >= mapEnd)
+            continue;
+        if (end <= mapEnd) {
+            protection = (perms[0] == 'r' ? PROT_READ : 0)
+                         | (perms[1] == 'w' ? PROT_WRITE : 0)
+                         | (perms[2] == 'x' ? PROT_EXEC : 0);
+        }
+        break;
+    }
+    fclose(maps);
+    return protection;
+}
+
+bool writeVTable(void **vtable, void *const *functions)
+{
+    const VTableLayout *layout = s_layout();
+    const quintptr pageSize = sysconf(_SC_PAGESIZE);
+    const quintptr begin = reinterpret_cast<quintptr>(vtable + layout->minSlot) & ~(pageSize - 1);
+    const quintptr end = reinterpret_cast<quintptr>(vtable + layout->maxSlot + 1);
+
+    const int protection = memoryProtection(begin, end);
+    if (protection < 0)
+        return false;
+    void *mem = reinterpret_cast<void *>(begin);
+    if (!(protection & PROT_WRITE) && mprotect(mem, end - begin, protection | PROT_WRITE) != 0)
+        return false;
+
+    for (int i = 0; i < ModelCallStats::MethodCount; ++i)
+        vtable[layout->slots[i]] = functions[i];
+
+    if (!(protection & PROT_WRITE))
+        mprotect(mem, end - begin, protection);
+    return true;
+}
+}
+
+#endif // HAVE_VTABLE_PATCHING
+
+// installs the trampolines into the vtable of @p model, if not done already
+static bool patchModel(const QAbstractItemModel *model, void **vtable)
+{
+#ifdef HAVE_VTABLE_PATCHING
+    Q_UNUSED(model);
+    auto it = s_patchedVTables()->find(vtable);
+    if (it == s_patchedVTables()->end()) {
+        PatchedVTable patch;
+        for (int i = 0; i < ModelCallStats::MethodCount; ++i)
+            patch.original[i] = vtable[s_layout()->slots[i]];
+        patch.profiledModels = 0;
+        it = s_patchedVTables()->insert(vtable, patch);
+    }
+    if (it->profiledModels == 0 && !writeVTable(vtable, s_layout()->trampolines))
+        return false;
+    ++it->profiledModels;
+    return true;
+#else
+    Q_UNUSED(model);
+    Q_UNUSED(vtable);
+    return false;
+#endif
+}
+
+// restores the original vtable once the last profiled instance is gone
+static void unpatchModel(void **vtable)
+{
+#ifdef HAVE_VTABLE_PATCHING
+    auto it = s_patchedVTables()->find(vtable);
+    if (it == s_patchedVTables()->end() || it->profiledModels == 0)
+        return;
+    if (--it->profiledModels == 0)
+        writeVTable(vtable, it->original);
+#else
+    Q_UNUSED(vtable);
+#endif
+}
+
+ModelCallProfiler::ModelCallProfiler(QObject *parent)
+    : QObject(parent)
+    , m_paintingView(0)
+{
+    QMutexLocker lock(s_mutex());
+    Q_ASSERT(!s_profiler);
+    s_profiler = this;
+}
+
+ModelCallProfiler::~ModelCallProfiler()
+{
+    QMutexLocker lock(s_mutex());
+    foreach (const ProfiledModel &model, m_models)
+        unpatchModel(model.vtable);
+    m_models.clear();
+    m_profiling.storeRelease(0);
+    s_profiler = 0;
+}
+
+bool ModelCallProfiler::isSupported()
+{
+#ifdef HAVE_VTABLE_PATCHING
+    return s_layout()->valid;
+#else
+    return false;
+#endif
+}
+
+bool ModelCallProfiler::isProfiling(QAbstractItemModel *model) const
+{
+    QMutexLocker lock(s_mutex());
+    return m_models.contains(model);
+}
+
+bool ModelCallProfiler::setProfiling(QAbstractItemModel *model, bool enabled)
+{
+    if (!model)
+        return false;
+    if (!enabled) {
+        disconnect(model, SIGNAL(destroyed(QObject*)), this, SLOT(modelDestroyed(QObject*)));
+        removeModel(model);
+        return true;
+    }
+    if (!isSupported() || model->thread() != thread())
+        return false;
+
+    {
+        QMutexLocker lock(s_mutex());
+        if (m_models.contains(model))
+            return true;
+        // during destruction the vtable changes, so we need to remember the one we patched
+        void **vtable = *reinterpret_cast<void **const *>(model);
+        if (!patchModel(model, vtable))
+            return false;
+        ProfiledModel profiledModel;
+        profiledModel.vtable = vtable;
+        profiledModel.paintCalls = 0;
+        profiledModel.paintTime = 0;
+        m_models.insert(model, profiledModel);
+        m_profiling.storeRelease(1);
+    }
+
+    connect(model, SIGNAL(destroyed(QObject*)), this, SLOT(modelDestroyed(QObject*)));
+    return true;
+}
+
+void ModelCallProfiler::removeModel(const QAbstractItemModel *model)
+{
+    QMutexLocker lock(s_mutex());
+    const auto it = m_models.find(model);
+    if (it == m_models.end())
+        return;
+    unpatchModel(it->vtable);
+    m_models.erase(it);
+    if (m_models.isEmpty()) {
+        // no calls are recorded anymore, so there is nothing left to account to the view
+        m_paintingView = 0;
+        m_profiling.storeRelease(0);
+    }
+}
+
+void ModelCallProfiler::modelDestroyed(QObject *model)
+{
+    removeModel(static_cast<QAbstractItemModel *>(model));
+}
+
+ModelCallStats ModelCallProfiler::stats(QAbstractItemModel *model) const
+{
+    QMutexLocker lock(s_mutex());
+    return m_models.value(model).stats;
+}
+
+void ModelCallProfiler::clear(QAbstractItemModel *model)
+{
+    QMutexLocker lock(s_mutex());
+    const auto it = m_models.find(model);
+    if (it != m_models.end())
+        it->stats = ModelCallStats();
+}
+
+void ModelCallProfiler::record(const QAbstractItemModel *model, int method, int role,
+                               qint64 nsecs)
+{
+    const auto it = m_models.find(model);
+    if (it == m_models.end())
+        return;
+
+    ModelCallStats &stats = it->stats;
+    stats.methods[method].add(nsecs);
+    if (method == ModelCallStats::DataMethod)
+        stats.dataRoles[role].add(nsecs);
+    else if (method == ModelCallStats::HeaderDataMethod)
+        stats.headerDataRoles[role].add(nsecs);
+
+    if (m_paintingView && QThread::currentThread() == thread()) {
+        ++it->paintCalls;
+        it->paintTime += nsecs;
+    }
+}
+
+bool ModelCallProfiler::eventFilter(QObject *receiver, QEvent *event)
+{
+    // this sees every event of the application, don't serialize them while idle
+    if (!m_profiling.loadAcquire())
+        return false;
+
+    QMutexLocker lock(s_mutex());
+    // the view's paint event is fully processed by the time we see the next event
+    if (m_paintingView)
+        finishRepaint();
+
+    if (event->type() != QEvent::Paint || m_models.isEmpty())
+        return false;
+    // item views paint on their viewport
+    QObject *view = receiver->parent();
+    if (!view || !view->inherits("QAbstractItemView"))
+        return false;
+
+    m_paintingView = view;
+    for (auto it = m_models.begin(); it != m_models.end(); ++it) {
+        it->paintCalls = 0;
+        it->paintTime = 0;
+    }
+    return false;
+}
+
+void ModelCallProfiler::finishRepaint()
+{
+    for (auto it = m_models.begin(); it != m_models.end(); ++it) {
+        if (!it->paintCalls)
+            continue;
+        auto viewIt = it->stats.views.find(m_paintingView);
+        if (viewIt == it->stats.views.end()) {
+            viewIt = it->stats.views.insert(m_paintingView, ModelViewCalls());
+            viewIt->viewName = Util::displayString(m_paintingView);
+        }
+        viewIt->addRepaint(it->paintCalls, it->paintTime);
+    }
+    m_paintingView = 0;
+}
@@ -0,0 +1,161 @@
+/*
+  modelcallprofiler.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_MODELINSPECTOR_MODELCALLPROFILER_H
+#define GAMMARAY_MODELINSPECTOR_MODELCALLPROFILER_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Latency distribution of calls to one model method. */
+struct ModelCallLatency
+{
+    enum {
+        // bucket i holds calls taking [2^i, 2^(i+1)) ns, the last one everything above
+        Buckets = 32
+    };
+
+    ModelCallLatency();
+    void add(qint64 nsecs);
+    static qint64 bucketUpperBound(int bucket);
+
+    quint64 count;
+    qint64 total; // ns
+    qint64 max; // ns
+    quint32 histogram[Buckets];
+};
+
+/** Calls made into a model by one view while repainting. */
+struct ModelViewCalls
+{
+    enum {
+        // bucket i holds repaints with [2^i, 2^(i+1)) calls, the last one everything above
+        Buckets = 24
+    };
+
+    ModelViewCalls();
+    void addRepaint(quint32 calls, qint64 nsecs);
+    static quint32 bucketUpperBound(int bucket);
+
+    QString viewName;
+    quint64 repaints;
+    quint64 calls;
+    quint32 maxCalls;
+    qint64 time; // ns spent in the model
+    quint32 histogram[Buckets];
+};
+
+/** Recorded calls into one model. */
+struct ModelCallStats
+{
+    enum Method {
+        IndexMethod,
+        ParentMethod,
+        RowCountMethod,
+        ColumnCountMethod,
+        HasChildrenMethod,
+        DataMethod,
+        HeaderDataMethod,
+        FlagsMethod,
+        MethodCount
+    };
+    static const char *methodName(int method);
+
+    ModelCallLatency methods[MethodCount];
+    QHash<int, ModelCallLatency> dataRoles;
+    QHash<int, ModelCallLatency> headerDataRoles;
+    QHash<QObject *, ModelViewCalls> views;
+};
+
+/** Records count and latency of calls into selected models.
+ *
+ *  Views hold on to the models they show, so wrapping a model into a proxy would
+ *  not see any of their calls. Instead, the virtual method table of the model's
+ *  class is patched to go through recording trampolines while at least one
+ *  instance of that class is profiled. This relies on the Itanium C++ ABI and is
+ *  therefore not available everywhere, see isSupported().
+ *
+ *  As a consequence, calls into all instances of a patched class, in all threads,
+ *  go through the trampolines and are serialized by a global lock, even though only
+ *  those into profiled models are recorded.
+ *
+ *  Item views are identified by repaints of their viewport, calls into a
+ *  profiled model from a paint event of the viewport until the next event
+ *  seen by the probe are accounted to the view. Install this as a global
+ *  event filter of the probe for that.
+ */
+class ModelCallProfiler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ModelCallProfiler(QObject *parent = 0);
+    ~ModelCallProfiler();
+
+    static bool isSupported();
+
+    bool isProfiling(QAbstractItemModel *model) const;
+    /** Returns @c false if @p model can't be profiled, e.g. as it lives in another thread. */
+    bool setProfiling(QAbstractItemModel *model, bool enabled);
+    ModelCallStats stats(QAbstractItemModel *model) const;
+    void clear(QAbstractItemModel *model);
+
+    /// internal, called from the trampolines with the profiler lock held
+    void record(const QAbstractItemModel *model, int method, int role, qint64 nsecs);
+
+protected:
+    bool eventFilter(QObject *receiver, QEvent *event) Q_DECL_OVERRIDE;
+
+private slots:
+    void modelDestroyed(QObject *model);
+
+private:
+    void removeModel(const QAbstractItemModel *model);
+    /// accounts the calls made since the paint event of the current view, with the lock held
+    void finishRepaint();
+
+    struct ProfiledModel
+    {
+        void **vtable;
+        ModelCallStats stats;
+        quint32 paintCalls;
+        qint64 paintTime;
+    };
+    QHash<const QAbstractItemModel *, ProfiledModel> m_models;
+    QObject *m_paintingView;
+    /// mirrors !m_models.isEmpty(), so eventFilter() can skip the lock while idle
+    QAtomicInt m_profiling;
+};
+}
+
+#endif // GAMMARAY_MODELINSPECTOR_MODELCALLPROFILER_H
@@ -0,0 +1,402 @@
+/*
+  modelchecker.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "modelchecker.h"
+
+#include <QAbstractItemModel>
+#include <QElapsedTimer>
+
+using namespace GammaRay;
+
+#define MODEL_CHECK(cond) (!(cond) ? failure(__LINE__, #cond) : qt_noop())
+
+// columns validated per row, wide models are only checked partially
+static const int MaxColumns = 32;
+// rows per sampled range, and how deep sampling descends into trees
+static const int SampleRows = 16;
+static const int MaxSampleDepth = 8;
+// upper limit for queued ranges, beyond that changes are left to sampling
+static const int MaxQueuedRanges = 1024;
+
+ModelChecker::ModelChecker(QAbstractItemModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_generation(0)
+    , m_changingLayout(false)
+{
+    connect(model, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)),
+            this, SLOT(rowsAboutToBeInserted(QModelIndex,int,int)));
+    connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(rowsInserted(QModelIndex,int,int)));
+    connect(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+            this, SLOT(rowsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            this, SLOT(rowsRemoved(QModelIndex,int,int)));
+    connect(model, SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)),
+            this, SLOT(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)));
+    connect(model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+            this, SLOT(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    connect(model, SIGNAL(columnsAboutToBeInserted(QModelIndex,int,int)),
+            this, SLOT(columnsAboutToBeInserted(QModelIndex,int,int)));
+    connect(model, SIGNAL(columnsInserted(QModelIndex,int,int)),
+            this, SLOT(columnsInserted(QModelIndex,int,int)));
+    connect(model, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)),
+            this, SLOT(columnsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(model, SIGNAL(columnsRemoved(QModelIndex,int,int)),
+            this, SLOT(columnsRemoved(QModelIndex,int,int)));
+    connect(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+            this, SLOT(dataChanged(QModelIndex,QModelIndex)));
+    connect(model, SIGNAL(headerDataChanged(Qt::Orientation,int,int)),
+            this, SLOT(headerDataChanged(Qt::Orientation,int,int)));
+    connect(model, SIGNAL(layoutAboutToBeChanged()), this, SLOT(layoutAboutToBeChanged()));
+    connect(model, SIGNAL(layoutChanged()), this, SLOT(layoutChanged()));
+    connect(model, SIGNAL(modelAboutToBeReset()), this, SLOT(modelAboutToBeReset()));
+    connect(model, SIGNAL(modelReset()), this, SLOT(modelReset()));
+}
+
+ModelChecker::~ModelChecker()
+{
+}
+
+QAbstractItemModel *ModelChecker::model() const
+{
+    return m_model;
+}
+
+int ModelChecker::failureCount() const
+{
+    return m_failures.size();
+}
+
+void ModelChecker::failure(int line, const char *message)
+{
+    if (m_failures.contains(line))
+        return;
+    const QString msg = QString::fromLatin1(message);
+    m_failures.insert(line, msg);
+    emit failed(msg);
+}
+
+void ModelChecker::process(qint64 budget)
+{
+    // row numbers are meaningless while the layout changes
+    if (m_changingLayout)
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (m_queue.isEmpty())
+        sampleRows();
+
+    while (!m_queue.isEmpty() && timer.nsecsElapsed() < budget) {
+        RowRange range = m_queue.last();
+        m_queue.pop_back();
+        if (!range.isTopLevel && !range.parent.isValid())
+            continue; // parent got removed meanwhile
+
+        const QModelIndex parent = range.parent;
+        const int rowCount = m_model->rowCount(parent);
+        if (range.first >= rowCount)
+            continue;
+        const int columnCount = m_model->columnCount(parent);
+        MODEL_CHECK(!m_model->hasIndex(rowCount, 0, parent));
+        MODEL_CHECK(!m_model->hasIndex(0, columnCount, parent));
+
+        const int generation = m_generation;
+        for (int column = 0; column < qMin(columnCount, MaxColumns); ++column)
+            checkIndex(parent, range.first, column);
+
+        // the model might have been reset by calling into it
+        if (++range.first <= range.last && generation == m_generation)
+            m_queue.push_back(range);
+    }
+}
+
+void ModelChecker::queueRows(const QModelIndex &parent, int first, int last)
+{
+    first = qMax(first, 0);
+    if (last < first || m_queue.size() >= MaxQueuedRanges)
+        return;
+
+    if (!m_queue.isEmpty()) {
+        RowRange &prev = m_queue.last();
+        if (prev.parent == parent && prev.isTopLevel == !parent.isValid()
+            && first <= prev.last + 1 && last >= prev.first - 1) {
+            prev.first = qMin(prev.first, first);
+            prev.last = qMax(prev.last, last);
+            return;
+        }
+    }
+
+    RowRange range;
+    range.parent = parent;
+    range.isTopLevel = !parent.isValid();
+    range.first = first;
+    range.last = last;
+    m_queue.push_back(range);
+}
+
+void ModelChecker::sampleRows()
+{
+    QModelIndex parent;
+    for (int depth = 0; depth < MaxSampleDepth; ++depth) {
+        const int rowCount = m_model->rowCount(parent);
+        if (rowCount <= 0)
+            return;
+        const int row = qrand() % rowCount;
+        const QModelIndex index = m_model->index(row, 0, parent);
+        if (depth + 1 < MaxSampleDepth && (qrand() & 1) && m_model->hasChildren(index)) {
+            parent = index;
+            continue;
+        }
+        queueRows(parent, row, qMin(row + SampleRows, rowCount) - 1);
+        return;
+    }
+}
+
+void ModelChecker::checkIndex(const QModelIndex &parent, int row, int column)
+{
+    const QModelIndex index = m_model->index(row, column, parent);
+    MODEL_CHECK(index.isValid());
+    if (!index.isValid())
+        return;
+    MODEL_CHECK(index.model() == m_model);
+    MODEL_CHECK(index.row() == row);
+    MODEL_CHECK(index.column() == column);
+    MODEL_CHECK(m_model->parent(index) == parent);
+    MODEL_CHECK(m_model->index(row, column, parent) == index);
+
+    if (column == 0) {
+        const int childCount = m_model->rowCount(index);
+        MODEL_CHECK(childCount >= 0);
+        if (childCount > 0)
+            MODEL_CHECK(m_model->hasChildren(index));
+    }
+
+    checkData(index);
+}
+
+void ModelChecker::checkData(const QModelIndex &index)
+{
+    QVariant v = m_model->data(index, Qt::ToolTipRole);
+    MODEL_CHECK(!v.isValid() || v.canConvert(QVariant::String));
+    v = m_model->data(index, Qt::StatusTipRole);
+    MODEL_CHECK(!v.isValid() || v.canConvert(QVariant::String));
+    v = m_model->data(index, Qt::WhatsThisRole);
+    MODEL_CHECK(!v.isValid() || v.canConvert(QVariant::String));
+    v = m_model->data(index, Qt::SizeHintRole);
+    MODEL_CHECK(!v.isValid() || v.canConvert(QVariant::Size));
+    v = m_model->data(index, Qt::FontRole);
+    MODEL_CHECK(!v.isValid() || v.canConvert(QVariant::Font));
+    v = m_model->data(index, Qt::BackgroundRole);
+    MODEL_CHECK(!v.isValid() || v.canConvert(QVariant::Brush) || v.canConvert(QVariant::Color));
+    v = m_model->data(index, Qt::ForegroundRole);
+    MODEL_CHECK(!v.isValid() || v.canConvert(QVariant::Brush) || v.canConvert(QVariant::Color));
+
+    v = m_model->data(index, Qt::TextAlignmentRole);
+    if (v.isValid()) {
+        MODEL_CHECK(v.canConvert(QVariant::Int));
+        const int alignment = v.toInt();
+        MODEL_CHECK((alignment & ~(Qt::AlignHorizontal_Mask | Qt::AlignVertical_Mask)) == 0);
+    }
+
+    v = m_model->data(index, Qt::CheckStateRole);
+    if (v.isValid()) {
+        const int state = v.toInt();
+        MODEL_CHECK(state == Qt::Unchecked || state == Qt::PartiallyChecked || state == Qt::Checked);
+    }
+}
+
+void ModelChecker::beginChange(const QModelIndex &parent, int oldCount, int delta)
+{
+    PendingChange change;
+    change.parent = parent;
+    change.oldCount = oldCount;
+    change.delta = delta;
+    m_pendingChanges.push(change);
+}
+
+void ModelChecker::endChange(const QModelIndex &parent, int newCount)
+{
+    MODEL_CHECK(!m_pendingChanges.isEmpty());
+    if (m_pendingChanges.isEmpty())
+        return;
+    const PendingChange change = m_pendingChanges.pop();
+    MODEL_CHECK(change.parent == parent);
+    MODEL_CHECK(newCount == change.oldCount + change.delta);
+}
+
+void ModelChecker::rowsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+{
+    const int rowCount = m_model->rowCount(parent);
+    MODEL_CHECK(first >= 0);
+    MODEL_CHECK(first <= rowCount);
+    MODEL_CHECK(last >= first);
+    beginChange(parent, rowCount, last - first + 1);
+}
+
+void ModelChecker::rowsInserted(const QModelIndex &parent, int first, int last)
+{
+    endChange(parent, m_model->rowCount(parent));
+    // include the neighbors, to catch inserts at the wrong position
+    queueRows(parent, first - 1, qMin(last + 1, m_model->rowCount(parent) - 1));
+}
+
+void ModelChecker::rowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    const int rowCount = m_model->rowCount(parent);
+    MODEL_CHECK(first >= 0);
+    MODEL_CHECK(last >= first);
+    MODEL_CHECK(last < rowCount);
+    beginChange(parent, rowCount, -(last - first + 1));
+}
+
+void ModelChecker::rowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(last);
+    endChange(parent, m_model->rowCount(parent));
+    queueRows(parent, first - 1, qMin(first, m_model->rowCount(parent) - 1));
+}
+
+void ModelChecker::rowsAboutToBeMoved(const QModelIndex &sourceParent, int first, int last,
+                                      const QModelIndex &destinationParent, int destinationRow)
+{
+    const int sourceCount = m_model->rowCount(sourceParent);
+    const int destinationCount = m_model->rowCount(destinationParent);
+    MODEL_CHECK(first >= 0);
+    MODEL_CHECK(last >= first);
+    MODEL_CHECK(last < sourceCount);
+    MODEL_CHECK(destinationRow >= 0);
+    MODEL_CHECK(destinationRow <= destinationCount);
+
+    if (sourceParent == destinationParent) {
+        beginChange(sourceParent, sourceCount, 0);
+    } else {
+        beginChange(sourceParent, sourceCount, -(last - first + 1));
+        beginChange(destinationParent, destinationCount, last - first + 1);
+    }
+}
+
+void ModelChecker::rowsMoved(const QModelIndex &sourceParent, int first, int last,
+                             const QModelIndex &destinationParent, int destinationRow)
+{
+    const int count = last - first + 1;
+    if (sourceParent != destinationParent)
+        endChange(destinationParent, m_model->rowCount(destinationParent));
+    endChange(sourceParent, m_model->rowCount(sourceParent));
+
+    queueRows(sourceParent, first - 1, qMin(first, m_model->rowCount(sourceParent) - 1));
+    queueRows(destinationParent, destinationRow - count,
+              qMin(destinationRow + count, m_model->rowCount(destinationParent) - 1));
+}
+
+void ModelChecker::columnsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+{
+    const int columnCount = m_model->columnCount(parent);
+    MODEL_CHECK(first >= 0);
+    MODEL_CHECK(first <= columnCount);
+    MODEL_CHECK(last >= first);
+    beginChange(parent, columnCount, last - first + 1);
+}
+
+void ModelChecker::columnsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(first);
+    Q_UNUSED(last);
+    endChange(parent, m_model->columnCount(parent));
+    queueRows(parent, 0, qMin(SampleRows, m_model->rowCount(parent)) - 1);
+}
+
+void ModelChecker::columnsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    const int columnCount = m_model->columnCount(parent);
+    MODEL_CHECK(first >= 0);
+    MODEL_CHECK(last >= first);
+    MODEL_CHECK(last < columnCount);
+    beginChange(parent, columnCount, -(last - first + 1));
+}
+
+void ModelChecker::columnsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(first);
+    Q_UNUSED(last);
+    endChange(parent, m_model->columnCount(parent));
+    queueRows(parent, 0, qMin(SampleRows, m_model->rowCount(parent)) - 1);
+}
+
+void ModelChecker::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    MODEL_CHECK(topLeft.isValid());
+    MODEL_CHECK(bottomRight.isValid());
+    if (!topLeft.isValid() || !bottomRight.isValid())
+        return;
+    MODEL_CHECK(topLeft.model() == m_model);
+    MODEL_CHECK(bottomRight.model() == m_model);
+
+    const QModelIndex parent = topLeft.parent();
+    MODEL_CHECK(bottomRight.parent() == parent);
+    MODEL_CHECK(topLeft.row() <= bottomRight.row());
+    MODEL_CHECK(topLeft.column() <= bottomRight.column());
+    MODEL_CHECK(bottomRight.row() < m_model->rowCount(parent));
+    MODEL_CHECK(bottomRight.column() < m_model->columnCount(parent));
+    queueRows(parent, topLeft.row(), bottomRight.row());
+}
+
+void ModelChecker::headerDataChanged(Qt::Orientation orientation, int first, int last)
+{
+    const int count = orientation == Qt::Horizontal ? m_model->columnCount() : m_model->rowCount();
+    MODEL_CHECK(first >= 0);
+    MODEL_CHECK(last >= first);
+    MODEL_CHECK(last < count);
+}
+
+void ModelChecker::layoutAboutToBeChanged()
+{
+    m_changingLayout = true;
+}
+
+void ModelChecker::layoutChanged()
+{
+    m_changingLayout = false;
+    // queued row numbers are stale now
+    m_queue.clear();
+    ++m_generation;
+}
+
+void ModelChecker::modelAboutToBeReset()
+{
+    m_queue.clear();
+    ++m_generation;
+}
+
+void ModelChecker::modelReset()
+{
+    MODEL_CHECK(m_pendingChanges.isEmpty());
+    m_pendingChanges.clear();
+    m_queue.clear();
+    ++m_generation;
+}
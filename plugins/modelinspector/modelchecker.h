@@ -0,0 +1,120 @@
+/*
+  modelchecker.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_MODELINSPECTOR_MODELCHECKER_H
+#define GAMMARAY_MODELINSPECTOR_MODELCHECKER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPersistentModelIndex>
+#include <QStack>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Incremental consistency checker for a single model.
+ *
+ *  Unlike ModelTest, which walks the entire model on every change, this only looks
+ *  at what a change notification claims to have changed: counts are verified right
+ *  away, the affected rows are queued and validated in time-boxed slices by process().
+ *  When nothing is queued, randomly sampled row ranges are validated instead, so the
+ *  entire model gets covered over time without ever doing a full walk.
+ */
+class ModelChecker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ModelChecker(QAbstractItemModel *model, QObject *parent = 0);
+    ~ModelChecker();
+
+    QAbstractItemModel *model() const;
+
+    /** Validate queued or sampled rows for roughly @p budget nanoseconds. */
+    void process(qint64 budget);
+
+    /** Number of distinct failures found so far. */
+    int failureCount() const;
+
+signals:
+    void failed(const QString &message);
+
+private slots:
+    void rowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+    void rowsInserted(const QModelIndex &parent, int first, int last);
+    void rowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void rowsRemoved(const QModelIndex &parent, int first, int last);
+    void rowsAboutToBeMoved(const QModelIndex &sourceParent, int first, int last,
+                            const QModelIndex &destinationParent, int destinationRow);
+    void rowsMoved(const QModelIndex &sourceParent, int first, int last,
+                   const QModelIndex &destinationParent, int destinationRow);
+    void columnsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+    void columnsInserted(const QModelIndex &parent, int first, int last);
+    void columnsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void columnsRemoved(const QModelIndex &parent, int first, int last);
+    void dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void headerDataChanged(Qt::Orientation orientation, int first, int last);
+    void layoutAboutToBeChanged();
+    void layoutChanged();
+    void modelAboutToBeReset();
+    void modelReset();
+
+private:
+    struct RowRange
+    {
+        QPersistentModelIndex parent; // invalid for top-level rows
+        bool isTopLevel;
+        int first;
+        int last;
+    };
+    struct PendingChange
+    {
+        QPersistentModelIndex parent;
+        int oldCount;
+        int delta;
+    };
+
+    void failure(int line, const char *message);
+    void queueRows(const QModelIndex &parent, int first, int last);
+    void sampleRows();
+    void checkIndex(const QModelIndex &parent, int row, int column);
+    void checkData(const QModelIndex &index);
+    void beginChange(const QModelIndex &parent, int oldCount, int delta);
+    void endChange(const QModelIndex &parent, int newCount);
+
+    QAbstractItemModel *m_model;
+    QVector<RowRange> m_queue;
+    QStack<PendingChange> m_pendingChanges;
+    QHash<int, QString> m_failures;
+    int m_generation; // incremented whenever queued row numbers become invalid
+    bool m_changingLayout;
+};
+}
+
+#endif // GAMMARAY_MODELINSPECTOR_MODELCHECKER_H
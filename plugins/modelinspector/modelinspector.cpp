@@ -28,6 +28,8 @@
 
 #include "modelinspector.h"
 
+#include "modelcallmodel.h"
+#include "modelcallprofiler.h"
 #include "modelmodel.h"
 #include "modelcellmodel.h"
 #include "modeltester.h"
@@ -42,6 +44,8 @@
 
 #include <QDebug>
 #include <QItemSelectionModel>
+#include <QSortFilterProxyModel>
+#include <QTimer>
 
 using namespace GammaRay;
 
@@ -54,6 +58,12 @@ ModelInspector::ModelInspector(ProbeInterface *probe, QObject *parent)
     , m_modelContentSelectionModel(0)
     , m_modelContentProxyModel(new ModelContentProxyModel(this))
     , m_modelTester(0)
+    , m_callProfiler(new ModelCallProfiler(this))
+    , m_callModel(new ModelCallModel(this))
+    , m_viewCallModel(new ModelViewCallModel(this))
+    , m_callHistogramModel(new ModelCallHistogramModel(this))
+    , m_showViewCallHistogram(false)
+    , m_callUpdateTimer(new QTimer(this))
 {
     auto modelModelSource = new ModelModel(this);
     connect(probe->probe(), SIGNAL(objectCreated(QObject*)),
@@ -88,8 +98,32 @@ ModelInspector::ModelInspector(ProbeInterface *probe, QObject *parent)
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.ModelCellModel"), m_cellModel);
 
     m_modelTester = new ModelTester(this);
-    connect(probe->probe(), SIGNAL(objectCreated(QObject*)),
-            m_modelTester, SLOT(objectAdded(QObject*)));
+    connect(m_modelTester, SIGNAL(failureCountChanged(QAbstractItemModel*)),
+            this, SLOT(modelCheckFailuresChanged(QAbstractItemModel*)));
+    connect(this, SIGNAL(modelCheckingEnabledChanged()), this, SLOT(updateModelChecking()));
+
+    auto callProxy = new ServerProxyModel<QSortFilterProxyModel>(this);
+    callProxy->setSourceModel(m_callModel);
+    m_callProxy = callProxy;
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.ModelCallModel"), m_callProxy);
+    m_callSelectionModel = ObjectBroker::selectionModel(m_callProxy);
+    connect(m_callSelectionModel, SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+            this, SLOT(callSelectionChanged()));
+
+    auto viewCallProxy = new ServerProxyModel<QSortFilterProxyModel>(this);
+    viewCallProxy->setSourceModel(m_viewCallModel);
+    m_viewCallProxy = viewCallProxy;
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.ModelViewCallModel"), m_viewCallProxy);
+    m_viewCallSelectionModel = ObjectBroker::selectionModel(m_viewCallProxy);
+    connect(m_viewCallSelectionModel, SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+            this, SLOT(viewCallSelectionChanged()));
+
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.ModelCallHistogramModel"), m_callHistogramModel);
+
+    probe->installGlobalEventFilter(m_callProfiler);
+    m_callUpdateTimer->setInterval(1000);
+    connect(m_callUpdateTimer, SIGNAL(timeout()), this, SLOT(updateCallStats()));
+    connect(this, SIGNAL(modelProfilingEnabledChanged()), this, SLOT(updateModelProfiling()));
 
     if (m_probe->needsObjectDiscovery())
         connect(m_probe->probe(), SIGNAL(objectCreated(QObject*)), SLOT(objectCreated(QObject*)));
@@ -107,10 +141,17 @@ void ModelInspector::modelSelected(const QItemSelection &selected)
         Q_ASSERT(model);
         m_selectionModelsModel->setModel(model);
         m_modelContentProxyModel->setSourceModel(model);
+        setModelCheckingEnabled(m_modelTester->isChecking(model));
+        setModelCheckFailures(m_modelTester->failureCount(model));
+        setModelProfilingEnabled(m_callProfiler->isProfiling(model));
     } else {
         m_selectionModelsModel->setModel(Q_NULLPTR);
         m_modelContentProxyModel->setSourceModel(Q_NULLPTR);
+        setModelCheckingEnabled(false);
+        setModelCheckFailures(0);
+        setModelProfilingEnabled(false);
     }
+    resetCallStats();
 
     // clear the cell info box
     setCurrentCellData(ModelCellData());
@@ -182,6 +223,103 @@ void ModelInspector::objectCreated(QObject *object)
         m_probe->discoverObject(proxy->sourceModel());
 }
 
+void ModelInspector::updateModelChecking()
+{
+    QAbstractItemModel *model = m_modelContentProxyModel->sourceModel();
+    if (!model) {
+        setModelCheckingEnabled(false);
+        return;
+    }
+
+    m_modelTester->setChecking(model, isModelCheckingEnabled());
+    // not possible for models in other threads
+    setModelCheckingEnabled(m_modelTester->isChecking(model));
+}
+
+void ModelInspector::modelCheckFailuresChanged(QAbstractItemModel *model)
+{
+    if (model == m_modelContentProxyModel->sourceModel())
+        setModelCheckFailures(m_modelTester->failureCount(model));
+}
+
+void ModelInspector::updateModelProfiling()
+{
+    QAbstractItemModel *model = m_modelContentProxyModel->sourceModel();
+    if (!model) {
+        setModelProfilingEnabled(false);
+        return;
+    }
+
+    m_callProfiler->setProfiling(model, isModelProfilingEnabled());
+    // not possible for models in other threads, or without support for patching them
+    setModelProfilingEnabled(m_callProfiler->isProfiling(model));
+    resetCallStats();
+}
+
+void ModelInspector::resetCallStats()
+{
+    m_callModel->clear();
+    m_viewCallModel->clear();
+    m_callHistogramModel->clear();
+    updateCallStats();
+
+    QAbstractItemModel *model = m_modelContentProxyModel->sourceModel();
+    if (model && m_callProfiler->isProfiling(model))
+        m_callUpdateTimer->start();
+    else
+        m_callUpdateTimer->stop();
+}
+
+void ModelInspector::updateCallStats()
+{
+    QAbstractItemModel *model = m_modelContentProxyModel->sourceModel();
+    if (!model || !m_callProfiler->isProfiling(model))
+        return;
+
+    const ModelCallStats stats = m_callProfiler->stats(model);
+    m_callModel->setStats(stats, model->roleNames());
+    m_viewCallModel->setStats(stats);
+    updateCallHistogram();
+}
+
+void ModelInspector::clearModelProfile()
+{
+    QAbstractItemModel *model = m_modelContentProxyModel->sourceModel();
+    if (!model)
+        return;
+    m_callProfiler->clear(model);
+    resetCallStats();
+}
+
+void ModelInspector::callSelectionChanged()
+{
+    m_showViewCallHistogram = false;
+    updateCallHistogram();
+}
+
+void ModelInspector::viewCallSelectionChanged()
+{
+    m_showViewCallHistogram = true;
+    updateCallHistogram();
+}
+
+void ModelInspector::updateCallHistogram()
+{
+    const QItemSelectionModel *selectionModel = m_showViewCallHistogram ? m_viewCallSelectionModel : m_callSelectionModel;
+    const QModelIndexList selection = selectionModel->selectedRows();
+    if (selection.isEmpty()) {
+        m_callHistogramModel->clear();
+        return;
+    }
+
+    if (m_showViewCallHistogram) {
+        const QModelIndex index = m_viewCallProxy->mapToSource(selection.first());
+        m_callHistogramModel->setViewCalls(m_viewCallModel->viewCalls(index.row()));
+    } else {
+        m_callHistogramModel->setLatency(m_callModel->latency(m_callProxy->mapToSource(selection.first())));
+    }
+}
+
 void ModelInspector::selectionModelSelected(const QItemSelection& selected)
 {
     QModelIndex idx;
@@ -41,10 +41,16 @@ class QAbstractItemModel;
 class QItemSelection;
 class QItemSelectionModel;
 class QModelIndex;
+class QSortFilterProxyModel;
+class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class ModelCallHistogramModel;
+class ModelCallModel;
+class ModelCallProfiler;
 class ModelCellModel;
+class ModelViewCallModel;
 class ModelTester;
 class ModelContentProxyModel;
 class SelectionModelModel;
@@ -56,6 +62,9 @@ class ModelInspector : public ModelInspectorInterface
 public:
     explicit ModelInspector(ProbeInterface *probe, QObject *parent = 0);
 
+public slots:
+    void clearModelProfile() Q_DECL_OVERRIDE;
+
 private slots:
     void modelSelected(const QItemSelection &selected);
     void cellSelectionChanged(const QItemSelection &selected);
@@ -64,6 +73,14 @@ private slots:
     void objectSelected(QObject *object);
     void objectCreated(QObject *object);
 
+    void updateModelChecking();
+    void modelCheckFailuresChanged(QAbstractItemModel *model);
+
+    void updateModelProfiling();
+    void updateCallStats();
+    void callSelectionChanged();
+    void viewCallSelectionChanged();
+
 private:
     ProbeInterface *m_probe;
     QAbstractItemModel *m_modelModel;
@@ -78,6 +95,20 @@ private:
     ModelCellModel *m_cellModel;
 
     ModelTester *m_modelTester;
+
+    void resetCallStats();
+    void updateCallHistogram();
+
+    ModelCallProfiler *m_callProfiler;
+    ModelCallModel *m_callModel;
+    QSortFilterProxyModel *m_callProxy;
+    QItemSelectionModel *m_callSelectionModel;
+    ModelViewCallModel *m_viewCallModel;
+    QSortFilterProxyModel *m_viewCallProxy;
+    QItemSelectionModel *m_viewCallSelectionModel;
+    ModelCallHistogramModel *m_callHistogramModel;
+    bool m_showViewCallHistogram;
+    QTimer *m_callUpdateTimer;
 };
 
 class ModelInspectorFactory : public QObject,
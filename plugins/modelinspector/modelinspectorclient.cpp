@@ -28,6 +28,8 @@
 
 #include "modelinspectorclient.h"
 
+#include <common/endpoint.h>
+
 using namespace GammaRay;
 
 ModelInspectorClient::ModelInspectorClient(QObject *parent)
@@ -38,3 +40,8 @@ ModelInspectorClient::ModelInspectorClient(QObject *parent)
 ModelInspectorClient::~ModelInspectorClient()
 {
 }
+
+void ModelInspectorClient::clearModelProfile()
+{
+    Endpoint::instance()->invokeObject(objectName(), "clearModelProfile");
+}
@@ -39,6 +39,9 @@ class ModelInspectorClient : public ModelInspectorInterface
 public:
     explicit ModelInspectorClient(QObject *parent = 0);
     virtual ~ModelInspectorClient();
+
+public slots:
+    void clearModelProfile() Q_DECL_OVERRIDE;
 };
 }
 
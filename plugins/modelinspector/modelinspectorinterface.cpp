@@ -68,6 +68,9 @@ bool ModelCellData::operator==(const ModelCellData& other) const
 
 ModelInspectorInterface::ModelInspectorInterface(QObject *parent)
     : QObject(parent)
+    , m_modelCheckingEnabled(false)
+    , m_modelCheckFailures(0)
+    , m_modelProfilingEnabled(false)
 {
     qRegisterMetaType<ModelCellData>();
     qRegisterMetaTypeStreamOperators<ModelCellData>();
@@ -90,3 +93,42 @@ void ModelInspectorInterface::setCurrentCellData(const ModelCellData& cellData)
     m_currentCellData = cellData;
     emit currentCellDataChanged();
 }
+
+bool ModelInspectorInterface::isModelCheckingEnabled() const
+{
+    return m_modelCheckingEnabled;
+}
+
+void ModelInspectorInterface::setModelCheckingEnabled(bool enabled)
+{
+    if (m_modelCheckingEnabled == enabled)
+        return;
+    m_modelCheckingEnabled = enabled;
+    emit modelCheckingEnabledChanged();
+}
+
+int ModelInspectorInterface::modelCheckFailures() const
+{
+    return m_modelCheckFailures;
+}
+
+void ModelInspectorInterface::setModelCheckFailures(int failures)
+{
+    if (m_modelCheckFailures == failures)
+        return;
+    m_modelCheckFailures = failures;
+    emit modelCheckFailuresChanged();
+}
+
+bool ModelInspectorInterface::isModelProfilingEnabled() const
+{
+    return m_modelProfilingEnabled;
+}
+
+void ModelInspectorInterface::setModelProfilingEnabled(bool enabled)
+{
+    if (m_modelProfilingEnabled == enabled)
+        return;
+    m_modelProfilingEnabled = enabled;
+    emit modelProfilingEnabledChanged();
+}
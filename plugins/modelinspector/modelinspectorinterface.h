@@ -50,6 +50,9 @@ class ModelInspectorInterface : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(GammaRay::ModelCellData cellData READ currentCellData WRITE setCurrentCellData NOTIFY currentCellDataChanged)
+    Q_PROPERTY(bool modelCheckingEnabled READ isModelCheckingEnabled WRITE setModelCheckingEnabled NOTIFY modelCheckingEnabledChanged)
+    Q_PROPERTY(int modelCheckFailures READ modelCheckFailures WRITE setModelCheckFailures NOTIFY modelCheckFailuresChanged)
+    Q_PROPERTY(bool modelProfilingEnabled READ isModelProfilingEnabled WRITE setModelProfilingEnabled NOTIFY modelProfilingEnabledChanged)
 public:
     explicit ModelInspectorInterface(QObject *parent = 0);
     virtual ~ModelInspectorInterface();
@@ -57,11 +60,30 @@ public:
     ModelCellData currentCellData() const;
     void setCurrentCellData(const ModelCellData &cellData);
 
+    /** Consistency checking of the currently selected model. */
+    bool isModelCheckingEnabled() const;
+    void setModelCheckingEnabled(bool enabled);
+    int modelCheckFailures() const;
+    void setModelCheckFailures(int failures);
+
+    /** Call profiling of the currently selected model. */
+    bool isModelProfilingEnabled() const;
+    void setModelProfilingEnabled(bool enabled);
+
+public slots:
+    virtual void clearModelProfile() = 0;
+
 signals:
     void currentCellDataChanged();
+    void modelCheckingEnabledChanged();
+    void modelCheckFailuresChanged();
+    void modelProfilingEnabledChanged();
 
 private:
     ModelCellData m_currentCellData;
+    bool m_modelCheckingEnabled;
+    int m_modelCheckFailures;
+    bool m_modelProfilingEnabled;
 };
 }
 
@@ -86,6 +86,29 @@ ModelInspectorWidget::ModelInspectorWidget(QWidget *parent)
         createModelInspectorClient);
     m_interface = ObjectBroker::object<ModelInspectorInterface *>();
     connect(m_interface, SIGNAL(currentCellDataChanged()), this, SLOT(cellDataChanged()));
+    connect(m_interface, SIGNAL(modelCheckingEnabledChanged()), this, SLOT(modelCheckingChanged()));
+    connect(m_interface, SIGNAL(modelCheckFailuresChanged()), this, SLOT(modelCheckingChanged()));
+    connect(ui->modelCheckBox, SIGNAL(toggled(bool)), this, SLOT(modelCheckingToggled(bool)));
+    connect(m_interface, SIGNAL(modelProfilingEnabledChanged()), this, SLOT(modelProfilingChanged()));
+    connect(ui->callProfileBox, SIGNAL(toggled(bool)), this, SLOT(modelProfilingToggled(bool)));
+    connect(ui->callProfileClearButton, SIGNAL(clicked()), m_interface, SLOT(clearModelProfile()));
+
+    auto callModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ModelCallModel"));
+    ui->callView->setModel(callModel);
+    ui->callView->setSelectionModel(ObjectBroker::selectionModel(callModel));
+    ui->callView->header()->setObjectName("callViewHeader");
+    ui->callView->setDeferredResizeMode(0, QHeaderView::ResizeToContents);
+    ui->callView->sortByColumn(2, Qt::DescendingOrder); // total time
+
+    auto viewCallModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ModelViewCallModel"));
+    ui->viewCallView->setModel(viewCallModel);
+    ui->viewCallView->setSelectionModel(ObjectBroker::selectionModel(viewCallModel));
+    ui->viewCallView->header()->setObjectName("viewCallViewHeader");
+    ui->viewCallView->setDeferredResizeMode(0, QHeaderView::ResizeToContents);
+    ui->viewCallView->sortByColumn(2, Qt::DescendingOrder); // calls per repaint
+
+    ui->callHistogramView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ModelCallHistogramModel")));
+    ui->callHistogramView->header()->setObjectName("callHistogramViewHeader");
 
     auto modelModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ModelModel"));
     ui->modelView->setModel(modelModel);
@@ -101,6 +124,8 @@ ModelInspectorWidget::ModelInspectorWidget(QWidget *parent)
     m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "33%" << "33%" << "33%");
 
     cellDataChanged();
+    modelCheckingChanged();
+    modelProfilingChanged();
 }
 
 ModelInspectorWidget::~ModelInspectorWidget()
@@ -116,6 +141,8 @@ void ModelInspectorWidget::modelSelected(const QItemSelection &selected)
     if (index.isValid())
         // in case selection is not directly triggered by the user
         ui->modelView->scrollTo(index, QAbstractItemView::EnsureVisible);
+    ui->modelCheckBox->setEnabled(index.isValid());
+    ui->callProfileBox->setEnabled(index.isValid());
 }
 
 #define F(x) { Qt:: x, #x }
@@ -151,6 +178,30 @@ void ModelInspectorWidget::cellDataChanged()
     ui->flagsLabel->setText(MetaEnum::flagsToString(cellData.flags, item_flag_table));
 }
 
+void ModelInspectorWidget::modelCheckingChanged()
+{
+    ui->modelCheckBox->setChecked(m_interface->isModelCheckingEnabled());
+    if (m_interface->isModelCheckingEnabled())
+        ui->modelCheckLabel->setText(tr("%n failure(s)", 0, m_interface->modelCheckFailures()));
+    else
+        ui->modelCheckLabel->clear();
+}
+
+void ModelInspectorWidget::modelCheckingToggled(bool enabled)
+{
+    m_interface->setModelCheckingEnabled(enabled);
+}
+
+void ModelInspectorWidget::modelProfilingChanged()
+{
+    ui->callProfileBox->setChecked(m_interface->isModelProfilingEnabled());
+}
+
+void ModelInspectorWidget::modelProfilingToggled(bool enabled)
+{
+    m_interface->setModelProfilingEnabled(enabled);
+}
+
 void ModelInspectorWidget::objectRegistered(const QString &objectName)
 {
     if (objectName == QLatin1String("com.kdab.GammaRay.ModelContent.selection"))
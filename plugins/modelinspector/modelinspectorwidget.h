@@ -55,6 +55,10 @@ public:
 
 private slots:
     void cellDataChanged();
+    void modelCheckingChanged();
+    void modelCheckingToggled(bool enabled);
+    void modelProfilingChanged();
+    void modelProfilingToggled(bool enabled);
     void objectRegistered(const QString &objectName);
     void modelSelected(const QItemSelection &selected);
     void modelContextMenu(QPoint pos);
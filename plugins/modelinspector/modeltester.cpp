@@ -27,100 +27,88 @@
 */
 
 #include "modeltester.h"
-#include <3rdparty/qt/modeltest.h>
+#include "modelchecker.h"
 
 #include <core/util.h>
 
-#include <QAbstractListModel>
-#include <QDebug>
+#include <QAbstractItemModel>
+#include <QThread>
+#include <QTimer>
 
 #include <iostream>
 
 using namespace GammaRay;
 
-namespace GammaRay {
-struct ModelTester::ModelTestResult {
-    ModelTestResult()
-        : modelTest(0)
-    {
-    }
-
-    ~ModelTestResult()
-    {
-        delete modelTest;
-    }
-
-    ModelTest *modelTest;
-    QHash<int, QString> failures;
-};
-}
+// checking time shared by all models per interval, i.e. at most 2% of the CPU
+static const qint64 CheckBudget = 2000000; // ns
+static const int CheckInterval = 100; // ms
 
 ModelTester::ModelTester(QObject *parent)
     : QObject(parent)
+    , m_timer(new QTimer(this))
 {
+    m_timer->setInterval(CheckInterval);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(checkModels()));
 }
 
 ModelTester::~ModelTester()
 {
-    qDeleteAll(m_modelTestMap);
 }
 
-void ModelTester::objectAdded(QObject *obj)
+bool ModelTester::isChecking(QAbstractItemModel *model) const
+{
+    return m_checkers.contains(model);
+}
+
+void ModelTester::setChecking(QAbstractItemModel *model, bool enabled)
 {
-    QAbstractItemModel *model = qobject_cast<QAbstractItemModel *>(obj);
-    if (model) {
-        // TODO filter out our own models, way too slow otherwise
-        // or even better allow to specify somehow to which models we want to attach
-        connect(model, SIGNAL(destroyed(QObject*)), SLOT(modelDestroyed(QObject*)));
-        ModelTestResult *result = new ModelTestResult;
-        m_modelTestMap.insert(model, result); // needs to be available for the
-                                              // initial calls to failure() already
-        // FIXME too slow!
-// result->modelTest = new ModelTest(model, this);
+    if (!model || enabled == isChecking(model))
+        return;
+
+    if (enabled) {
+        if (model->thread() != thread())
+            return;
+        ModelChecker *checker = new ModelChecker(model, this);
+        connect(checker, SIGNAL(failed(QString)), this, SLOT(failure(QString)));
+        connect(model, SIGNAL(destroyed(QObject*)), this, SLOT(modelDestroyed(QObject*)));
+        m_checkers.insert(model, checker);
+        m_timer->start();
+    } else {
+        disconnect(model, SIGNAL(destroyed(QObject*)), this, SLOT(modelDestroyed(QObject*)));
+        delete m_checkers.take(model);
+        if (m_checkers.isEmpty())
+            m_timer->stop();
     }
 }
 
-void ModelTester::modelDestroyed(QObject *model)
+int ModelTester::failureCount(QAbstractItemModel *model) const
 {
-    if (m_modelTestMap.contains(static_cast<QAbstractItemModel *>(model)))
-        delete m_modelTestMap.take(static_cast<QAbstractItemModel *>(model));
+    const ModelChecker *checker = m_checkers.value(model);
+    return checker ? checker->failureCount() : 0;
 }
 
-void ModelTester::failure(QAbstractItemModel *model, const char *file, int line,
-                          const char *message)
+void ModelTester::modelDestroyed(QObject *model)
 {
-    ModelTestResult *result = m_modelTestMap.value(model);
-    Q_ASSERT(result || qgetenv("GAMMARAY_UNITTEST") == "1");
-    if (!result) {
-        // one of our own models
-        qt_assert(message, file, line);
-    }
+    delete m_checkers.take(static_cast<QAbstractItemModel *>(model));
+    if (m_checkers.isEmpty())
+        m_timer->stop();
+}
 
-    ///TODO: track file
-    if (!result->failures.contains(line)) {
-        std::cout << qPrintable(Util::displayString(model)) << " "
-                  << line << " " << message << std::endl;
-        result->failures.insert(line, QString::fromLatin1(message));
+void ModelTester::checkModels()
+{
+    const qint64 budget = CheckBudget / qMax(1, m_checkers.size());
+    // checking calls into the models, which might delete other models
+    foreach (QAbstractItemModel *model, m_checkers.keys()) {
+        if (ModelChecker *checker = m_checkers.value(model))
+            checker->process(budget);
     }
 }
 
-// inplace build of modeltest, with some slight modificatins:
-// - change QVERIFY to non-fatal reporting
-// - suppress qDebug etc, since those trigger qobject creating and thus
-// infinite loops when model-testing the object model
-// krazy:cond=includes
-#include <QtCore> // avoid interference with any include used by modeltest
-#define QT_QTTEST_MODULE_H
-#undef QVERIFY
-#undef QCOMPARE
-#define QVERIFY(x) (!(x) ? static_cast<GammaRay::ModelTester *>(static_cast<QObject *>(this)->parent()) \
-                    ->failure(this->model, __FILE__, __LINE__, #x) : qt_noop())
-#define QCOMPARE(x, \
-                 y) ((x \
-                      != y) ? static_cast<GammaRay::ModelTester *>(static_cast<QObject *>(this)-> \
-                                                                   parent())->failure( \
-                         this->model, __FILE__, __LINE__, #x) : qt_noop())
-#undef qDebug
-#define qDebug() QNoDebug()
-#include <3rdparty/qt/modeltest.cpp>
-// krazy:endcond=includes
+void ModelTester::failure(const QString &message)
+{
+    ModelChecker *checker = qobject_cast<ModelChecker *>(sender());
+    Q_ASSERT(checker);
+    std::cout << qPrintable(Util::displayString(checker->model())) << " "
+              << qPrintable(message) << std::endl;
+    emit failureCountChanged(checker->model());
+}
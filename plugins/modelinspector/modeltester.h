@@ -31,14 +31,19 @@
 
 #include <QHash>
 #include <QObject>
-#include <QPointer>
 
 QT_BEGIN_NAMESPACE
 class QAbstractItemModel;
+class QTimer;
 QT_END_NAMESPACE
-class ModelTest;
 
 namespace GammaRay {
+class ModelChecker;
+
+/** Runs consistency checks on the models they have been enabled for.
+ *  The checks of all models share a fixed CPU budget, so this can be left
+ *  enabled even for large models.
+ */
 class ModelTester : public QObject
 {
     Q_OBJECT
@@ -46,17 +51,22 @@ public:
     explicit ModelTester(QObject *parent = 0);
     ~ModelTester();
 
-    void failure(QAbstractItemModel *model, const char *file, int line, const char *message);
+    bool isChecking(QAbstractItemModel *model) const;
+    /** Enable or disable checking of @p model, which has to live in our thread. */
+    void setChecking(QAbstractItemModel *model, bool enabled);
+    int failureCount(QAbstractItemModel *model) const;
 
-public slots:
-    void objectAdded(QObject *obj);
+signals:
+    void failureCountChanged(QAbstractItemModel *model);
 
 private slots:
     void modelDestroyed(QObject *model);
+    void checkModels();
+    void failure(const QString &message);
 
 private:
-    struct ModelTestResult;
-    QHash<QAbstractItemModel *, ModelTestResult *> m_modelTestMap;
+    QHash<QAbstractItemModel *, ModelChecker *> m_checkers;
+    QTimer *m_timer;
 };
 }
 
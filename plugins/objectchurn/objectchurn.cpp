@@ -0,0 +1,147 @@
+/*
+  objectchurn.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "objectchurn.h"
+#include "objectchurnmodel.h"
+#include "objectchurnrecorder.h"
+
+#include <core/objectlifetimecallbackset.h>
+#include <core/probe.h>
+#include <core/probeinterface.h>
+#include <core/remote/serverproxymodel.h>
+
+#include <common/objectbroker.h>
+
+#include <QItemSelectionModel>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+
+using namespace GammaRay;
+
+// the callbacks cannot be unregistered again, so they must not outlive the recorder
+// they are called with the object lock held, which guards this
+static ObjectChurnRecorder *s_recorder = 0;
+
+static void object_created_callback(QObject *object)
+{
+    if (s_recorder)
+        s_recorder->objectCreated(object);
+}
+
+static void object_destroyed_callback(QObject *object)
+{
+    if (s_recorder)
+        s_recorder->objectDestroyed(object);
+}
+
+ObjectChurn::ObjectChurn(ProbeInterface *probe, QObject *parent)
+    : ObjectChurnInterface(parent)
+    , m_recorder(new ObjectChurnRecorder)
+    , m_model(new ObjectChurnModel(this))
+    , m_proxy(new ServerProxyModel<QSortFilterProxyModel>(this))
+    , m_lifetimeModel(new ObjectLifetimeModel(this))
+    , m_siteModel(new ObjectCreationSiteModel(m_recorder, this))
+    , m_selectedClass(0)
+    , m_updateTimer(new QTimer(this))
+{
+    m_proxy->setSourceModel(m_model);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.ObjectChurnModel"), m_proxy);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.ObjectLifetimeModel"), m_lifetimeModel);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.ObjectCreationSiteModel"), m_siteModel);
+
+    m_selectionModel = ObjectBroker::selectionModel(m_proxy);
+    connect(m_selectionModel, SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+            this, SLOT(selectionChanged(QItemSelection)));
+
+    connect(this, SIGNAL(backtraceSampleIntervalChanged()), this, SLOT(updateSampleInterval()));
+    connect(probe->probe(), SIGNAL(objectCreated(QObject*)), this, SLOT(objectConstructed(QObject*)));
+
+    {
+        QMutexLocker lock(Probe::objectLock());
+        s_recorder = m_recorder;
+    }
+    ObjectLifetimeCallbackSet callbacks;
+    callbacks.objectCreatedCallback = object_created_callback;
+    callbacks.objectDestroyedCallback = object_destroyed_callback;
+    probe->registerObjectLifetimeCallbackSet(callbacks);
+
+    m_updateTimer->setInterval(1000);
+    connect(m_updateTimer, SIGNAL(timeout()), this, SLOT(update()));
+    m_updateTimer->start();
+}
+
+ObjectChurn::~ObjectChurn()
+{
+    {
+        QMutexLocker lock(Probe::objectLock());
+        s_recorder = 0;
+    }
+    delete m_recorder;
+}
+
+void ObjectChurn::clear()
+{
+    m_recorder->clear();
+    m_model->clear();
+    m_lifetimeModel->setStats(ObjectChurnStats());
+    m_siteModel->clear();
+}
+
+void ObjectChurn::objectConstructed(QObject *object)
+{
+    m_recorder->objectConstructed(object);
+}
+
+void ObjectChurn::update()
+{
+    const auto stats = m_recorder->stats();
+    m_model->setStats(stats, m_recorder->currentSecond());
+    if (m_selectionModel->hasSelection()) {
+        m_lifetimeModel->setStats(stats.value(m_selectedClass));
+        m_siteModel->update();
+    }
+}
+
+void ObjectChurn::updateSampleInterval()
+{
+    m_recorder->setBacktraceSampleInterval(backtraceSampleInterval());
+}
+
+void ObjectChurn::selectionChanged(const QItemSelection &selection)
+{
+    m_selectedClass = 0;
+    if (selection.isEmpty()) {
+        m_lifetimeModel->setStats(ObjectChurnStats());
+        m_siteModel->clear();
+        return;
+    }
+
+    const QModelIndex index = m_proxy->mapToSource(selection.first().topLeft());
+    m_selectedClass = m_model->metaObjectForRow(index.row());
+    m_lifetimeModel->setStats(m_recorder->stats().value(m_selectedClass));
+    m_siteModel->setMetaObject(m_selectedClass);
+}
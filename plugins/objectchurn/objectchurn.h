@@ -0,0 +1,89 @@
+/*
+  objectchurn.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_OBJECTCHURN_H
+#define GAMMARAY_OBJECTCHURN_H
+
+#include "objectchurninterface.h"
+
+#include <core/toolfactory.h>
+
+QT_BEGIN_NAMESPACE
+class QItemSelection;
+class QItemSelectionModel;
+class QSortFilterProxyModel;
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+class ObjectChurnModel;
+class ObjectChurnRecorder;
+class ObjectCreationSiteModel;
+class ObjectLifetimeModel;
+
+class ObjectChurn : public ObjectChurnInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(GammaRay::ObjectChurnInterface)
+public:
+    explicit ObjectChurn(ProbeInterface *probe, QObject *parent = 0);
+    ~ObjectChurn();
+
+public slots:
+    void clear() Q_DECL_OVERRIDE;
+
+private slots:
+    void objectConstructed(QObject *object);
+    void update();
+    void updateSampleInterval();
+    void selectionChanged(const QItemSelection &selection);
+
+private:
+    ObjectChurnRecorder *m_recorder;
+    ObjectChurnModel *m_model;
+    QSortFilterProxyModel *m_proxy;
+    QItemSelectionModel *m_selectionModel;
+    ObjectLifetimeModel *m_lifetimeModel;
+    ObjectCreationSiteModel *m_siteModel;
+    const QMetaObject *m_selectedClass; // null is a valid class here, see ObjectChurnRecorder
+    QTimer *m_updateTimer;
+};
+
+class ObjectChurnFactory : public QObject, public StandardToolFactory<QObject, ObjectChurn>
+{
+    Q_OBJECT
+    Q_INTERFACES(GammaRay::ToolFactory)
+    Q_PLUGIN_METADATA(IID "com.kdab.GammaRay.ToolFactory" FILE "gammaray_objectchurn.json")
+public:
+    explicit ObjectChurnFactory(QObject *parent = 0)
+        : QObject(parent)
+    {
+    }
+};
+}
+
+#endif // GAMMARAY_OBJECTCHURN_H
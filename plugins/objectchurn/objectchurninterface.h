@@ -0,0 +1,63 @@
+/*
+  objectchurninterface.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_OBJECTCHURNINTERFACE_H
+#define GAMMARAY_OBJECTCHURNINTERFACE_H
+
+#include <QObject>
+
+namespace GammaRay {
+class ObjectChurnInterface : public QObject
+{
+    Q_OBJECT
+    /** Capture the creation backtrace of every n-th object, 0 disables backtraces. */
+    Q_PROPERTY(int backtraceSampleInterval READ backtraceSampleInterval WRITE setBacktraceSampleInterval NOTIFY backtraceSampleIntervalChanged)
+public:
+    explicit ObjectChurnInterface(QObject *parent = 0);
+    ~ObjectChurnInterface();
+
+    int backtraceSampleInterval() const;
+    void setBacktraceSampleInterval(int interval);
+
+public slots:
+    /** Discard all statistics recorded so far. */
+    virtual void clear() = 0;
+
+signals:
+    void backtraceSampleIntervalChanged();
+
+private:
+    int m_backtraceSampleInterval;
+};
+}
+
+QT_BEGIN_NAMESPACE
+Q_DECLARE_INTERFACE(GammaRay::ObjectChurnInterface,
+                    "com.kdab.GammaRay.ObjectChurnInterface/1.0")
+QT_END_NAMESPACE
+
+#endif // GAMMARAY_OBJECTCHURNINTERFACE_H
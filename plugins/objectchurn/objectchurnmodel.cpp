@@ -0,0 +1,413 @@
+/*
+  objectchurnmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "objectchurnmodel.h"
+
+#include <QMetaObject>
+
+using namespace GammaRay;
+
+static QString formatLifetime(qint64 usecs)
+{
+    if (usecs >= 1000000)
+        return QStringLiteral("%1 s").arg(usecs / 1000000.0, 0, 'g', 3);
+    if (usecs >= 1000)
+        return QStringLiteral("%1 ms").arg(usecs / 1000.0, 0, 'g', 3);
+    return QStringLiteral("%1 us").arg(usecs);
+}
+
+ObjectChurnModel::ObjectChurnModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_second(0)
+{
+}
+
+ObjectChurnModel::~ObjectChurnModel()
+{
+}
+
+void ObjectChurnModel::setStats(const QHash<const QMetaObject *, ObjectChurnStats> &stats,
+                                qint64 second)
+{
+    m_second = second;
+
+    QVector<Row> newRows;
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const auto rowIt = m_rowIndex.constFind(it.key());
+        if (rowIt != m_rowIndex.constEnd()) {
+            m_rows[rowIt.value()].stats = it.value();
+        } else {
+            Row row;
+            row.metaObject = it.key();
+            row.stats = it.value();
+            newRows.push_back(row);
+        }
+    }
+
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, CreatedColumn), index(m_rows.size() - 1, COLUMN_COUNT - 1));
+
+    if (newRows.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + newRows.size() - 1);
+    foreach (const Row &row, newRows) {
+        m_rowIndex.insert(row.metaObject, m_rows.size());
+        m_rows.push_back(row);
+    }
+    endInsertRows();
+}
+
+void ObjectChurnModel::clear()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_rowIndex.clear();
+    endResetModel();
+}
+
+const QMetaObject *ObjectChurnModel::metaObjectForRow(int row) const
+{
+    if (row < 0 || row >= m_rows.size())
+        return 0;
+    return m_rows.at(row).metaObject;
+}
+
+int ObjectChurnModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int ObjectChurnModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant ObjectChurnModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return displayData(index.row(), index.column());
+    if (role == Qt::TextAlignmentRole && index.column() >= CreatedColumn)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    return QVariant();
+}
+
+QVariant ObjectChurnModel::displayData(int row, int column) const
+{
+    const Row &r = m_rows.at(row);
+    switch (column) {
+    case ClassColumn:
+        return QString::fromLatin1(r.metaObject->className());
+    case CreatedColumn:
+        return r.stats.created;
+    case DestroyedColumn:
+        return r.stats.destroyed;
+    case AliveColumn:
+        return r.stats.created - r.stats.destroyed;
+    case CreationRate1Column:
+        return r.stats.creationRate(m_second, 1);
+    case CreationRate10Column:
+        return r.stats.creationRate(m_second, 10);
+    case CreationRate60Column:
+        return r.stats.creationRate(m_second, 60);
+    case DestructionRate1Column:
+        return r.stats.destructionRate(m_second, 1);
+    case DestructionRate10Column:
+        return r.stats.destructionRate(m_second, 10);
+    case DestructionRate60Column:
+        return r.stats.destructionRate(m_second, 60);
+    case ShortLivedColumn:
+        return r.stats.shortLived;
+    case MedianLifetimeColumn:
+        if (!r.stats.destroyed)
+            return QVariant();
+        return formatLifetime(r.stats.lifetimePercentile(0.5));
+    }
+    return QVariant();
+}
+
+QVariant ObjectChurnModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ClassColumn:
+            return tr("Class");
+        case CreatedColumn:
+            return tr("Created");
+        case DestroyedColumn:
+            return tr("Destroyed");
+        case AliveColumn:
+            return tr("Alive");
+        case CreationRate1Column:
+            return tr("Created/s (1s)");
+        case CreationRate10Column:
+            return tr("Created/s (10s)");
+        case CreationRate60Column:
+            return tr("Created/s (60s)");
+        case DestructionRate1Column:
+            return tr("Destroyed/s (1s)");
+        case DestructionRate10Column:
+            return tr("Destroyed/s (10s)");
+        case DestructionRate60Column:
+            return tr("Destroyed/s (60s)");
+        case ShortLivedColumn:
+            return tr("Short-lived");
+        case MedianLifetimeColumn:
+            return tr("Median Lifetime");
+        }
+    }
+    if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        switch (section) {
+        case AliveColumn:
+            return tr("Objects created since recording started that are still alive.");
+        case ShortLivedColumn:
+            return tr("Objects destroyed within %1 ms of their creation.")
+                   .arg(ObjectChurnRecorder::ShortLivedThreshold / 1000);
+        case MedianLifetimeColumn:
+            return tr("Estimated from a logarithmic histogram, accurate to a factor of two.");
+        }
+    }
+    return QVariant();
+}
+
+ObjectLifetimeModel::ObjectLifetimeModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+ObjectLifetimeModel::~ObjectLifetimeModel()
+{
+}
+
+void ObjectLifetimeModel::setStats(const ObjectChurnStats &stats)
+{
+    m_stats = stats;
+    emit dataChanged(index(0, CountColumn), index(ObjectChurnStats::LifetimeBuckets - 1, CountColumn));
+}
+
+int ObjectLifetimeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int ObjectLifetimeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return ObjectChurnStats::LifetimeBuckets;
+}
+
+QVariant ObjectLifetimeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const int bucket = index.row();
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case LifetimeColumn:
+            if (bucket == 0)
+                return tr("< %1").arg(formatLifetime(2));
+            if (bucket == ObjectChurnStats::LifetimeBuckets - 1)
+                return tr(">= %1").arg(formatLifetime(qint64(1) << bucket));
+            return tr("%1 - %2").arg(formatLifetime(qint64(1) << bucket),
+                                     formatLifetime(qint64(1) << (bucket + 1)));
+        case CountColumn:
+            return m_stats.lifetimeHistogram[bucket];
+        }
+    } else if (role == Qt::TextAlignmentRole && index.column() == CountColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant ObjectLifetimeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case LifetimeColumn:
+            return tr("Lifetime");
+        case CountColumn:
+            return tr("Objects");
+        }
+    }
+    return QVariant();
+}
+
+ObjectCreationSiteModel::ObjectCreationSiteModel(ObjectChurnRecorder *recorder, QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_recorder(recorder)
+    , m_metaObject(0)
+    , m_active(false)
+{
+}
+
+ObjectCreationSiteModel::~ObjectCreationSiteModel()
+{
+}
+
+void ObjectCreationSiteModel::setMetaObject(const QMetaObject *mo)
+{
+    beginResetModel();
+    m_metaObject = mo;
+    m_active = true;
+    m_sites.clear();
+    endResetModel();
+    update();
+}
+
+void ObjectCreationSiteModel::clear()
+{
+    beginResetModel();
+    m_metaObject = 0;
+    m_active = false;
+    m_sites.clear();
+    endResetModel();
+}
+
+void ObjectCreationSiteModel::update()
+{
+    if (!m_active)
+        return;
+
+    const QHash<int, quint64> sites = m_recorder->creationSites(m_metaObject);
+    if (sites.isEmpty() && !m_sites.isEmpty()) { // recorder has been cleared
+        beginResetModel();
+        m_sites.clear();
+        endResetModel();
+        return;
+    }
+
+    QHash<int, int> known;
+    for (int i = 0; i < m_sites.size(); ++i) {
+        known.insert(m_sites.at(i).id, i);
+        m_sites[i].count = sites.value(m_sites.at(i).id);
+    }
+    if (!m_sites.isEmpty())
+        emit dataChanged(index(0, CountColumn), index(m_sites.size() - 1, CountColumn));
+
+    QVector<Site> newSites;
+    for (auto it = sites.constBegin(); it != sites.constEnd(); ++it) {
+        if (known.contains(it.key()))
+            continue;
+        Site site;
+        site.id = it.key();
+        site.count = it.value();
+        site.backtrace = m_recorder->creationSite(it.key());
+        newSites.push_back(site);
+    }
+    if (newSites.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_sites.size(), m_sites.size() + newSites.size() - 1);
+    m_sites += newSites;
+    endInsertRows();
+}
+
+int ObjectCreationSiteModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int ObjectCreationSiteModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_sites.size();
+    if (parent.internalId() || parent.column() != 0)
+        return 0;
+    return m_sites.at(parent.row()).backtrace.size();
+}
+
+QModelIndex ObjectCreationSiteModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= COLUMN_COUNT)
+        return QModelIndex();
+    if (!parent.isValid()) {
+        if (row >= m_sites.size())
+            return QModelIndex();
+        return createIndex(row, column);
+    }
+    if (parent.internalId() || row >= m_sites.at(parent.row()).backtrace.size())
+        return QModelIndex();
+    // frames store the row of their site + 1, so top-level rows can use 0
+    return createIndex(row, column, quintptr(parent.row() + 1));
+}
+
+QModelIndex ObjectCreationSiteModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || !child.internalId())
+        return QModelIndex();
+    return createIndex(int(child.internalId() - 1), 0);
+}
+
+QVariant ObjectCreationSiteModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (!index.internalId()) {
+        const Site &site = m_sites.at(index.row());
+        if (role == Qt::DisplayRole) {
+            switch (index.column()) {
+            case LocationColumn:
+                if (site.backtrace.isEmpty())
+                    return tr("<no backtrace available>");
+                return site.backtrace.first();
+            case CountColumn:
+                return site.count;
+            }
+        } else if (role == Qt::TextAlignmentRole && index.column() == CountColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return QVariant();
+    }
+
+    const Backtrace &backtrace = m_sites.at(int(index.internalId() - 1)).backtrace;
+    if (role == Qt::DisplayRole && index.column() == LocationColumn)
+        return backtrace.at(index.row());
+    return QVariant();
+}
+
+QVariant ObjectCreationSiteModel::headerData(int section, Qt::Orientation orientation,
+                                             int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case LocationColumn:
+            return tr("Location");
+        case CountColumn:
+            return tr("Short-lived Objects");
+        }
+    }
+    return QVariant();
+}
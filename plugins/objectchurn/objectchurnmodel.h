@@ -0,0 +1,155 @@
+/*
+  objectchurnmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_OBJECTCHURNMODEL_H
+#define GAMMARAY_OBJECTCHURNMODEL_H
+
+#include "objectchurnrecorder.h"
+
+#include <QAbstractItemModel>
+#include <QVector>
+
+namespace GammaRay {
+/** Creation and destruction statistics per class. */
+class ObjectChurnModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        ClassColumn,
+        CreatedColumn,
+        DestroyedColumn,
+        AliveColumn,
+        CreationRate1Column,
+        CreationRate10Column,
+        CreationRate60Column,
+        DestructionRate1Column,
+        DestructionRate10Column,
+        DestructionRate60Column,
+        ShortLivedColumn,
+        MedianLifetimeColumn,
+        COLUMN_COUNT
+    };
+
+    explicit ObjectChurnModel(QObject *parent = 0);
+    ~ObjectChurnModel();
+
+    /** Merges a snapshot of the recorder statistics taken at @p second. */
+    void setStats(const QHash<const QMetaObject *, ObjectChurnStats> &stats, qint64 second);
+    void clear();
+    const QMetaObject *metaObjectForRow(int row) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    QVariant displayData(int row, int column) const;
+
+    struct Row {
+        const QMetaObject *metaObject;
+        ObjectChurnStats stats;
+    };
+    QVector<Row> m_rows;
+    QHash<const QMetaObject *, int> m_rowIndex;
+    qint64 m_second;
+};
+
+/** Lifetime histogram of the destroyed objects of one class. */
+class ObjectLifetimeModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        LifetimeColumn,
+        CountColumn,
+        COLUMN_COUNT
+    };
+
+    explicit ObjectLifetimeModel(QObject *parent = 0);
+    ~ObjectLifetimeModel();
+
+    void setStats(const ObjectChurnStats &stats);
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    ObjectChurnStats m_stats;
+};
+
+/** Sampled creation backtraces of the short-lived objects of one class,
+ *  with the backtrace frames as children.
+ */
+class ObjectCreationSiteModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        LocationColumn,
+        CountColumn,
+        COLUMN_COUNT
+    };
+
+    explicit ObjectCreationSiteModel(ObjectChurnRecorder *recorder, QObject *parent = 0);
+    ~ObjectCreationSiteModel();
+
+    /** Shows the creation sites of @p mo. */
+    void setMetaObject(const QMetaObject *mo);
+    /** Shows nothing until the next call to setMetaObject(). */
+    void clear();
+    /** Fetches new creation sites of the current class from the recorder. */
+    void update();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QModelIndex index(int row, int column,
+                      const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QModelIndex parent(const QModelIndex &child) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+private:
+    struct Site {
+        int id;
+        quint64 count;
+        Backtrace backtrace;
+    };
+    ObjectChurnRecorder *m_recorder;
+    const QMetaObject *m_metaObject;
+    bool m_active;
+    QVector<Site> m_sites;
+};
+}
+
+#endif // GAMMARAY_OBJECTCHURNMODEL_H
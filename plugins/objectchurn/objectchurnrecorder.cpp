@@ -0,0 +1,226 @@
+/*
+  objectchurnrecorder.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "objectchurnrecorder.h"
+
+#include <QObject>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace GammaRay;
+
+static const int MaxCreationSiteFrames = 32;
+
+ObjectChurnStats::ObjectChurnStats()
+    : created(0)
+    , destroyed(0)
+    , shortLived(0)
+{
+    std::fill(lifetimeHistogram, lifetimeHistogram + LifetimeBuckets, 0);
+    for (int i = 0; i < RateHistory; ++i) {
+        history[i].second = -1;
+        history[i].created = 0;
+        history[i].destroyed = 0;
+    }
+}
+
+static ObjectChurnStats::Second &historyEntry(ObjectChurnStats *stats, qint64 second)
+{
+    ObjectChurnStats::Second &entry = stats->history[second % ObjectChurnStats::RateHistory];
+    if (entry.second != second) {
+        entry.second = second;
+        entry.created = 0;
+        entry.destroyed = 0;
+    }
+    return entry;
+}
+
+void ObjectChurnStats::addCreation(qint64 second)
+{
+    ++created;
+    ++historyEntry(this, second).created;
+}
+
+void ObjectChurnStats::addDestruction(qint64 second, qint64 lifetime)
+{
+    ++destroyed;
+    ++historyEntry(this, second).destroyed;
+    if (lifetime < ObjectChurnRecorder::ShortLivedThreshold)
+        ++shortLived;
+
+    int bucket = 0;
+    for (quint64 l = std::max<qint64>(lifetime, 0); l > 1 && bucket < LifetimeBuckets - 1; l >>= 1)
+        ++bucket;
+    ++lifetimeHistogram[bucket];
+}
+
+double ObjectChurnStats::creationRate(qint64 now, int window) const
+{
+    quint64 count = 0;
+    for (int i = 0; i < RateHistory; ++i) {
+        if (history[i].second >= now - window && history[i].second < now)
+            count += history[i].created;
+    }
+    return double(count) / window;
+}
+
+double ObjectChurnStats::destructionRate(qint64 now, int window) const
+{
+    quint64 count = 0;
+    for (int i = 0; i < RateHistory; ++i) {
+        if (history[i].second >= now - window && history[i].second < now)
+            count += history[i].destroyed;
+    }
+    return double(count) / window;
+}
+
+qint64 ObjectChurnStats::lifetimePercentile(double fraction) const
+{
+    if (!destroyed)
+        return 0;
+
+    const quint64 threshold = std::max<quint64>(1, quint64(std::ceil(fraction * destroyed)));
+    quint64 sum = 0;
+    for (int i = 0; i < LifetimeBuckets; ++i) {
+        sum += lifetimeHistogram[i];
+        if (sum >= threshold)
+            return bucketUpperBound(i);
+    }
+    return bucketUpperBound(LifetimeBuckets - 1);
+}
+
+qint64 ObjectChurnStats::bucketUpperBound(int bucket)
+{
+    return (qint64(1) << (bucket + 1)) - 1;
+}
+
+ObjectChurnRecorder::ObjectChurnRecorder()
+    : m_sampleInterval(0)
+    , m_creationCount(0)
+{
+    m_clock.start();
+}
+
+ObjectChurnRecorder::~ObjectChurnRecorder()
+{
+}
+
+void ObjectChurnRecorder::objectCreated(QObject *object)
+{
+    QMutexLocker lock(&m_mutex);
+    ObjectInfo info;
+    info.creationTime = m_clock.nsecsElapsed() / 1000;
+    info.metaObject = 0;
+    info.creationSite = -1;
+    if (m_sampleInterval > 0 && (m_creationCount++ % m_sampleInterval) == 0)
+        info.creationSite = m_sites.capture(MaxCreationSiteFrames);
+    m_objects.insert(object, info);
+}
+
+void ObjectChurnRecorder::objectConstructed(QObject *object)
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_objects.find(object);
+    if (it == m_objects.end() || it.value().metaObject)
+        return;
+    it.value().metaObject = object->metaObject();
+    m_stats[it.value().metaObject].addCreation(it.value().creationTime / 1000000);
+}
+
+void ObjectChurnRecorder::objectDestroyed(QObject *object)
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_objects.find(object);
+    if (it == m_objects.end())
+        return; // created before we started recording
+    const ObjectInfo info = it.value();
+    m_objects.erase(it);
+    if (!info.metaObject)
+        return; // never fully constructed, ~QObject doesn't tell us what this was anymore
+
+    const qint64 now = m_clock.nsecsElapsed() / 1000;
+    ObjectChurnStats &stats = m_stats[info.metaObject];
+    const qint64 lifetime = now - info.creationTime;
+    stats.addDestruction(now / 1000000, lifetime);
+
+    if (info.creationSite >= 0 && lifetime < ShortLivedThreshold)
+        ++m_creationSites[info.metaObject][info.creationSite];
+}
+
+void ObjectChurnRecorder::setBacktraceSampleInterval(int interval)
+{
+    QMutexLocker lock(&m_mutex);
+    m_sampleInterval = std::max(0, interval);
+}
+
+void ObjectChurnRecorder::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stats.clear();
+    m_creationSites.clear();
+    // objects still alive keep being tracked, but no longer refer to a creation site
+    for (auto it = m_objects.begin(); it != m_objects.end(); ++it)
+        it->creationSite = -1;
+    m_sites.clear();
+    m_resolvedSites.clear();
+}
+
+qint64 ObjectChurnRecorder::currentSecond() const
+{
+    return m_clock.elapsed() / 1000;
+}
+
+QHash<const QMetaObject *, ObjectChurnStats> ObjectChurnRecorder::stats() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stats;
+}
+
+QHash<int, quint64> ObjectChurnRecorder::creationSites(const QMetaObject *mo) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_creationSites.value(mo);
+}
+
+Backtrace ObjectChurnRecorder::creationSite(int id) const
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_resolvedSites.constFind(id);
+    if (it != m_resolvedSites.constEnd())
+        return it.value();
+
+    const QByteArray site = m_sites.stack(id);
+    if (site.isEmpty())
+        return Backtrace();
+
+    const Backtrace backtrace
+        = symbolizeBacktrace(reinterpret_cast<void *const *>(site.constData()),
+                             site.size() / int(sizeof(void *)));
+    m_resolvedSites.insert(id, backtrace);
+    return backtrace;
+}
@@ -0,0 +1,140 @@
+/*
+  objectchurnrecorder.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_OBJECTCHURNRECORDER_H
+#define GAMMARAY_OBJECTCHURNRECORDER_H
+
+#include <core/tools/messagehandler/backtrace.h>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+struct QMetaObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Creation and destruction statistics of one class. */
+struct ObjectChurnStats
+{
+    enum {
+        // bucket i holds lifetimes in [2^i, 2^(i+1)) us, the last one everything above
+        LifetimeBuckets = 32,
+        // length of the longest rate window, in seconds
+        RateHistory = 60
+    };
+
+    ObjectChurnStats();
+
+    void addCreation(qint64 second);
+    void addDestruction(qint64 second, qint64 lifetime);
+
+    /** Average number of creations or destructions per second in the last @p window
+     *  completed seconds before @p now.
+     */
+    double creationRate(qint64 now, int window) const;
+    double destructionRate(qint64 now, int window) const;
+
+    /** Estimated lifetime in us below which @p fraction of all destroyed objects stayed. */
+    qint64 lifetimePercentile(double fraction) const;
+    static qint64 bucketUpperBound(int bucket);
+
+    quint64 created;
+    quint64 destroyed;
+    quint64 shortLived;
+    quint32 lifetimeHistogram[LifetimeBuckets];
+
+    struct Second
+    {
+        qint64 second;
+        quint32 created;
+        quint32 destroyed;
+    };
+    Second history[RateHistory];
+};
+
+/** Records object lifetimes from the probe's object lifetime callbacks.
+ *  The class of an object is only known once it has been fully constructed, objects
+ *  destroyed before that are not accounted for, as on destruction their class can't be
+ *  determined anymore either.
+ *  Creation backtraces can be sampled to find out where short-lived objects come from.
+ */
+class ObjectChurnRecorder
+{
+public:
+    /** Objects destroyed before reaching this lifetime (in us) are considered short-lived. */
+    static const qint64 ShortLivedThreshold = 100000;
+
+    ObjectChurnRecorder();
+    ~ObjectChurnRecorder();
+
+    // any thread
+    void objectCreated(QObject *object);
+    void objectDestroyed(QObject *object);
+    /** Called once @p object has been fully constructed, from the probe's thread. */
+    void objectConstructed(QObject *object);
+
+    /** Capture a creation backtrace for every @p interval-th object, 0 disables sampling. */
+    void setBacktraceSampleInterval(int interval);
+    void clear();
+
+    /** Seconds since start, as used for the rate history. */
+    qint64 currentSecond() const;
+    QHash<const QMetaObject *, ObjectChurnStats> stats() const;
+    /** Number of sampled short-lived objects of class @p mo, by creation backtrace. */
+    QHash<int, quint64> creationSites(const QMetaObject *mo) const;
+    /** Resolved frames of a creation backtrace returned by creationSites(). */
+    Backtrace creationSite(int id) const;
+
+private:
+    struct ObjectInfo
+    {
+        qint64 creationTime; // us
+        const QMetaObject *metaObject; // null until fully constructed
+        int creationSite; // -1 if not sampled
+    };
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    QHash<QObject *, ObjectInfo> m_objects;
+    QHash<const QMetaObject *, ObjectChurnStats> m_stats;
+    QHash<const QMetaObject *, QHash<int, quint64> > m_creationSites;
+
+    // creation backtraces are stored only once and resolved on demand
+    BacktraceTable m_sites;
+    mutable QHash<int, Backtrace> m_resolvedSites;
+
+    int m_sampleInterval;
+    quint64 m_creationCount;
+};
+}
+
+#endif // GAMMARAY_OBJECTCHURNRECORDER_H
@@ -0,0 +1,99 @@
+/*
+  objectchurnwidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "objectchurnwidget.h"
+#include "ui_objectchurnwidget.h"
+#include "objectchurnclient.h"
+
+#include <ui/searchlinecontroller.h>
+
+#include <common/objectbroker.h>
+
+using namespace GammaRay;
+
+static QObject *objectChurnClientFactory(const QString &, QObject *parent)
+{
+    return new ObjectChurnClient(parent);
+}
+
+ObjectChurnWidget::ObjectChurnWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::ObjectChurnWidget)
+    , m_stateManager(this)
+    , m_interface(0)
+{
+    ObjectBroker::registerClientObjectFactoryCallback<ObjectChurnInterface *>(
+        objectChurnClientFactory);
+    m_interface = ObjectBroker::object<ObjectChurnInterface *>();
+
+    ui->setupUi(this);
+
+    auto classModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ObjectChurnModel"));
+    new SearchLineController(ui->searchLine, classModel);
+    ui->classView->header()->setObjectName("classViewHeader");
+    ui->classView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    for (int i = 1; i < 12; ++i)
+        ui->classView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    ui->classView->setModel(classModel);
+    ui->classView->setSelectionModel(ObjectBroker::selectionModel(classModel));
+    ui->classView->sortByColumn(10, Qt::DescendingOrder); // short-lived objects
+
+    ui->lifetimeView->header()->setObjectName("lifetimeViewHeader");
+    ui->lifetimeView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    ui->lifetimeView->setDeferredResizeMode(1, QHeaderView::ResizeToContents);
+    ui->lifetimeView->setModel(ObjectBroker::model(QStringLiteral(
+                                                       "com.kdab.GammaRay.ObjectLifetimeModel")));
+
+    ui->siteView->header()->setObjectName("siteViewHeader");
+    ui->siteView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    ui->siteView->setDeferredResizeMode(1, QHeaderView::ResizeToContents);
+    ui->siteView->setModel(ObjectBroker::model(QStringLiteral(
+                                                   "com.kdab.GammaRay.ObjectCreationSiteModel")));
+
+    m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "60%" << "40%");
+    m_stateManager.setDefaultSizes(ui->detailSplitter, UISizeVector() << "30%" << "70%");
+
+    sampleIntervalChanged();
+    connect(m_interface, SIGNAL(backtraceSampleIntervalChanged()), this, SLOT(sampleIntervalChanged()));
+    connect(ui->sampleIntervalBox, SIGNAL(valueChanged(int)), this, SLOT(sampleIntervalEdited(int)));
+    connect(ui->clearButton, SIGNAL(clicked()), m_interface, SLOT(clear()));
+}
+
+ObjectChurnWidget::~ObjectChurnWidget()
+{
+}
+
+void ObjectChurnWidget::sampleIntervalChanged()
+{
+    if (ui->sampleIntervalBox->value() != m_interface->backtraceSampleInterval())
+        ui->sampleIntervalBox->setValue(m_interface->backtraceSampleInterval());
+}
+
+void ObjectChurnWidget::sampleIntervalEdited(int interval)
+{
+    m_interface->setBacktraceSampleInterval(interval);
+}
@@ -0,0 +1,186 @@
+/*
+  retainedsize.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "retainedsize.h"
+#include "retainedsizemodel.h"
+
+#include <core/objectdataprovider.h>
+#include <core/probe.h>
+#include <core/probeinterface.h>
+#include <core/remote/serverproxymodel.h>
+#include <core/util.h>
+
+#include <common/objectmodel.h>
+
+#include <QMutexLocker>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+
+using namespace GammaRay;
+
+// time spent measuring per slice, and the interval between slices
+static const int MeasureBudget = 5; // ms
+static const int MeasureInterval = 50; // ms
+// interval in which all objects get measured again
+static const int FullMeasurementInterval = 10000; // ms
+static const int TopRetainerCount = 100;
+
+RetainedSize::RetainedSize(ProbeInterface *probe, QObject *parent)
+    : QObject(parent)
+    , m_model(new RetainedSizeModel(this))
+    , m_measureTimer(new QTimer(this))
+    , m_updateTimer(new QTimer(this))
+{
+    auto proxy = new ServerProxyModel<QSortFilterProxyModel>(this);
+    proxy->setSourceModel(m_model);
+    proxy->addRole(ObjectModel::ObjectIdRole);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.RetainedSizeModel"), proxy);
+
+    connect(probe->probe(), SIGNAL(objectsCreated(QVector<QObject*>)),
+            this, SLOT(objectsCreated(QVector<QObject*>)));
+    connect(probe->probe(), SIGNAL(objectDestroyed(QObject*)),
+            this, SLOT(objectDestroyed(QObject*)));
+    connect(probe->probe(), SIGNAL(objectReparented(QObject*)),
+            this, SLOT(objectReparented(QObject*)));
+
+    // pick up everything discovered before we were created
+    const QAbstractItemModel *objectModel = probe->objectListModel();
+    QVector<QObject *> objects;
+    objects.reserve(objectModel->rowCount());
+    for (int i = 0; i < objectModel->rowCount(); ++i)
+        objects.push_back(objectModel->index(i, 0).data(ObjectModel::ObjectRole).value<QObject *>());
+    objectsCreated(objects);
+    m_lastFullMeasurement.start();
+
+    m_measureTimer->setInterval(MeasureInterval);
+    connect(m_measureTimer, SIGNAL(timeout()), this, SLOT(measurePending()));
+    m_measureTimer->start();
+
+    m_updateTimer->setInterval(1000);
+    connect(m_updateTimer, SIGNAL(timeout()), this, SLOT(updateModel()));
+    m_updateTimer->start();
+}
+
+RetainedSize::~RetainedSize()
+{
+}
+
+void RetainedSize::addObject(QObject *object)
+{
+    if (m_tree.contains(object))
+        return;
+    // parents might arrive later than their children, see ObjectTreeModel
+    QObject *parent = object->parent();
+    if (parent && !m_tree.contains(parent) && Probe::instance()->isValidObject(parent))
+        addObject(parent);
+    m_tree.addObject(object, parent);
+    m_pending.push_back(object);
+}
+
+void RetainedSize::objectsCreated(const QVector<QObject *> &objects)
+{
+    QMutexLocker lock(Probe::objectLock());
+    foreach (QObject *object, objects) {
+        if (object && Probe::instance()->isValidObject(object))
+            addObject(object);
+    }
+}
+
+void RetainedSize::objectDestroyed(QObject *object)
+{
+    m_tree.removeObject(object);
+}
+
+void RetainedSize::objectReparented(QObject *object)
+{
+    QMutexLocker lock(Probe::objectLock());
+    if (!Probe::instance()->isValidObject(object)) {
+        m_tree.removeObject(object);
+        return;
+    }
+    if (!m_tree.contains(object)) {
+        addObject(object);
+        return;
+    }
+
+    QObject *parent = object->parent();
+    if (parent && !m_tree.contains(parent) && Probe::instance()->isValidObject(parent))
+        addObject(parent);
+    QObject *oldParent = m_tree.parent(object);
+    m_tree.reparentObject(object, parent);
+    // the child lists are part of the parents' own size
+    m_pending.push_back(object);
+    if (oldParent)
+        m_pending.push_back(oldParent);
+    if (parent)
+        m_pending.push_back(parent);
+}
+
+void RetainedSize::measurePending()
+{
+    if (m_pending.isEmpty()) {
+        if (m_lastFullMeasurement.elapsed() < FullMeasurementInterval)
+            return;
+        m_pending = m_tree.objects();
+        m_lastFullMeasurement.restart();
+    }
+
+    QElapsedTimer budget;
+    budget.start();
+    QMutexLocker lock(Probe::objectLock());
+    while (!m_pending.isEmpty() && budget.elapsed() < MeasureBudget) {
+        QObject *object = m_pending.last();
+        m_pending.pop_back();
+        if (!m_tree.contains(object) || !Probe::instance()->isValidObject(object))
+            continue;
+        m_tree.setSelfSize(object, m_estimator.selfSize(object));
+    }
+}
+
+void RetainedSize::updateModel()
+{
+    const QVector<QObject *> top = m_tree.topRetainers(TopRetainerCount);
+
+    QVector<RetainedSizeModel::Row> rows;
+    rows.reserve(top.size());
+    QMutexLocker lock(Probe::objectLock());
+    foreach (QObject *object, top) {
+        if (!Probe::instance()->isValidObject(object))
+            continue;
+        RetainedSizeModel::Row row;
+        row.object = object;
+        row.name = Util::shortDisplayString(object);
+        row.type = ObjectDataProvider::typeName(object);
+        row.selfSize = m_tree.selfSize(object);
+        row.retainedSize = m_tree.retainedSize(object);
+        row.objectCount = m_tree.objectCount(object);
+        rows.push_back(row);
+    }
+    lock.unlock();
+
+    m_model->setRows(rows);
+}
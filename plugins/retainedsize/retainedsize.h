@@ -0,0 +1,91 @@
+/*
+  retainedsize.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_RETAINEDSIZE_H
+#define GAMMARAY_RETAINEDSIZE_H
+
+#include "retainedsizeestimator.h"
+#include "retainedsizetree.h"
+
+#include <core/toolfactory.h>
+
+#include <QElapsedTimer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+class RetainedSizeModel;
+
+/** Estimates the memory retained by each object including its children.
+ *
+ *  Object sizes are measured in small time slices on the probe's thread: newly
+ *  seen objects first, then all known objects again periodically, as payloads
+ *  like images or model content change without any notification.
+ */
+class RetainedSize : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RetainedSize(ProbeInterface *probe, QObject *parent = 0);
+    ~RetainedSize();
+
+private slots:
+    void objectsCreated(const QVector<QObject *> &objects);
+    void objectDestroyed(QObject *object);
+    void objectReparented(QObject *object);
+    void measurePending();
+    void updateModel();
+
+private:
+    void addObject(QObject *object);
+
+    RetainedSizeEstimator m_estimator;
+    RetainedSizeTree m_tree;
+    RetainedSizeModel *m_model;
+    QVector<QObject *> m_pending;
+    QElapsedTimer m_lastFullMeasurement;
+    QTimer *m_measureTimer;
+    QTimer *m_updateTimer;
+};
+
+class RetainedSizeFactory : public QObject, public StandardToolFactory<QObject, RetainedSize>
+{
+    Q_OBJECT
+    Q_INTERFACES(GammaRay::ToolFactory)
+    Q_PLUGIN_METADATA(IID "com.kdab.GammaRay.ToolFactory" FILE "gammaray_retainedsize.json")
+public:
+    explicit RetainedSizeFactory(QObject *parent = Q_NULLPTR)
+        : QObject(parent)
+    {
+    }
+};
+}
+
+#endif // GAMMARAY_RETAINEDSIZE_H
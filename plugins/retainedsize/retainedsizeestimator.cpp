@@ -0,0 +1,187 @@
+/*
+  retainedsizeestimator.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config-gammaray.h>
+
+#include "retainedsizeestimator.h"
+
+#include <QAbstractItemModel>
+#include <QByteArray>
+#include <QImage>
+#include <QPixmap>
+#include <QStringList>
+#include <QTextDocument>
+#include <QThread>
+#include <QVariant>
+
+#ifdef HAVE_MALLOC_USABLE_SIZE
+#include <malloc.h>
+#endif
+
+using namespace GammaRay;
+
+namespace {
+class UnprotectedQObject : public QObject
+{
+public:
+    inline QObjectData *data() const { return d_ptr.data(); }
+};
+}
+
+static qint64 byteArraySize(const QVariant &value)
+{
+    return value.toByteArray().capacity();
+}
+
+static qint64 stringSize(const QVariant &value)
+{
+    return value.toString().capacity() * sizeof(QChar);
+}
+
+static qint64 stringListSize(const QVariant &value)
+{
+    const QStringList list = value.toStringList();
+    qint64 size = list.size() * sizeof(QString);
+    foreach (const QString &s, list)
+        size += s.capacity() * sizeof(QChar);
+    return size;
+}
+
+static qint64 imageSize(const QVariant &value)
+{
+    return value.value<QImage>().byteCount();
+}
+
+static qint64 pixmapSize(const QVariant &value)
+{
+    const QPixmap pixmap = value.value<QPixmap>();
+    return qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+static qint64 itemModelSize(QObject *object)
+{
+    // rough guess of a few values per cell, only counting the top level
+    // as traversing entire trees is way too expensive here
+    static const qint64 cellSize = 2 * sizeof(QVariant);
+    const QAbstractItemModel *model = static_cast<QAbstractItemModel *>(object);
+    return qint64(model->rowCount()) * model->columnCount() * cellSize;
+}
+
+static qint64 textDocumentSize(QObject *object)
+{
+    // the text itself, formats and layout data come on top of that but are hard to estimate
+    const QTextDocument *document = static_cast<QTextDocument *>(object);
+    return qint64(document->characterCount()) * sizeof(QChar);
+}
+
+static bool inherits(const QMetaObject *mo, const QMetaObject *base)
+{
+    for (; mo; mo = mo->superClass()) {
+        if (mo == base)
+            return true;
+    }
+    return false;
+}
+
+RetainedSizeEstimator::RetainedSizeEstimator()
+{
+    registerValueType(QMetaType::QByteArray, byteArraySize);
+    registerValueType(QMetaType::QString, stringSize);
+    registerValueType(QMetaType::QStringList, stringListSize);
+    registerValueType(QMetaType::QImage, imageSize);
+    registerValueType(QMetaType::QPixmap, pixmapSize);
+    registerObjectType(&QAbstractItemModel::staticMetaObject, itemModelSize);
+    registerObjectType(&QTextDocument::staticMetaObject, textDocumentSize);
+}
+
+void RetainedSizeEstimator::registerValueType(int metaTypeId, ValueSizeFunc func)
+{
+    m_valueFuncs.insert(metaTypeId, func);
+    m_typeInfos.clear();
+}
+
+void RetainedSizeEstimator::registerObjectType(const QMetaObject *mo, ObjectSizeFunc func)
+{
+    m_objectFuncs.push_back(qMakePair(mo, func));
+    m_typeInfos.clear();
+}
+
+const RetainedSizeEstimator::TypeInfo &RetainedSizeEstimator::typeInfo(const QMetaObject *mo)
+{
+    auto it = m_typeInfos.find(mo);
+    if (it != m_typeInfos.end())
+        return it.value();
+
+    TypeInfo info;
+    typedef QPair<const QMetaObject *, ObjectSizeFunc> ObjectFunc;
+    foreach (const ObjectFunc &objectFunc, m_objectFuncs) {
+        if (inherits(mo, objectFunc.first))
+            info.objectFuncs.push_back(objectFunc.second);
+    }
+    return m_typeInfos.insert(mo, info).value();
+}
+
+qint64 RetainedSizeEstimator::selfSize(QObject *object)
+{
+    // we can't ask the allocator for the object itself, it might live on the stack or
+    // be a member of another object, the private data however is always heap allocated
+    qint64 size = sizeof(QObject);
+    const QObjectData *d = static_cast<UnprotectedQObject *>(object)->data();
+    const qint64 privateSize = allocationSize(d);
+    size += privateSize > 0 ? privateSize : qint64(sizeof(QObjectData));
+    size += object->children().size() * sizeof(QObject *);
+
+    if (object->thread() != QThread::currentThread())
+        return size;
+
+    // static properties are not looked at, their getters can compute the value on every call
+    // (think QTextEdit::html), which is expensive and only measures a temporary
+    const TypeInfo &info = typeInfo(object->metaObject());
+    foreach (ObjectSizeFunc func, info.objectFuncs)
+        size += func(object);
+
+    // dynamic properties on the other hand are stored values, reading them is cheap
+    foreach (const QByteArray &name, object->dynamicPropertyNames()) {
+        const QVariant value = object->property(name);
+        size += name.capacity() + sizeof(QVariant);
+        const ValueSizeFunc func = m_valueFuncs.value(value.userType());
+        if (func)
+            size += func(value);
+    }
+
+    return size;
+}
+
+qint64 RetainedSizeEstimator::allocationSize(const void *ptr)
+{
+#ifdef HAVE_MALLOC_USABLE_SIZE
+    return malloc_usable_size(const_cast<void *>(ptr));
+#else
+    Q_UNUSED(ptr);
+    return 0;
+#endif
+}
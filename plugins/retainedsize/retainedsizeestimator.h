@@ -0,0 +1,87 @@
+/*
+  retainedsizeestimator.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_RETAINEDSIZEESTIMATOR_H
+#define GAMMARAY_RETAINEDSIZEESTIMATOR_H
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+class QVariant;
+struct QMetaObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Estimates the heap memory a single QObject keeps alive, not including its children.
+ *
+ *  This consists of the object itself, its private data and payloads found through
+ *  per-type hooks: dynamic property values (e.g. images or byte arrays) and class specific
+ *  data (e.g. the content of item models). Implicitly shared payloads are accounted
+ *  for every object referencing them, so results are an upper bound in that respect.
+ */
+class RetainedSizeEstimator
+{
+public:
+    typedef qint64 (*ValueSizeFunc)(const QVariant &value);
+    typedef qint64 (*ObjectSizeFunc)(QObject *object);
+
+    RetainedSizeEstimator();
+
+    /** Accounts the payload of dynamic property values of type @p metaTypeId to the owning object. */
+    void registerValueType(int metaTypeId, ValueSizeFunc func);
+    /** Accounts the payload reported by @p func to all objects inheriting @p mo.
+     *  @p func is called with the probe's object lock held, so it must only look at data
+     *  the object stores anyway, and not call getters that compute their result.
+     */
+    void registerObjectType(const QMetaObject *mo, ObjectSizeFunc func);
+
+    /** Estimated size of @p object in bytes.
+     *  Payload hooks are only used if @p object lives in the current thread, as they
+     *  need to call into the object. Must be called with the probe's object lock held.
+     */
+    qint64 selfSize(QObject *object);
+
+    /** Usable size of the heap block at @p ptr, or 0 if that cannot be determined. */
+    static qint64 allocationSize(const void *ptr);
+
+private:
+    struct TypeInfo
+    {
+        QVector<ObjectSizeFunc> objectFuncs;
+    };
+    const TypeInfo &typeInfo(const QMetaObject *mo);
+
+    QHash<int, ValueSizeFunc> m_valueFuncs;
+    QVector<QPair<const QMetaObject *, ObjectSizeFunc> > m_objectFuncs;
+    QHash<const QMetaObject *, TypeInfo> m_typeInfos;
+};
+}
+
+#endif // GAMMARAY_RETAINEDSIZEESTIMATOR_H
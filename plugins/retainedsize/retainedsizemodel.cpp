@@ -0,0 +1,137 @@
+/*
+  retainedsizemodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "retainedsizemodel.h"
+
+#include <common/objectid.h>
+#include <common/objectmodel.h>
+
+using namespace GammaRay;
+
+RetainedSizeModel::RetainedSizeModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+RetainedSizeModel::~RetainedSizeModel()
+{
+}
+
+void RetainedSizeModel::setRows(const QVector<Row> &rows)
+{
+    bool sameObjects = rows.size() == m_rows.size();
+    for (int i = 0; sameObjects && i < rows.size(); ++i)
+        sameObjects = rows.at(i).object == m_rows.at(i).object;
+
+    if (!sameObjects) {
+        beginResetModel();
+        m_rows = rows;
+        endResetModel();
+        return;
+    }
+
+    m_rows = rows;
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, 0), index(m_rows.size() - 1, COLUMN_COUNT - 1));
+}
+
+int RetainedSizeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int RetainedSizeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant RetainedSizeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const Row &row = m_rows.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ObjectColumn:
+            return row.name;
+        case TypeColumn:
+            return row.type;
+        case SelfSizeColumn:
+            return row.selfSize;
+        case RetainedSizeColumn:
+            return row.retainedSize;
+        case ObjectCountColumn:
+            return row.objectCount;
+        }
+    } else if (role == Qt::TextAlignmentRole && index.column() >= SelfSizeColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    } else if (role == ObjectModel::ObjectIdRole && index.column() == ObjectColumn) {
+        return QVariant::fromValue(ObjectId(row.object));
+    }
+    return QVariant();
+}
+
+QVariant RetainedSizeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ObjectColumn:
+            return tr("Object");
+        case TypeColumn:
+            return tr("Type");
+        case SelfSizeColumn:
+            return tr("Self [B]");
+        case RetainedSizeColumn:
+            return tr("Retained [B]");
+        case ObjectCountColumn:
+            return tr("Objects");
+        }
+    }
+    if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        switch (section) {
+        case SelfSizeColumn:
+            return tr("Estimated memory used by the object itself, its private data and payloads like images or model content.");
+        case RetainedSizeColumn:
+            return tr("Estimated memory that would be freed by deleting the object, including all its children.");
+        case ObjectCountColumn:
+            return tr("Number of objects in the subtree, including the object itself.");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QMap<int, QVariant> RetainedSizeModel::itemData(const QModelIndex &index) const
+{
+    auto d = QAbstractTableModel::itemData(index);
+    if (index.column() == ObjectColumn)
+        d.insert(ObjectModel::ObjectIdRole, data(index, ObjectModel::ObjectIdRole));
+    return d;
+}
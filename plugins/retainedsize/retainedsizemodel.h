@@ -0,0 +1,76 @@
+/*
+  retainedsizemodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_RETAINEDSIZEMODEL_H
+#define GAMMARAY_RETAINEDSIZEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+namespace GammaRay {
+/** The objects retaining the most memory, including their children. */
+class RetainedSizeModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        ObjectColumn,
+        TypeColumn,
+        SelfSizeColumn,
+        RetainedSizeColumn,
+        ObjectCountColumn,
+        COLUMN_COUNT
+    };
+
+    struct Row
+    {
+        QObject *object;
+        QString name;
+        QString type;
+        qint64 selfSize;
+        qint64 retainedSize;
+        int objectCount;
+    };
+
+    explicit RetainedSizeModel(QObject *parent = 0);
+    ~RetainedSizeModel();
+
+    void setRows(const QVector<Row> &rows);
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QMap<int, QVariant> itemData(const QModelIndex &index) const Q_DECL_OVERRIDE;
+
+private:
+    QVector<Row> m_rows;
+};
+}
+
+#endif // GAMMARAY_RETAINEDSIZEMODEL_H
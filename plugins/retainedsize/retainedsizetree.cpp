@@ -0,0 +1,185 @@
+/*
+  retainedsizetree.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "retainedsizetree.h"
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+RetainedSizeTree::RetainedSizeTree()
+{
+}
+
+void RetainedSizeTree::addObject(QObject *object, QObject *parent)
+{
+    if (m_nodes.contains(object))
+        return;
+
+    Node node;
+    auto parentIt = m_nodes.find(parent);
+    if (parentIt != m_nodes.end()) {
+        node.parent = parent;
+        parentIt->children.push_back(object);
+    }
+    m_nodes.insert(object, node);
+    propagate(node.parent, 0, 1);
+}
+
+void RetainedSizeTree::removeObject(QObject *object)
+{
+    auto it = m_nodes.find(object);
+    if (it == m_nodes.end())
+        return;
+
+    // children get destroyed after their parent, until then they are roots of their own
+    foreach (QObject *child, it->children)
+        m_nodes[child].parent = 0;
+
+    QObject *parent = it->parent;
+    const qint64 retained = it->retainedSize;
+    const int count = it->objectCount;
+    m_nodes.erase(it);
+
+    if (parent) {
+        m_nodes[parent].children.removeOne(object);
+        propagate(parent, -retained, -count);
+    }
+}
+
+void RetainedSizeTree::reparentObject(QObject *object, QObject *newParent)
+{
+    auto it = m_nodes.find(object);
+    if (it == m_nodes.end())
+        return;
+    if (!m_nodes.contains(newParent))
+        newParent = 0;
+    QObject *oldParent = it->parent;
+    if (oldParent == newParent)
+        return;
+
+    // moving an object below one of its own descendants would create a cycle
+    for (QObject *p = newParent; p; p = m_nodes.value(p).parent) {
+        if (p == object)
+            return;
+    }
+
+    const qint64 retained = it->retainedSize;
+    const int count = it->objectCount;
+    it->parent = newParent;
+    if (oldParent) {
+        m_nodes[oldParent].children.removeOne(object);
+        propagate(oldParent, -retained, -count);
+    }
+    if (newParent) {
+        m_nodes[newParent].children.push_back(object);
+        propagate(newParent, retained, count);
+    }
+}
+
+void RetainedSizeTree::setSelfSize(QObject *object, qint64 size)
+{
+    auto it = m_nodes.find(object);
+    if (it == m_nodes.end())
+        return;
+    const qint64 delta = size - it->selfSize;
+    if (delta == 0)
+        return;
+    it->selfSize = size;
+    it->retainedSize += delta;
+    propagate(it->parent, delta, 0);
+}
+
+void RetainedSizeTree::clear()
+{
+    m_nodes.clear();
+}
+
+void RetainedSizeTree::propagate(QObject *parent, qint64 sizeDelta, int countDelta)
+{
+    while (parent) {
+        Node &node = m_nodes[parent];
+        node.retainedSize += sizeDelta;
+        node.objectCount += countDelta;
+        parent = node.parent;
+    }
+}
+
+bool RetainedSizeTree::contains(QObject *object) const
+{
+    return m_nodes.contains(object);
+}
+
+QObject *RetainedSizeTree::parent(QObject *object) const
+{
+    return m_nodes.value(object).parent;
+}
+
+qint64 RetainedSizeTree::selfSize(QObject *object) const
+{
+    return m_nodes.value(object).selfSize;
+}
+
+qint64 RetainedSizeTree::retainedSize(QObject *object) const
+{
+    return m_nodes.value(object).retainedSize;
+}
+
+int RetainedSizeTree::objectCount(QObject *object) const
+{
+    const auto it = m_nodes.constFind(object);
+    return it == m_nodes.constEnd() ? 0 : it->objectCount;
+}
+
+QVector<QObject *> RetainedSizeTree::objects() const
+{
+    QVector<QObject *> objects;
+    objects.reserve(m_nodes.size());
+    for (auto it = m_nodes.constBegin(); it != m_nodes.constEnd(); ++it)
+        objects.push_back(it.key());
+    return objects;
+}
+
+QVector<QObject *> RetainedSizeTree::topRetainers(int count) const
+{
+    QVector<QPair<qint64, QObject *> > sizes;
+    sizes.reserve(m_nodes.size());
+    for (auto it = m_nodes.constBegin(); it != m_nodes.constEnd(); ++it)
+        sizes.push_back(qMakePair(it->retainedSize, it.key()));
+
+    count = std::min(count, sizes.size());
+    std::partial_sort(sizes.begin(), sizes.begin() + count, sizes.end(),
+                      [](const QPair<qint64, QObject *> &lhs, const QPair<qint64, QObject *> &rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    QVector<QObject *> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i)
+        result.push_back(sizes.at(i).second);
+    return result;
+}
@@ -0,0 +1,93 @@
+/*
+  retainedsizetree.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_RETAINEDSIZETREE_H
+#define GAMMARAY_RETAINEDSIZETREE_H
+
+#include <QHash>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Keeps track of the retained size of every object in the object tree.
+ *
+ *  The retained size of an object is its own size plus the retained sizes of all
+ *  its children. Changes to a single object are propagated to its ancestors, so
+ *  updates are proportional to the tree depth rather than its size.
+ *  Objects are only used as keys here, they are never dereferenced.
+ */
+class RetainedSizeTree
+{
+public:
+    RetainedSizeTree();
+
+    /** Adds @p object below @p parent, which needs to be known already or null. */
+    void addObject(QObject *object, QObject *parent);
+    /** Removes @p object, its remaining children become roots. */
+    void removeObject(QObject *object);
+    void reparentObject(QObject *object, QObject *newParent);
+    void setSelfSize(QObject *object, qint64 size);
+    void clear();
+
+    bool contains(QObject *object) const;
+    QObject *parent(QObject *object) const;
+    qint64 selfSize(QObject *object) const;
+    qint64 retainedSize(QObject *object) const;
+    /** Number of objects in the subtree of @p object, including itself. */
+    int objectCount(QObject *object) const;
+
+    QVector<QObject *> objects() const;
+    /** The @p count objects with the largest retained size, largest first. */
+    QVector<QObject *> topRetainers(int count) const;
+
+private:
+    void propagate(QObject *parent, qint64 sizeDelta, int countDelta);
+
+    struct Node
+    {
+        Node()
+            : parent(0)
+            , selfSize(0)
+            , retainedSize(0)
+            , objectCount(1)
+        {
+        }
+
+        QObject *parent;
+        QVector<QObject *> children;
+        qint64 selfSize;
+        qint64 retainedSize;
+        int objectCount;
+    };
+    QHash<QObject *, Node> m_nodes;
+};
+}
+
+#endif // GAMMARAY_RETAINEDSIZETREE_H
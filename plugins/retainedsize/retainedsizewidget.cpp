@@ -0,0 +1,79 @@
+/*
+  retainedsizewidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "retainedsizewidget.h"
+#include "ui_retainedsizewidget.h"
+
+#include <ui/contextmenuextension.h>
+#include <ui/searchlinecontroller.h>
+
+#include <common/objectbroker.h>
+#include <common/objectid.h>
+#include <common/objectmodel.h>
+
+#include <QMenu>
+
+using namespace GammaRay;
+
+RetainedSizeWidget::RetainedSizeWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::RetainedSizeWidget)
+    , m_stateManager(this)
+{
+    ui->setupUi(this);
+
+    auto model = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.RetainedSizeModel"));
+    new SearchLineController(ui->searchLine, model);
+    ui->retainerView->header()->setObjectName("retainerViewHeader");
+    ui->retainerView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    for (int i = 1; i < 5; ++i)
+        ui->retainerView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    ui->retainerView->setModel(model);
+    ui->retainerView->sortByColumn(3, Qt::DescendingOrder); // retained size
+    connect(ui->retainerView, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(contextMenu(QPoint)));
+}
+
+RetainedSizeWidget::~RetainedSizeWidget()
+{
+}
+
+void RetainedSizeWidget::contextMenu(QPoint pos)
+{
+    auto index = ui->retainerView->indexAt(pos);
+    if (!index.isValid())
+        return;
+    index = index.sibling(index.row(), 0);
+
+    const auto objectId = index.data(ObjectModel::ObjectIdRole).value<ObjectId>();
+    if (objectId.isNull())
+        return;
+
+    QMenu menu;
+    ContextMenuExtension ext(objectId);
+    ext.populateMenu(&menu);
+    menu.exec(ui->retainerView->viewport()->mapToGlobal(pos));
+}
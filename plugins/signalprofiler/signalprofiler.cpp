@@ -0,0 +1,80 @@
+/*
+  signalprofiler.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "signalprofiler.h"
+#include "signalprofilermodel.h"
+#include "signalprofilerrecorder.h"
+
+#include <core/probeinterface.h>
+#include <core/signalspycallbackset.h>
+
+using namespace GammaRay;
+
+static void signal_begin_callback(QObject *caller, int method_index, void **argv)
+{
+    Q_UNUSED(argv);
+    SignalProfilerRecorder::signalBegin(caller, method_index);
+}
+
+static void signal_end_callback(QObject *caller, int method_index)
+{
+    SignalProfilerRecorder::signalEnd(caller, method_index);
+}
+
+static void slot_begin_callback(QObject *caller, int method_index, void **argv)
+{
+    Q_UNUSED(argv);
+    SignalProfilerRecorder::slotBegin(caller, method_index);
+}
+
+static void slot_end_callback(QObject *caller, int method_index)
+{
+    SignalProfilerRecorder::slotEnd(caller, method_index);
+}
+
+SignalProfiler::SignalProfiler(ProbeInterface *probe, QObject *parent)
+    : SignalProfilerInterface(parent)
+    , m_model(new SignalProfilerModel(this))
+{
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.SignalProfilerModel"), m_model);
+
+    SignalSpyCallbackSet callbacks;
+    callbacks.signalBeginCallback = signal_begin_callback;
+    callbacks.signalEndCallback = signal_end_callback;
+    callbacks.slotBeginCallback = slot_begin_callback;
+    callbacks.slotEndCallback = slot_end_callback;
+    probe->registerSignalSpyCallbackSet(callbacks);
+}
+
+SignalProfiler::~SignalProfiler()
+{
+}
+
+void SignalProfiler::clear()
+{
+    m_model->clear();
+}
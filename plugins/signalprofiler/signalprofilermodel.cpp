@@ -0,0 +1,193 @@
+/*
+  signalprofilermodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "signalprofilermodel.h"
+
+#include <QMetaMethod>
+#include <QMetaObject>
+#include <QTimer>
+
+using namespace GammaRay;
+
+static QString methodName(const QMetaObject *mo, int methodIndex)
+{
+    if (!mo || methodIndex < 0 || methodIndex >= mo->methodCount())
+        return QString();
+    return QString::fromLatin1(mo->className()) + QLatin1String("::")
+           + QString::fromLatin1(mo->method(methodIndex).methodSignature());
+}
+
+SignalProfilerModel::SignalProfilerModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_updateTimer(new QTimer(this))
+{
+    m_updateTimer->setInterval(1000);
+    connect(m_updateTimer, SIGNAL(timeout()), this, SLOT(update()));
+    m_updateTimer->start();
+}
+
+SignalProfilerModel::~SignalProfilerModel()
+{
+}
+
+int SignalProfilerModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+int SignalProfilerModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant SignalProfilerModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return displayData(index.row(), index.column());
+    if (role == Qt::TextAlignmentRole && index.column() >= CallsColumn)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    return QVariant();
+}
+
+QVariant SignalProfilerModel::displayData(int row, int column) const
+{
+    const Row &r = m_rows.at(row);
+    switch (column) {
+    case SenderColumn:
+        if (!r.key.senderType)
+            return tr("<unknown>");
+        return methodName(r.key.senderType, r.key.signalIndex);
+    case ReceiverColumn:
+        if (!r.key.receiverType)
+            return tr("<emission>");
+        return methodName(r.key.receiverType, r.key.slotIndex);
+    case CallsColumn:
+        return r.counters.calls;
+    case InclusiveTimeColumn:
+        return r.counters.inclusiveTime / 1000000.0;
+    case ExclusiveTimeColumn:
+        return r.counters.exclusiveTime / 1000000.0;
+    case AverageTimeColumn:
+        if (!r.counters.calls)
+            return QVariant();
+        return r.counters.inclusiveTime / 1000.0 / r.counters.calls;
+    case NestingColumn:
+        return r.counters.maxNesting;
+    }
+    return QVariant();
+}
+
+QVariant SignalProfilerModel::headerData(int section, Qt::Orientation orientation,
+                                         int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case SenderColumn:
+            return tr("Signal");
+        case ReceiverColumn:
+            return tr("Slot");
+        case CallsColumn:
+            return tr("Calls");
+        case InclusiveTimeColumn:
+            return tr("Total [ms]");
+        case ExclusiveTimeColumn:
+            return tr("Self [ms]");
+        case AverageTimeColumn:
+            return tr("Average [uSecs]");
+        case NestingColumn:
+            return tr("Max. Nesting");
+        }
+    }
+    if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        switch (section) {
+        case ReceiverColumn:
+            return tr("Slot invoked by the signal, or <emission> for the signal emission as a whole.");
+        case InclusiveTimeColumn:
+            return tr("Time spent including nested signals and slots.");
+        case ExclusiveTimeColumn:
+            return tr("Time spent excluding nested signals and slots.");
+        case NestingColumn:
+            return tr("Maximum depth of nested signal emissions and slot invocations.");
+        }
+    }
+    return QVariant();
+}
+
+void SignalProfilerModel::clear()
+{
+    beginResetModel();
+    m_baseline = SignalProfilerRecorder::snapshot();
+    m_rows.clear();
+    m_rowIndex.clear();
+    endResetModel();
+}
+
+void SignalProfilerModel::update()
+{
+    const auto snapshot = SignalProfilerRecorder::snapshot();
+
+    QVector<Row> newRows;
+    for (auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+        SignalProfilerCounters counters = it.value();
+        const auto baseIt = m_baseline.constFind(it.key());
+        if (baseIt != m_baseline.constEnd()) {
+            counters.calls -= baseIt.value().calls;
+            counters.inclusiveTime -= baseIt.value().inclusiveTime;
+            counters.exclusiveTime -= baseIt.value().exclusiveTime;
+        }
+        if (!counters.calls)
+            continue;
+
+        const auto rowIt = m_rowIndex.constFind(it.key());
+        if (rowIt != m_rowIndex.constEnd()) {
+            m_rows[rowIt.value()].counters = counters;
+        } else {
+            Row row;
+            row.key = it.key();
+            row.counters = counters;
+            newRows.push_back(row);
+        }
+    }
+
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, CallsColumn), index(m_rows.size() - 1, COLUMN_COUNT - 1));
+
+    if (newRows.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + newRows.size() - 1);
+    foreach (const Row &row, newRows) {
+        m_rowIndex.insert(row.key, m_rows.size());
+        m_rows.push_back(row);
+    }
+    endInsertRows();
+}
@@ -0,0 +1,87 @@
+/*
+  signalprofilermodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_SIGNALPROFILERMODEL_H
+#define GAMMARAY_SIGNALPROFILERMODEL_H
+
+#include "signalprofilerrecorder.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Periodically collected signal/slot execution statistics. */
+class SignalProfilerModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        SenderColumn,
+        ReceiverColumn,
+        CallsColumn,
+        InclusiveTimeColumn,
+        ExclusiveTimeColumn,
+        AverageTimeColumn,
+        NestingColumn,
+        COLUMN_COUNT
+    };
+
+    explicit SignalProfilerModel(QObject *parent = 0);
+    ~SignalProfilerModel();
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+public slots:
+    void clear();
+
+private slots:
+    void update();
+
+private:
+    QVariant displayData(int row, int column) const;
+
+    struct Row {
+        SignalProfilerKey key;
+        SignalProfilerCounters counters;
+    };
+    QVector<Row> m_rows;
+    QHash<SignalProfilerKey, int> m_rowIndex;
+    // totals at the time of the last clear()
+    QHash<SignalProfilerKey, SignalProfilerCounters> m_baseline;
+    QTimer *m_updateTimer;
+};
+}
+
+#endif // GAMMARAY_SIGNALPROFILERMODEL_H
@@ -0,0 +1,325 @@
+/*
+  signalprofilerrecorder.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "signalprofilerrecorder.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QThreadStorage>
+#include <QVector>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+SignalProfilerKey::SignalProfilerKey()
+    : senderType(0)
+    , signalIndex(-1)
+    , receiverType(0)
+    , slotIndex(-1)
+{
+}
+
+bool SignalProfilerKey::operator==(const SignalProfilerKey &other) const
+{
+    return senderType == other.senderType && signalIndex == other.signalIndex
+           && receiverType == other.receiverType && slotIndex == other.slotIndex;
+}
+
+uint GammaRay::qHash(const SignalProfilerKey &key)
+{
+    quint64 h = quintptr(key.senderType);
+    h = h * 31 + quintptr(key.receiverType);
+    h = h * 31 + uint(key.signalIndex);
+    h = h * 31 + uint(key.slotIndex);
+    return uint(h ^ (h >> 32));
+}
+
+SignalProfilerCounters::SignalProfilerCounters()
+    : calls(0)
+    , inclusiveTime(0)
+    , exclusiveTime(0)
+    , maxNesting(0)
+{
+}
+
+SignalProfilerCounters &SignalProfilerCounters::operator+=(const SignalProfilerCounters &other)
+{
+    calls += other.calls;
+    inclusiveTime += other.inclusiveTime;
+    exclusiveTime += other.exclusiveTime;
+    maxNesting = std::max(maxNesting, other.maxNesting);
+    return *this;
+}
+
+namespace {
+enum {
+    TableSize = 1024, // per thread, power of two
+    MaxStackDepth = 128,
+    MaxRetainedEntries = 16 * TableSize
+};
+
+struct Entry
+{
+    QAtomicInt used; // set once key is valid, the collector must not look at it before
+    SignalProfilerKey key;
+    SignalProfilerCounters counters;
+};
+
+struct Frame
+{
+    QObject *object;
+    int methodIndex;
+    bool isSignal;
+    Entry *entry; // null if the call could not be recorded
+    qint64 startTime;
+    qint64 childTime;
+};
+
+struct ThreadTable
+{
+    ThreadTable()
+        : depth(0)
+        , dropped(0)
+    {
+    }
+
+    Entry entries[TableSize];
+    Frame stack[MaxStackDepth];
+    int depth;
+    quint64 dropped;
+    QAtomicInt finished;
+};
+
+// owned by QThreadStorage, hands the table over to the collector once its thread ends
+struct ThreadTableHolder
+{
+    explicit ThreadTableHolder(ThreadTable *t)
+        : table(t)
+    {
+    }
+
+    ~ThreadTableHolder()
+    {
+        table->finished.storeRelease(1);
+    }
+
+    ThreadTable *table;
+};
+
+struct Registry
+{
+    Registry()
+        : retiredDropped(0)
+    {
+        clock.start();
+    }
+
+    QElapsedTimer clock;
+    QThreadStorage<ThreadTableHolder *> localTable;
+
+    QMutex mutex; // protects the members below, never used on the hot path
+    // not deleted on shutdown, threads still running might write into them until the very end
+    QVector<ThreadTable *> tables;
+    QHash<SignalProfilerKey, SignalProfilerCounters> retired;
+    quint64 retiredDropped;
+};
+}
+
+Q_GLOBAL_STATIC(Registry, s_registry)
+
+static ThreadTable *localTable()
+{
+    Registry *registry = s_registry();
+    if (!registry)
+        return 0;
+    if (ThreadTableHolder *holder = registry->localTable.localData())
+        return holder->table;
+
+    // first call in this thread, only place on the recording side that locks
+    ThreadTable *table = new ThreadTable;
+    registry->localTable.setLocalData(new ThreadTableHolder(table));
+    QMutexLocker lock(&registry->mutex);
+    registry->tables.push_back(table);
+    return table;
+}
+
+static Entry *findEntry(ThreadTable *table, const SignalProfilerKey &key)
+{
+    const uint h = qHash(key);
+    for (int i = 0; i < TableSize; ++i) {
+        Entry *entry = &table->entries[(h + i) & (TableSize - 1)];
+        if (!entry->used.load()) {
+            entry->key = key;
+            entry->used.storeRelease(1);
+            return entry;
+        }
+        if (entry->key == key)
+            return entry;
+    }
+    return 0;
+}
+
+static void begin(QObject *object, int methodIndex, bool isSignal)
+{
+    ThreadTable *table = localTable();
+    if (!table)
+        return;
+
+    if (table->depth == MaxStackDepth) {
+        // we missed too many end callbacks (e.g. for objects deleted in a slot), start over
+        table->depth = 0;
+    }
+
+    SignalProfilerKey key;
+    if (isSignal) {
+        key.senderType = object->metaObject();
+        key.signalIndex = methodIndex;
+    } else {
+        if (table->depth > 0 && table->stack[table->depth - 1].isSignal) {
+            const Frame &signalFrame = table->stack[table->depth - 1];
+            if (signalFrame.entry)
+                key = signalFrame.entry->key;
+        }
+        key.receiverType = object->metaObject();
+        key.slotIndex = methodIndex;
+    }
+
+    Frame &frame = table->stack[table->depth++];
+    frame.object = object;
+    frame.methodIndex = methodIndex;
+    frame.isSignal = isSignal;
+    frame.entry = findEntry(table, key);
+    frame.childTime = 0;
+    if (!frame.entry)
+        ++table->dropped;
+    frame.startTime = s_registry()->clock.nsecsElapsed();
+}
+
+static void end(QObject *object, int methodIndex, bool isSignal)
+{
+    ThreadTable *table = localTable();
+    if (!table)
+        return;
+    const qint64 endTime = s_registry()->clock.nsecsElapsed();
+
+    // end callbacks are skipped for objects deleted meanwhile, so unwind to the matching frame
+    int depth = table->depth;
+    while (depth > 0) {
+        const Frame &frame = table->stack[depth - 1];
+        if (frame.object == object && frame.methodIndex == methodIndex
+            && frame.isSignal == isSignal)
+            break;
+        --depth;
+    }
+    if (depth == 0)
+        return;
+    table->depth = depth - 1;
+
+    const Frame &frame = table->stack[table->depth];
+    const qint64 duration = endTime - frame.startTime;
+    if (table->depth > 0)
+        table->stack[table->depth - 1].childTime += duration;
+    if (!frame.entry)
+        return;
+
+    SignalProfilerCounters &counters = frame.entry->counters;
+    ++counters.calls;
+    counters.inclusiveTime += duration;
+    counters.exclusiveTime += duration - frame.childTime;
+    counters.maxNesting = std::max(counters.maxNesting, table->depth);
+}
+
+void SignalProfilerRecorder::signalBegin(QObject *sender, int signalIndex)
+{
+    begin(sender, signalIndex, true);
+}
+
+void SignalProfilerRecorder::signalEnd(QObject *sender, int signalIndex)
+{
+    end(sender, signalIndex, true);
+}
+
+void SignalProfilerRecorder::slotBegin(QObject *receiver, int slotIndex)
+{
+    begin(receiver, slotIndex, false);
+}
+
+void SignalProfilerRecorder::slotEnd(QObject *receiver, int slotIndex)
+{
+    end(receiver, slotIndex, false);
+}
+
+static void mergeTable(QHash<SignalProfilerKey, SignalProfilerCounters> &result,
+                       const ThreadTable *table)
+{
+    for (int i = 0; i < TableSize; ++i) {
+        const Entry &entry = table->entries[i];
+        if (!entry.used.loadAcquire())
+            continue;
+        // counters are read without synchronization, being slightly off here is fine
+        auto it = result.find(entry.key);
+        if (it != result.end())
+            it.value() += entry.counters;
+        else if (result.size() < MaxRetainedEntries)
+            result.insert(entry.key, entry.counters);
+    }
+}
+
+QHash<SignalProfilerKey, SignalProfilerCounters> SignalProfilerRecorder::snapshot()
+{
+    Registry *registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+
+    for (auto it = registry->tables.begin(); it != registry->tables.end();) {
+        ThreadTable *table = *it;
+        if (!table->finished.loadAcquire()) {
+            ++it;
+            continue;
+        }
+        mergeTable(registry->retired, table);
+        registry->retiredDropped += table->dropped;
+        delete table;
+        it = registry->tables.erase(it);
+    }
+
+    QHash<SignalProfilerKey, SignalProfilerCounters> result = registry->retired;
+    foreach (const ThreadTable *table, registry->tables)
+        mergeTable(result, table);
+    return result;
+}
+
+quint64 SignalProfilerRecorder::droppedCalls()
+{
+    Registry *registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    quint64 dropped = registry->retiredDropped;
+    foreach (const ThreadTable *table, registry->tables)
+        dropped += table->dropped;
+    return dropped;
+}
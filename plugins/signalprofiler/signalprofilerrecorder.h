@@ -0,0 +1,83 @@
+/*
+  signalprofilerrecorder.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_SIGNALPROFILERRECORDER_H
+#define GAMMARAY_SIGNALPROFILERRECORDER_H
+
+#include <QHash>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+struct QMetaObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Identifies a slot invoked by a signal, or a signal emission as a whole. */
+struct SignalProfilerKey
+{
+    SignalProfilerKey();
+    bool operator==(const SignalProfilerKey &other) const;
+
+    const QMetaObject *senderType; // null if the slot was not invoked by a signal we saw
+    int signalIndex;
+    const QMetaObject *receiverType; // null for the emission as a whole
+    int slotIndex;
+};
+
+uint qHash(const SignalProfilerKey &key);
+
+struct SignalProfilerCounters
+{
+    SignalProfilerCounters();
+    SignalProfilerCounters &operator+=(const SignalProfilerCounters &other);
+
+    quint64 calls;
+    qint64 inclusiveTime; // ns
+    qint64 exclusiveTime; // ns
+    int maxNesting;
+};
+
+/** Records signal and slot execution times from the signal spy callbacks.
+ *  The hot path only touches data of the calling thread and takes no locks, all
+ *  per-thread tables have a fixed size. Calls not fitting in there are counted
+ *  as dropped.
+ */
+namespace SignalProfilerRecorder {
+void signalBegin(QObject *sender, int signalIndex);
+void signalEnd(QObject *sender, int signalIndex);
+void slotBegin(QObject *receiver, int slotIndex);
+void slotEnd(QObject *receiver, int slotIndex);
+
+/** Totals of all threads, can be called from any thread. */
+QHash<SignalProfilerKey, SignalProfilerCounters> snapshot();
+
+/** Number of calls that were not recorded due to full tables. */
+quint64 droppedCalls();
+}
+}
+
+#endif // GAMMARAY_SIGNALPROFILERRECORDER_H
@@ -0,0 +1,78 @@
+/*
+  signalprofilerwidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "signalprofilerwidget.h"
+#include "ui_signalprofilerwidget.h"
+#include "signalprofilerclient.h"
+#include "signalprofilermodel.h"
+
+#include <ui/searchlinecontroller.h>
+
+#include <common/objectbroker.h>
+
+#include <QSortFilterProxyModel>
+
+using namespace GammaRay;
+
+static QObject *signalProfilerClientFactory(const QString &, QObject *parent)
+{
+    return new SignalProfilerClient(parent);
+}
+
+SignalProfilerWidget::SignalProfilerWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::SignalProfilerWidget)
+    , m_stateManager(this)
+    , m_interface(0)
+{
+    ObjectBroker::registerClientObjectFactoryCallback<SignalProfilerInterface *>(
+        signalProfilerClientFactory);
+    m_interface = ObjectBroker::object<SignalProfilerInterface *>();
+
+    ui->setupUi(this);
+
+    auto sortModel = new QSortFilterProxyModel(this);
+    sortModel->setSourceModel(ObjectBroker::model(QStringLiteral(
+                                                      "com.kdab.GammaRay.SignalProfilerModel")));
+    sortModel->setDynamicSortFilter(true);
+    sortModel->setSortRole(Qt::DisplayRole);
+    new SearchLineController(ui->searchLine, sortModel);
+
+    ui->profileView->header()->setObjectName("profileViewHeader");
+    ui->profileView->setDeferredResizeMode(SignalProfilerModel::SenderColumn, QHeaderView::Stretch);
+    ui->profileView->setDeferredResizeMode(SignalProfilerModel::ReceiverColumn, QHeaderView::Stretch);
+    for (int i = SignalProfilerModel::CallsColumn; i < SignalProfilerModel::COLUMN_COUNT; ++i)
+        ui->profileView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    ui->profileView->setModel(sortModel);
+    ui->profileView->sortByColumn(SignalProfilerModel::ExclusiveTimeColumn, Qt::DescendingOrder);
+
+    connect(ui->clearButton, SIGNAL(clicked()), m_interface, SLOT(clear()));
+}
+
+SignalProfilerWidget::~SignalProfilerWidget()
+{
+}
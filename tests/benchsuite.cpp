@@ -28,11 +28,16 @@
 
 #include "benchsuite.h"
 #include "core/probe.h"
+#include "core/toolmanager.h"
 #include "core/util.h"
 
+#include <common/objectbroker.h>
+
 #include <QtTestGui>
 
 #include <QLabel>
+#include <QPushButton>
+#include <QTimer>
 #include <QTreeView>
 
 QTEST_MAIN(GammaRay::BenchSuite)
@@ -77,3 +82,73 @@ void BenchSuite::probe_objectAdded()
     qDeleteAll(objects);
     delete Probe::instance();
 }
+
+void BenchSuite::toolManager_toolsForObject()
+{
+    ToolManager toolManager;
+
+    QWidget widget;
+    QLabel label;
+    QPushButton button;
+    QTreeView treeView;
+    QVector<QObject *> objects;
+    objects << this << &widget << &label << &button << &treeView;
+
+    QBENCHMARK {
+        foreach (QObject *obj, objects)
+            toolManager.toolsForObject(obj);
+    }
+}
+
+void BenchSuite::toolManager_objectAdded()
+{
+    Probe::createProbe(false);
+
+    static const int NUM_OBJECTS = 10000;
+    QVector<QObject *> objects;
+    objects.reserve(NUM_OBJECTS);
+    // mix of types, so the meta object cache sees more than one class hierarchy
+    for (int i = 0; i < NUM_OBJECTS; ++i) {
+        QObject *obj;
+        switch (i % 6) {
+        case 0:
+            obj = new QObject;
+            break;
+        case 1:
+            obj = new QTimer;
+            break;
+        case 2:
+            obj = new QWidget;
+            break;
+        case 3:
+            obj = new QLabel;
+            break;
+        case 4:
+            obj = new QPushButton;
+            break;
+        default:
+            obj = new QTreeView;
+            break;
+        }
+        objects << obj;
+        Probe::objectAdded(obj);
+    }
+
+    // use the probe's tool manager, a second one would initialize all tools a second time
+    ToolManager *toolManager
+        = qobject_cast<ToolManager *>(ObjectBroker::object<ToolManagerInterface *>());
+    QVERIFY(toolManager);
+
+    // warm-up, this is where tools get enabled, what we measure is the steady state
+    // of objects of types we have seen before
+    foreach (QObject *obj, objects)
+        toolManager->objectAdded(obj);
+
+    QBENCHMARK {
+        foreach (QObject *obj, objects)
+            toolManager->objectAdded(obj);
+    }
+
+    qDeleteAll(objects);
+    delete Probe::instance();
+}
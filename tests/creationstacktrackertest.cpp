@@ -0,0 +1,120 @@
+/*
+  creationstacktrackertest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config-gammaray.h>
+
+#include <core/creationstacktracker.h>
+
+#include <QObject>
+#include <QTimer>
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+class CreationStackTrackerTest : public QObject
+{
+    Q_OBJECT
+private:
+    static void create(CreationStackTracker *tracker, QObject *obj)
+    {
+        tracker->objectCreated(obj);
+        tracker->objectConstructed(obj);
+    }
+
+private slots:
+    void testDisabled()
+    {
+        CreationStackTracker tracker;
+        QVERIFY(!tracker.isEnabled());
+        QObject obj;
+        create(&tracker, &obj);
+        QCOMPARE(tracker.stackCount(), 0);
+        QVERIFY(!tracker.creationLocation(&obj).isValid());
+    }
+
+    void testStackTable()
+    {
+#ifndef HAVE_BACKTRACE
+        QSKIP("no backtrace support");
+#endif
+        CreationStackTracker tracker;
+        tracker.setSampleInterval(1);
+        QVERIFY(tracker.isEnabled());
+
+        QObject objs[4];
+        for (int i = 0; i < 4; ++i)
+            create(&tracker, &objs[i]);
+        QCOMPARE(tracker.stackCount(), 1);
+
+        QObject other;
+        create(&tracker, &other);
+        QCOMPARE(tracker.stackCount(), 2);
+
+        // stacks are kept for later objects created at the same place
+        for (int i = 0; i < 4; ++i)
+            tracker.objectRemoved(&objs[i]);
+        QCOMPARE(tracker.stackCount(), 2);
+    }
+
+    void testLocation()
+    {
+#ifndef HAVE_BACKTRACE
+        QSKIP("no backtrace support");
+#endif
+        CreationStackTracker tracker;
+        tracker.setClassFilter(QStringList() << QStringLiteral("QTimer"));
+        QVERIFY(!tracker.isEnabled());
+        tracker.setSampleInterval(1);
+        QVERIFY(tracker.isEnabled());
+
+        QObject obj;
+        QTimer timer;
+        create(&tracker, &obj);
+        create(&tracker, &timer);
+        // the stack of the filtered out object isn't stored
+        QCOMPARE(tracker.stackCount(), 1);
+
+        // resolved asynchronously
+        SourceLocation loc;
+        for (int i = 0; i < 100 && !loc.isValid(); ++i) {
+            QTest::qWait(100);
+            loc = tracker.creationLocation(&timer);
+        }
+        QVERIFY(!tracker.creationLocation(&obj).isValid());
+        if (!loc.isValid())
+            QSKIP("addr2line or debug information not available");
+        QVERIFY(loc.url().toLocalFile().endsWith(QLatin1String("creationstacktrackertest.cpp")));
+        QVERIFY(loc.line() > 0);
+
+        tracker.objectRemoved(&timer);
+        QVERIFY(!tracker.creationLocation(&timer).isValid());
+    }
+};
+
+QTEST_MAIN(CreationStackTrackerTest)
+
+#include "creationstacktrackertest.moc"
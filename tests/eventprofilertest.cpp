@@ -0,0 +1,186 @@
+/*
+  eventprofilertest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <plugins/eventprofiler/eventprofilerrecorder.h>
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QObject>
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+static const QEvent::Type OuterEvent = static_cast<QEvent::Type>(QEvent::User + 1);
+static const QEvent::Type InnerEvent = static_cast<QEvent::Type>(QEvent::User + 2);
+
+class EventProfilerTestReceiver : public QObject
+{
+public:
+    EventProfilerTestReceiver()
+        : handled(0) {}
+
+    bool event(QEvent *event) Q_DECL_OVERRIDE
+    {
+        if (event->type() == OuterEvent) {
+            QEvent inner(InnerEvent);
+            QCoreApplication::sendEvent(this, &inner);
+            ++handled;
+            return true;
+        }
+        if (event->type() == InnerEvent) {
+            QTest::qSleep(5);
+            ++handled;
+            return true;
+        }
+        return QObject::event(event);
+    }
+
+    int handled;
+};
+
+// takes over delivery the same way the event profiler does
+static bool deliveringCallback(void **cbdata)
+{
+    QObject *receiver = reinterpret_cast<QObject *>(cbdata[0]);
+    QEvent *event = reinterpret_cast<QEvent *>(cbdata[1]);
+    bool *result = reinterpret_cast<bool *>(cbdata[2]);
+    *result = QCoreApplication::instance()->notify(receiver, event);
+    return true;
+}
+
+class EventProfilerTest : public QObject
+{
+    Q_OBJECT
+private:
+    static EventProfilerKey key(QEvent::Type type, QObject *receiver)
+    {
+        EventProfilerKey k;
+        k.eventType = type;
+        k.receiverType = receiver->metaObject();
+        return k;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(EventProfilerRecorder::install());
+    }
+
+    void cleanupTestCase()
+    {
+        EventProfilerRecorder::uninstall();
+    }
+
+    void testNesting()
+    {
+        EventProfilerRecorder::clear();
+        EventProfilerTestReceiver receiver;
+        QEvent outer(OuterEvent);
+        QVERIFY(QCoreApplication::sendEvent(&receiver, &outer));
+        QCOMPARE(receiver.handled, 2);
+
+        const auto stats = EventProfilerRecorder::snapshot();
+        const auto outerStats = stats.value(key(OuterEvent, &receiver));
+        const auto innerStats = stats.value(key(InnerEvent, &receiver));
+        QCOMPARE(outerStats.count, quint64(1));
+        QCOMPARE(innerStats.count, quint64(1));
+        QVERIFY(innerStats.totalTime >= 5000000);
+        QVERIFY(outerStats.totalTime >= innerStats.totalTime);
+        QVERIFY(outerStats.exclusiveTime < innerStats.totalTime);
+        QCOMPARE(innerStats.exclusiveTime, innerStats.totalTime);
+    }
+
+    void testPercentiles()
+    {
+        EventProfilerStats stats;
+        for (int i = 0; i < 98; ++i)
+            stats.record(1000, 1000);
+        stats.record(100000, 100000);
+        stats.record(1000000, 1000000);
+
+        QCOMPARE(stats.count, quint64(100));
+        QCOMPARE(stats.maxTime, qint64(1000000));
+        QVERIFY(stats.percentile(0.5) >= 1000);
+        QVERIFY(stats.percentile(0.5) < 2000);
+        QVERIFY(stats.percentile(0.99) >= 100000);
+        QVERIFY(stats.percentile(0.99) < 200000);
+        QCOMPARE(stats.percentile(1.0), qint64(1000000));
+        QCOMPARE(EventProfilerStats().percentile(0.5), qint64(0));
+    }
+
+    void testClear()
+    {
+        EventProfilerTestReceiver receiver;
+        QEvent inner(InnerEvent);
+        QCoreApplication::sendEvent(&receiver, &inner);
+        QVERIFY(EventProfilerRecorder::snapshot().value(key(InnerEvent, &receiver)).count > 0);
+
+        EventProfilerRecorder::clear();
+        QCOMPARE(EventProfilerRecorder::snapshot().value(key(InnerEvent, &receiver)).count,
+                 quint64(0));
+        QCoreApplication::sendEvent(&receiver, &inner);
+        QCOMPARE(EventProfilerRecorder::snapshot().value(key(InnerEvent, &receiver)).count,
+                 quint64(1));
+    }
+
+    void testQueueDepth()
+    {
+        EventProfilerTestReceiver receiver;
+        for (int i = 0; i < 5; ++i)
+            QCoreApplication::postEvent(&receiver, new QEvent(InnerEvent));
+
+        int pending = -1;
+        foreach (const EventQueueDepth &depth, EventProfilerRecorder::queueDepths()) {
+            if (depth.threadName == QLatin1String("Main Thread"))
+                pending = depth.pending;
+        }
+        QVERIFY(pending >= 5);
+
+        QCoreApplication::sendPostedEvents(&receiver, InnerEvent);
+        QCOMPARE(receiver.handled, 5);
+    }
+
+    void testConflictingCallback()
+    {
+        EventProfilerRecorder::uninstall();
+        QInternal::registerCallback(QInternal::EventNotifyCallback, deliveringCallback);
+        QVERIFY(!EventProfilerRecorder::install());
+
+        // events are delivered exactly once
+        EventProfilerTestReceiver receiver;
+        QEvent inner(InnerEvent);
+        QCoreApplication::sendEvent(&receiver, &inner);
+        QCOMPARE(receiver.handled, 1);
+
+        QInternal::unregisterCallback(QInternal::EventNotifyCallback, deliveringCallback);
+        QVERIFY(EventProfilerRecorder::install());
+    }
+};
+
+QTEST_MAIN(EventProfilerTest)
+
+#include "eventprofilertest.moc"
@@ -33,15 +33,22 @@
 #include <probe/probecreator.h>
 #include <core/probe.h>
 #include <common/objectbroker.h>
+#include <common/tools/metaobjectbrowser/qmetaobjectmodel.h>
 
 #include <3rdparty/qt/modeltest.h>
 
 #include <QDebug>
+#include <QVector>
 #include <QtTest/qtest.h>
 #include <QObject>
 
 using namespace GammaRay;
 
+class MetaObjectTreeModelChurnObject : public QObject
+{
+    Q_OBJECT
+};
+
 class MetaObjectTreeModelTest : public QObject
 {
     Q_OBJECT
@@ -56,6 +63,12 @@ private:
         QTest::qWait(1); // event loop re-entry
     }
 
+    static QPersistentModelIndex findClass(QAbstractItemModel *model, const QString &className)
+    {
+        const auto l = model->match(model->index(0, 0), Qt::DisplayRole, className, 1, Qt::MatchRecursive | Qt::MatchExactly);
+        return l.isEmpty() ? QPersistentModelIndex() : QPersistentModelIndex(l.at(0));
+    }
+
 private slots:
     void modelTest()
     {
@@ -91,12 +104,12 @@ private slots:
         QVERIFY(!idx.data(Qt::ToolTipRole).toString().isEmpty());
 
         idx = idx.sibling(idx.row(), 1);
-        QCOMPARE(idx.data().toInt(), 1);
+        QTRY_COMPARE(idx.data().toInt(), 1); // counter updates are compressed
         QVERIFY(!idx.data(Qt::BackgroundRole).isNull());
         QVERIFY(!idx.data(Qt::ToolTipRole).toString().isEmpty());
 
         idx = idx.sibling(idx.row(), 2);
-        QCOMPARE(idx.data().toInt(), 1);
+        QTRY_COMPARE(idx.data().toInt(), 1);
         QVERIFY(!idx.data(Qt::BackgroundRole).isNull());
         QVERIFY(!idx.data(Qt::ToolTipRole).toString().isEmpty());
 
@@ -116,6 +129,29 @@ private slots:
 
         QVERIFY(!idx.parent().isValid());
     }
+
+    void testRates()
+    {
+        createProbe();
+
+        auto srcModel = ObjectBroker::model("com.kdab.GammaRay.MetaObjectBrowserTreeModel");
+        QVERIFY(srcModel);
+
+        QVector<QObject *> objects;
+        for (int i = 0; i < 10; ++i)
+            objects.push_back(new MetaObjectTreeModelChurnObject);
+
+        // counters are updated compressed, rates once per rate window
+        QPersistentModelIndex idx;
+        QTRY_VERIFY((idx = findClass(srcModel, QStringLiteral("MetaObjectTreeModelChurnObject"))).isValid());
+        QTRY_COMPARE(idx.sibling(idx.row(), QMetaObjectModel::ObjectSelfCountColumn).data().toInt(), 10);
+        QTRY_COMPARE(idx.sibling(idx.row(), QMetaObjectModel::ObjectSelfAliveCountColumn).data().toInt(), 10);
+        QTRY_VERIFY(idx.sibling(idx.row(), QMetaObjectModel::ObjectInclusiveCreationRateColumn).data().toDouble() > 0.0);
+
+        qDeleteAll(objects);
+        QTRY_COMPARE(idx.sibling(idx.row(), QMetaObjectModel::ObjectSelfAliveCountColumn).data().toInt(), 0);
+        QTRY_VERIFY(idx.sibling(idx.row(), QMetaObjectModel::ObjectInclusiveDestructionRateColumn).data().toDouble() > 0.0);
+    }
 };
 
 QTEST_MAIN(MetaObjectTreeModelTest)
@@ -0,0 +1,99 @@
+/*
+  modelcallprofilertest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <plugins/modelinspector/modelcallprofiler.h>
+
+#include <QStandardItemModel>
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+class ModelCallProfilerTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        if (!ModelCallProfiler::isSupported())
+            QSKIP("model call profiling is not supported on this platform");
+    }
+
+    void testRecording()
+    {
+        QStandardItemModel model(2, 1);
+        model.setItem(0, 0, new QStandardItem(QStringLiteral("a")));
+        model.setItem(1, 0, new QStandardItem(QStringLiteral("b")));
+
+        ModelCallProfiler profiler;
+        QVERIFY(!profiler.isProfiling(&model));
+        QVERIFY(profiler.setProfiling(&model, true));
+        QVERIFY(profiler.isProfiling(&model));
+
+        QAbstractItemModel *m = &model;
+        QCOMPARE(m->rowCount(), 2);
+        QCOMPARE(m->data(m->index(1, 0)).toString(), QStringLiteral("b"));
+        QVERIFY(!m->data(m->index(1, 0), Qt::DecorationRole).isValid());
+
+        ModelCallStats stats = profiler.stats(&model);
+        QCOMPARE(stats.methods[ModelCallStats::RowCountMethod].count, quint64(1));
+        QCOMPARE(stats.methods[ModelCallStats::DataMethod].count, quint64(2));
+        QCOMPARE(stats.methods[ModelCallStats::IndexMethod].count, quint64(2));
+        QCOMPARE(stats.dataRoles.size(), 2);
+        QCOMPARE(stats.dataRoles.value(Qt::DisplayRole).count, quint64(1));
+        QCOMPARE(stats.dataRoles.value(Qt::DecorationRole).count, quint64(1));
+
+        // other instances of the same class are not recorded
+        QStandardItemModel other(1, 1);
+        other.rowCount();
+        QCOMPARE(profiler.stats(&model).methods[ModelCallStats::RowCountMethod].count, quint64(1));
+
+        profiler.clear(&model);
+        QCOMPARE(profiler.stats(&model).methods[ModelCallStats::DataMethod].count, quint64(0));
+
+        QVERIFY(profiler.setProfiling(&model, false));
+        QVERIFY(!profiler.isProfiling(&model));
+        QCOMPARE(m->rowCount(), 2);
+        QCOMPARE(profiler.stats(&model).methods[ModelCallStats::RowCountMethod].count, quint64(0));
+    }
+
+    void testModelDestroyed()
+    {
+        ModelCallProfiler profiler;
+        QAbstractItemModel *model = new QStandardItemModel(1, 1);
+        QVERIFY(profiler.setProfiling(model, true));
+        delete model;
+        QVERIFY(!profiler.isProfiling(model));
+
+        // vtable is restored, new instances run unprofiled
+        QStandardItemModel other(1, 1);
+        QCOMPARE(other.rowCount(), 1);
+    }
+};
+
+QTEST_MAIN(ModelCallProfilerTest)
+
+#include "modelcallprofilertest.moc"
@@ -0,0 +1,152 @@
+/*
+  modelcheckertest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <plugins/modelinspector/modelchecker.h>
+
+#include <QSignalSpy>
+#include <QStandardItemModel>
+#include <QStringList>
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+class BrokenListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit BrokenListModel(QObject *parent = 0)
+        : QAbstractListModel(parent)
+    {
+        m_data << QStringLiteral("a") << QStringLiteral("b");
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return parent.isValid() ? 0 : m_data.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE
+    {
+        if (role == Qt::DisplayRole)
+            return m_data.at(index.row());
+        if (role == Qt::CheckStateRole)
+            return 42;
+        return QVariant();
+    }
+
+    // announces two rows, but only inserts one
+    void insertWrongCount()
+    {
+        beginInsertRows(QModelIndex(), 0, 1);
+        m_data.prepend(QStringLiteral("c"));
+        endInsertRows();
+    }
+
+    void changeInvalidRange()
+    {
+        emit dataChanged(index(1), index(0));
+    }
+
+private:
+    QStringList m_data;
+};
+
+class ModelCheckerTest : public QObject
+{
+    Q_OBJECT
+private:
+    static void processAll(ModelChecker *checker)
+    {
+        // every call validates at least one row, and samples if nothing is queued
+        for (int i = 0; i < 100; ++i)
+            checker->process(1000000000);
+    }
+
+private slots:
+    void testValidModel()
+    {
+        QStandardItemModel model;
+        ModelChecker checker(&model);
+        QSignalSpy failureSpy(&checker, SIGNAL(failed(QString)));
+
+        for (int i = 0; i < 10; ++i) {
+            auto item = new QStandardItem(QString::number(i));
+            item->appendRow(new QStandardItem(QStringLiteral("child")));
+            model.appendRow(item);
+        }
+        model.insertColumn(1);
+        model.setData(model.index(3, 0), QStringLiteral("changed"));
+        model.item(2)->setCheckState(Qt::Checked);
+        model.removeRows(4, 3);
+        model.item(0)->removeRow(0);
+        model.sort(0, Qt::DescendingOrder);
+        processAll(&checker);
+
+        QCOMPARE(failureSpy.count(), 0);
+        QCOMPARE(checker.failureCount(), 0);
+    }
+
+    void testWrongCount()
+    {
+        BrokenListModel model;
+        ModelChecker checker(&model);
+        QSignalSpy failureSpy(&checker, SIGNAL(failed(QString)));
+
+        model.insertWrongCount();
+        QCOMPARE(failureSpy.count(), 1);
+
+        // the same failure is only reported once
+        model.insertWrongCount();
+        QCOMPARE(failureSpy.count(), 1);
+    }
+
+    void testInvalidDataChanged()
+    {
+        BrokenListModel model;
+        ModelChecker checker(&model);
+        QSignalSpy failureSpy(&checker, SIGNAL(failed(QString)));
+
+        model.changeInvalidRange();
+        QCOMPARE(failureSpy.count(), 1);
+    }
+
+    void testSampledData()
+    {
+        BrokenListModel model;
+        ModelChecker checker(&model);
+        QSignalSpy failureSpy(&checker, SIGNAL(failed(QString)));
+
+        // nothing changed, the invalid check state is found by sampling
+        processAll(&checker);
+        QCOMPARE(failureSpy.count(), 1);
+        QVERIFY(failureSpy.at(0).at(0).toString().contains(QStringLiteral("Qt::Checked")));
+    }
+};
+
+QTEST_MAIN(ModelCheckerTest)
+
+#include "modelcheckertest.moc"
@@ -48,6 +48,27 @@ signals:
 
 Q_DECLARE_METATYPE(QVector<QVariant>)
 
+class RecordingReceiver : public MultiSignalMapper::Receiver
+{
+public:
+    void signalEmitted(QObject *sender, int signalIndex, const QVector<int> &argumentTypes,
+                       void **args) Q_DECL_OVERRIDE
+    {
+        senders.push_back(sender);
+        signalIndexes.push_back(signalIndex);
+        types = argumentTypes;
+        QVariantList v;
+        for (int i = 0; i < argumentTypes.size(); ++i)
+            v.push_back(QVariant(argumentTypes.at(i), args[i + 1]));
+        arguments.push_back(v);
+    }
+
+    QVector<QObject *> senders;
+    QVector<int> signalIndexes;
+    QVector<int> types;
+    QVector<QVariantList> arguments;
+};
+
 class MultiSignalMapperTest : public QObject
 {
     Q_OBJECT
@@ -92,6 +113,33 @@ private slots:
         QCOMPARE(spy.at(1).at(2).value<QVector<QVariant> >().first().toString(),
                  QStringLiteral("hello"));
     }
+
+    void testReceiver()
+    {
+        Emitter emitter;
+        RecordingReceiver receiver;
+
+        MultiSignalMapper mapper;
+        mapper.setReceiver(&receiver);
+        mapper.connectToSignal(&emitter, method(&emitter, "signal1(int)"));
+        mapper.connectToSignal(&emitter, method(&emitter, "signal2(QString)"));
+
+        QSignalSpy spy(&mapper, SIGNAL(signalEmitted(QObject*,int,QVector<QVariant>)));
+        QVERIFY(spy.isValid());
+
+        emitter.signal1(42);
+        emitter.signal2(QStringLiteral("hello"));
+        QVERIFY(spy.isEmpty());
+
+        QCOMPARE(receiver.senders.size(), 2);
+        QCOMPARE(receiver.senders.at(0), static_cast<QObject *>(&emitter));
+        QCOMPARE(receiver.signalIndexes.at(0), emitter.metaObject()->indexOfSignal("signal1(int)"));
+        QCOMPARE(receiver.arguments.at(0).first().toInt(), 42);
+        QCOMPARE(receiver.signalIndexes.at(1),
+                 emitter.metaObject()->indexOfSignal("signal2(QString)"));
+        QCOMPARE(receiver.types, QVector<int>() << QMetaType::QString);
+        QCOMPARE(receiver.arguments.at(1).first().toString(), QStringLiteral("hello"));
+    }
 };
 
 QTEST_MAIN(MultiSignalMapperTest)
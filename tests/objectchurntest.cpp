@@ -0,0 +1,135 @@
+/*
+  objectchurntest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config-gammaray.h>
+
+#include <plugins/objectchurn/objectchurnrecorder.h>
+
+#include <QObject>
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+class ObjectChurnTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testShortLived()
+    {
+        ObjectChurnRecorder recorder;
+        {
+            QObject obj;
+            recorder.objectCreated(&obj);
+            recorder.objectConstructed(&obj);
+            recorder.objectDestroyed(&obj);
+        }
+
+        const auto stats = recorder.stats();
+        QCOMPARE(stats.size(), 1);
+        const ObjectChurnStats s = stats.value(&QObject::staticMetaObject);
+        QCOMPARE(s.created, quint64(1));
+        QCOMPARE(s.destroyed, quint64(1));
+        QCOMPARE(s.shortLived, quint64(1));
+        QVERIFY(s.lifetimePercentile(0.5) < ObjectChurnRecorder::ShortLivedThreshold);
+    }
+
+    void testLongLived()
+    {
+        ObjectChurnRecorder recorder;
+        QObject obj;
+        recorder.objectCreated(&obj);
+        recorder.objectConstructed(&obj);
+        QCOMPARE(recorder.stats().value(&QObject::staticMetaObject).destroyed, quint64(0));
+
+        QTest::qSleep(150);
+        recorder.objectDestroyed(&obj);
+
+        const ObjectChurnStats s = recorder.stats().value(&QObject::staticMetaObject);
+        QCOMPARE(s.destroyed, quint64(1));
+        QCOMPARE(s.shortLived, quint64(0));
+        QVERIFY(s.lifetimePercentile(0.5) >= 150000);
+    }
+
+    void testDestroyedBeforeConstruction()
+    {
+        ObjectChurnRecorder recorder;
+        QObject obj;
+        recorder.objectCreated(&obj);
+        recorder.objectDestroyed(&obj);
+        recorder.objectConstructed(&obj); // too late, must be ignored
+
+        QVERIFY(recorder.stats().isEmpty());
+    }
+
+    void testRates()
+    {
+        ObjectChurnStats s;
+        for (int i = 0; i < 3; ++i)
+            s.addCreation(5);
+        s.addCreation(6);
+        s.addDestruction(6, 10);
+
+        QCOMPARE(s.creationRate(6, 1), 3.0);
+        QCOMPARE(s.creationRate(7, 1), 1.0);
+        QCOMPARE(s.creationRate(7, 10), 0.4);
+        QCOMPARE(s.destructionRate(7, 1), 1.0);
+        QCOMPARE(s.creationRate(8, 1), 0.0);
+
+        // a minute later the history slot of second 5 is reused
+        s.addCreation(65);
+        QCOMPARE(s.creationRate(66, 1), 1.0);
+        QCOMPARE(s.creationRate(66, 60), 2.0 / 60);
+        QCOMPARE(s.created, quint64(5));
+    }
+
+    void testCreationSites()
+    {
+        ObjectChurnRecorder recorder;
+        recorder.setBacktraceSampleInterval(1);
+        for (int i = 0; i < 2; ++i) {
+            QObject obj;
+            recorder.objectCreated(&obj);
+            recorder.objectConstructed(&obj);
+            recorder.objectDestroyed(&obj);
+        }
+
+        const auto sites = recorder.creationSites(&QObject::staticMetaObject);
+#ifdef HAVE_BACKTRACE
+        QCOMPARE(sites.size(), 1);
+        QCOMPARE(sites.constBegin().value(), quint64(2));
+        QVERIFY(!recorder.creationSite(sites.constBegin().key()).isEmpty());
+#endif
+
+        recorder.clear();
+        QVERIFY(recorder.creationSites(&QObject::staticMetaObject).isEmpty());
+        QVERIFY(recorder.stats().isEmpty());
+    }
+};
+
+QTEST_MAIN(ObjectChurnTest)
+
+#include "objectchurntest.moc"
@@ -0,0 +1,123 @@
+/*
+  objectmodeltest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <probe/hooks.h>
+#include <probe/probecreator.h>
+#include <core/probe.h>
+#include <common/objectbroker.h>
+#include <common/objectmodel.h>
+
+#include <3rdparty/qt/modeltest.h>
+
+#include <QtTest/qtest.h>
+#include <QSignalSpy>
+#include <QObject>
+
+using namespace GammaRay;
+
+class ObjectModelTest : public QObject
+{
+    Q_OBJECT
+private:
+    void createProbe()
+    {
+        Hooks::installHooks();
+        Probe::startupHookReceived();
+        new ProbeCreator(ProbeCreator::Create);
+        QTest::qWait(1); // event loop re-entry
+    }
+
+    static void createObjectTree(QObject *root)
+    {
+        for (int i = 0; i < 50; ++i) {
+            auto child = new QObject(root);
+            new QObject(child);
+        }
+    }
+
+private slots:
+    void testListModel()
+    {
+        createProbe();
+
+        auto model = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ObjectList"));
+        QVERIFY(model);
+        ModelTest modelTest(model);
+        const auto prevRowCount = model->rowCount();
+
+        QScopedPointer<QObject> root(new QObject);
+        createObjectTree(root.data());
+        QTest::qWait(1); // queued object changes
+
+        QVERIFY(model->rowCount() >= prevRowCount + 101);
+        const auto l = model->match(model->index(0, 0), ObjectModel::ObjectRole,
+                                    QVariant::fromValue<QObject *>(root.data()), 1, Qt::MatchExactly);
+        QCOMPARE(l.size(), 1);
+
+        root.reset();
+        QCOMPARE(model->rowCount(), prevRowCount);
+    }
+
+    void testTreeModel()
+    {
+        createProbe();
+
+        auto model = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ObjectTree"));
+        QVERIFY(model);
+        ModelTest modelTest(model);
+        QSignalSpy insertSpy(model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+        QVERIFY(insertSpy.isValid());
+
+        QScopedPointer<QObject> root(new QObject);
+        createObjectTree(root.data());
+        QTest::qWait(1); // queued object changes
+
+        const auto l = model->match(model->index(0, 0), ObjectModel::ObjectRole,
+                                    QVariant::fromValue<QObject *>(root.data()), 1,
+                                    Qt::MatchExactly | Qt::MatchRecursive);
+        QCOMPARE(l.size(), 1);
+        const auto rootIdx = l.at(0);
+        QCOMPARE(model->rowCount(rootIdx), 50);
+        for (int i = 0; i < 50; ++i)
+            QCOMPARE(model->rowCount(model->index(i, 0, rootIdx)), 1);
+
+        // all children of root are announced in one go
+        int rootInserts = 0;
+        foreach (const auto &args, insertSpy) {
+            if (args.at(0).value<QModelIndex>() != rootIdx)
+                continue;
+            ++rootInserts;
+            QCOMPARE(args.at(1).toInt(), 0);
+            QCOMPARE(args.at(2).toInt(), 49);
+        }
+        QCOMPARE(rootInserts, 1);
+    }
+};
+
+QTEST_MAIN(ObjectModelTest)
+
+#include "objectmodeltest.moc"
@@ -0,0 +1,229 @@
+/*
+  pluginindextest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <common/pluginindex.h>
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest/qtest.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/time.h>
+#endif
+
+using namespace GammaRay;
+
+class PluginIndexTest : public QObject
+{
+    Q_OBJECT
+private:
+    static QString indexDir()
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+               + QLatin1String("/gammaray");
+    }
+
+    static QString indexFile()
+    {
+        const QStringList files = QDir(indexDir()).entryList(QStringList(QStringLiteral("plugin-index-*")), QDir::Files);
+        return files.size() == 1 ? QDir(indexDir()).absoluteFilePath(files.at(0)) : QString();
+    }
+
+    static void writePlugin(const QString &path, const QString &id, const QString &name)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+        file.write("[Desktop Entry]\n");
+        file.write("Name=" + name.toUtf8() + '\n');
+        file.write("X-GammaRay-Id=" + id.toUtf8() + '\n');
+        file.write("X-GammaRay-ServiceTypes=com.kdab.GammaRay.ToolFactory/1.0\n");
+    }
+
+    static bool setModificationTime(const QString &path, qint64 msecs)
+    {
+#ifdef Q_OS_UNIX
+        struct timeval times[2];
+        times[0].tv_sec = times[1].tv_sec = msecs / 1000;
+        times[0].tv_usec = times[1].tv_usec = (msecs % 1000) * 1000;
+        return utimes(QFile::encodeName(path).constData(), times) == 0;
+#else
+        Q_UNUSED(path);
+        Q_UNUSED(msecs);
+        return false;
+#endif
+    }
+
+    static qint64 modificationTime(const QString &path)
+    {
+        return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    }
+
+    static QVector<PluginInfo> pluginInfos(const QTemporaryDir &dir)
+    {
+        return PluginIndex::pluginInfos(QDir(dir.path()), QStringList(QStringLiteral("*.desktop")));
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void init()
+    {
+        QDir(indexDir()).removeRecursively();
+        PluginIndex::clearCache();
+    }
+
+    void cleanupTestCase()
+    {
+        QDir(indexDir()).removeRecursively();
+    }
+
+    void testCacheHit()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.path() + QLatin1String("/a.desktop");
+        writePlugin(path, QStringLiteral("a"), QStringLiteral("Foo"));
+        auto infos = pluginInfos(dir);
+        QCOMPARE(infos.size(), 1);
+        QCOMPARE(infos.at(0).name(), QStringLiteral("Foo"));
+        QVERIFY(!indexFile().isEmpty());
+
+        // same size and modification time, so this has to come from the index on disk
+        const qint64 mtime = modificationTime(path);
+        writePlugin(path, QStringLiteral("a"), QStringLiteral("Bar"));
+        if (!setModificationTime(path, mtime))
+            QSKIP("Cannot set file modification times on this platform");
+        PluginIndex::clearCache();
+        infos = pluginInfos(dir);
+        QCOMPARE(infos.size(), 1);
+        QCOMPARE(infos.at(0).id(), QStringLiteral("a"));
+        QCOMPARE(infos.at(0).name(), QStringLiteral("Foo"));
+    }
+
+    void testChangedPlugin()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.path() + QLatin1String("/a.desktop");
+        writePlugin(path, QStringLiteral("a"), QStringLiteral("Foo"));
+        QCOMPARE(pluginInfos(dir).at(0).name(), QStringLiteral("Foo"));
+
+        // different size
+        writePlugin(path, QStringLiteral("a"), QStringLiteral("Foobar"));
+        QCOMPARE(pluginInfos(dir).at(0).name(), QStringLiteral("Foobar"));
+        PluginIndex::clearCache();
+        QCOMPARE(pluginInfos(dir).at(0).name(), QStringLiteral("Foobar"));
+
+        // same size, different modification time
+        const qint64 mtime = modificationTime(path);
+        writePlugin(path, QStringLiteral("a"), QStringLiteral("Barbaz"));
+        if (!setModificationTime(path, mtime + 2000))
+            QSKIP("Cannot set file modification times on this platform");
+        QCOMPARE(pluginInfos(dir).at(0).name(), QStringLiteral("Barbaz"));
+        PluginIndex::clearCache();
+        QCOMPARE(pluginInfos(dir).at(0).name(), QStringLiteral("Barbaz"));
+    }
+
+    void testRemovedPlugin()
+    {
+        QTemporaryDir dir;
+        writePlugin(dir.path() + QLatin1String("/a.desktop"), QStringLiteral("a"), QStringLiteral("Foo"));
+        writePlugin(dir.path() + QLatin1String("/b.desktop"), QStringLiteral("b"), QStringLiteral("Bar"));
+        QCOMPARE(pluginInfos(dir).size(), 2);
+
+        QVERIFY(QFile::remove(dir.path() + QLatin1String("/b.desktop")));
+        auto infos = pluginInfos(dir);
+        QCOMPARE(infos.size(), 1);
+        QCOMPARE(infos.at(0).id(), QStringLiteral("a"));
+
+        PluginIndex::clearCache();
+        infos = pluginInfos(dir);
+        QCOMPARE(infos.size(), 1);
+        QCOMPARE(infos.at(0).id(), QStringLiteral("a"));
+    }
+
+    void testCorruptIndex_data()
+    {
+        QTest::addColumn<QString>("corruption");
+        QTest::newRow("empty") << QStringLiteral("empty");
+        QTest::newRow("truncated") << QStringLiteral("truncated");
+        QTest::newRow("garbage") << QStringLiteral("garbage");
+        QTest::newRow("huge count") << QStringLiteral("count");
+    }
+
+    void testCorruptIndex()
+    {
+        QFETCH(QString, corruption);
+
+        QTemporaryDir dir;
+        writePlugin(dir.path() + QLatin1String("/a.desktop"), QStringLiteral("a"), QStringLiteral("Foo"));
+        QCOMPARE(pluginInfos(dir).size(), 1);
+        const QString path = indexFile();
+        QVERIFY(!path.isEmpty());
+        const qint64 indexSize = QFileInfo(path).size();
+
+        QFile file(path);
+        QVERIFY(file.open(QFile::ReadWrite));
+        if (corruption == QLatin1String("empty")) {
+            file.resize(0);
+        } else if (corruption == QLatin1String("truncated")) {
+            file.resize(indexSize / 2);
+        } else if (corruption == QLatin1String("garbage")) {
+            file.resize(0);
+            file.write(QByteArray(int(indexSize), 'x'));
+        } else {
+            // skip magic, version and locale, the entry count follows
+            QDataStream stream(&file);
+            stream.setVersion(QDataStream::Qt_4_8);
+            quint32 magic;
+            qint32 version;
+            QString locale;
+            stream >> magic >> version >> locale;
+            stream << quint32(0xffffffff);
+        }
+        file.close();
+
+        PluginIndex::clearCache();
+        const auto infos = pluginInfos(dir);
+        QCOMPARE(infos.size(), 1);
+        QCOMPARE(infos.at(0).name(), QStringLiteral("Foo"));
+
+        // the index got rewritten
+        QCOMPARE(QFileInfo(path).size(), indexSize);
+    }
+};
+
+QTEST_MAIN(PluginIndexTest)
+
+#include "pluginindextest.moc"
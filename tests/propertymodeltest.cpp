@@ -131,6 +131,37 @@ private slots:
         QCOMPARE(removeSpy.size(), 1);
     }
 
+    void testCoalescedChangeNotification()
+    {
+        ChangingPropertyObject obj;
+        AggregatedPropertyModel model;
+        model.setMaximumUpdateRate(50);
+        model.setObject(&obj);
+        auto idx = findRowByName(&model, "staticChangingProperty");
+        QVERIFY(idx.isValid());
+        idx = idx.sibling(idx.row(), 1);
+
+        QSignalSpy changeSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+        QVERIFY(changeSpy.isValid());
+
+        // the first change is delivered right away, the following ones are coalesced
+        for (int i = 0; i < 5; ++i)
+            obj.changeProperties();
+        const int immediateChanges = changeSpy.size();
+        QVERIFY(immediateChanges >= 1);
+        QVERIFY(immediateChanges <= 2);
+
+        QTRY_VERIFY(changeSpy.size() > immediateChanges);
+        QVERIFY(changeSpy.size() <= immediateChanges + 2);
+        QCOMPARE(idx.data().toString(), QStringLiteral("5"));
+
+        // disabling the rate limit delivers changes immediately again
+        model.setMaximumUpdateRate(0);
+        changeSpy.clear();
+        obj.changeProperties();
+        QCOMPARE(changeSpy.size(), 2);
+    }
+
     void testGadgetRO()
     {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 5, 0)
@@ -59,6 +59,42 @@ private:
     int p1;
 };
 
+class MyDerivedObject : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int otherProp READ otherProp WRITE setOtherProp NOTIFY otherPropChanged)
+    Q_PROPERTY(int intProp READ intProp WRITE setIntProp NOTIFY intPropChanged)
+public:
+    explicit MyDerivedObject(QObject *parent = 0)
+        : QObject(parent)
+        , p1(0)
+        , p2(0) {}
+    int intProp() { return p1; }
+    void setIntProp(int i)
+    {
+        if (p1 == i)
+            return;
+        p1 = i;
+        emit intPropChanged();
+    }
+    int otherProp() { return p2; }
+    void setOtherProp(int i)
+    {
+        if (p2 == i)
+            return;
+        p2 = i;
+        emit otherPropChanged();
+    }
+
+signals:
+    void intPropChanged();
+    void otherPropChanged();
+
+private:
+    int p1;
+    int p2;
+};
+
 class PropertySyncerTest : public QObject
 {
     Q_OBJECT
@@ -131,24 +167,97 @@ private slots:
         QCOMPARE(m_server2ClientCount, 1);
         QCOMPARE(clientObj->intProp(), 14);
 
-        // regular sync on changes on one side
+        // regular sync on changes on one side, batched per event loop pass
+        serverObj.setIntProp(41);
         serverObj.setIntProp(42);
-        QCOMPARE(m_server2ClientCount, 2);
+        QCOMPARE(m_server2ClientCount, 1);
+        QTRY_COMPARE(m_server2ClientCount, 2);
         QCOMPARE(clientObj->intProp(), 42);
 
         QCOMPARE(m_client2ServerCount, 1);
         clientObj->setIntProp(23);
-        QCOMPARE(serverObj.intProp(), 23);
+        QTRY_COMPARE(serverObj.intProp(), 23);
         QCOMPARE(m_client2ServerCount, 2);
+        QTest::qWait(10);
         QCOMPARE(m_server2ClientCount, 2);
 
         // client destroyed
         m_server->setObjectEnabled(42, false);
         delete clientObj;
         serverObj.setIntProp(26);
+        QTest::qWait(10);
         QCOMPARE(m_server2ClientCount, 2);
     }
 
+    void testPropertyLayoutMismatch()
+    {
+        m_server2ClientCount = 0;
+        m_client2ServerCount = 0;
+
+        MyObject serverObj;
+        serverObj.setIntProp(14);
+        m_server = new PropertySyncer(this);
+        connect(m_server, SIGNAL(message(GammaRay::Message)), this,
+                SLOT(server2client(GammaRay::Message)));
+        m_server->setAddress(1);
+        m_server->addObject(42, &serverObj);
+        m_server->setObjectEnabled(42, true);
+
+        // the client side has an additional property in front of the synced one
+        MyDerivedObject clientObj;
+        m_client = new PropertySyncer(this);
+        m_client->setRequestInitialSync(true);
+        connect(m_client, SIGNAL(message(GammaRay::Message)), this,
+                SLOT(client2server(GammaRay::Message)));
+        m_client->setAddress(1);
+        m_client->addObject(42, &clientObj);
+        m_client->setObjectEnabled(42, true);
+        QCOMPARE(clientObj.intProp(), 14);
+        QCOMPARE(clientObj.otherProp(), 0);
+
+        serverObj.setIntProp(42);
+        QTRY_COMPARE(clientObj.intProp(), 42);
+        QCOMPARE(clientObj.otherProp(), 0);
+
+        clientObj.setOtherProp(5);
+        clientObj.setIntProp(23);
+        QTRY_COMPARE(serverObj.intProp(), 23);
+
+        delete m_client;
+        m_client = 0;
+    }
+
+    void testReregistration()
+    {
+        m_server2ClientCount = 0;
+
+        PropertySyncer server;
+        connect(&server, SIGNAL(message(GammaRay::Message)), this,
+                SLOT(server2client(GammaRay::Message)));
+        server.setAddress(1);
+        MyObject obj1;
+        MyObject obj2;
+        server.addObject(42, &obj1);
+        server.setObjectEnabled(42, true);
+
+        // replacing the object of an address keeps it enabled, the old one is no longer monitored
+        server.addObject(42, &obj2);
+        obj1.setIntProp(1);
+        QCoreApplication::processEvents();
+        QCOMPARE(m_server2ClientCount, 0);
+        obj2.setIntProp(2);
+        QTRY_COMPARE(m_server2ClientCount, 1);
+
+        // moving an object to a new address
+        server.addObject(43, &obj2);
+        obj2.setIntProp(3);
+        QCoreApplication::processEvents();
+        QCOMPARE(m_server2ClientCount, 1);
+        server.setObjectEnabled(43, true);
+        obj2.setIntProp(4);
+        QTRY_COMPARE(m_server2ClientCount, 2);
+    }
+
 private:
     int m_server2ClientCount, m_client2ServerCount;
     PropertySyncer *m_client;
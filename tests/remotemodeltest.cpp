@@ -32,6 +32,8 @@
 
 #include <QBuffer>
 #include <QDebug>
+#include <QIcon>
+#include <QPixmap>
 #include <QtTest/qtest.h>
 #include <QObject>
 #include <QSortFilterProxyModel>
@@ -88,6 +90,16 @@ public:
         FakeRemoteModel::s_registerClientCallback = &fakeRegisterServer;
     }
 
+    int iconCount() const
+    {
+        return m_icons.size();
+    }
+
+    void setMaximumCacheSize(int rows)
+    {
+        m_maximumCacheSize = rows;
+    }
+
 signals:
     void message(const GammaRay::Message &msg);
 
@@ -237,6 +249,191 @@ private slots:
         delete treeModel;
     }
 
+    void testIconTransfer()
+    {
+        QPixmap redPixmap(16, 16);
+        redPixmap.fill(Qt::red);
+        const QIcon red(redPixmap);
+        QPixmap bluePixmap(16, 16);
+        bluePixmap.fill(Qt::blue);
+
+        auto listModel = new QStandardItemModel(this);
+        listModel->appendRow(new QStandardItem(red, QStringLiteral("entry0")));
+        listModel->appendRow(new QStandardItem(red, QStringLiteral("entry1")));
+        listModel->appendRow(new QStandardItem(QIcon(bluePixmap), QStringLiteral("entry2")));
+        listModel->appendRow(new QStandardItem(QIcon(redPixmap), QStringLiteral("entry3")));
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.IconModel"), this);
+        server.setModel(listModel);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.IconModel"), this);
+        connect(&server, SIGNAL(message(GammaRay::Message)), &client,
+                SLOT(newMessage(GammaRay::Message)));
+        connect(&client, SIGNAL(message(GammaRay::Message)), &server,
+                SLOT(newRequest(GammaRay::Message)));
+
+        QCOMPARE(client.rowCount(), 4);
+        for (int i = 0; i < 4; ++i)
+            client.index(i, 0).data();
+        QTest::qWait(1);
+
+        // same content is transferred only once, independent of the QIcon instance
+        QCOMPARE(client.iconCount(), 2);
+        for (int i = 0; i < 4; ++i) {
+            const auto decoration = client.index(i, 0).data(Qt::DecorationRole);
+            QVERIFY(decoration.isValid());
+            QCOMPARE(decoration.value<QPixmap>().toImage().pixel(8, 8),
+                     QColor(i == 2 ? Qt::blue : Qt::red).rgb());
+        }
+
+        delete listModel;
+    }
+
+    void testIconEviction()
+    {
+        auto listModel = new QStandardItemModel(this);
+        for (int i = 0; i < 1500; ++i) {
+            QPixmap pixmap(16, 16);
+            pixmap.fill(QColor(i % 256, i / 256, 0));
+            listModel->appendRow(new QStandardItem(QIcon(pixmap), QStringLiteral("entry%1").arg(i)));
+        }
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.ManyIconsModel"), this);
+        server.setModel(listModel);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.ManyIconsModel"), this);
+        connect(&server, SIGNAL(message(GammaRay::Message)), &client,
+                SLOT(newMessage(GammaRay::Message)));
+        connect(&client, SIGNAL(message(GammaRay::Message)), &server,
+                SLOT(newRequest(GammaRay::Message)));
+
+        QCOMPARE(client.rowCount(), 1500);
+        for (int i = 0; i < 1500; ++i) {
+            client.index(i, 0).data();
+            if (i % 100 == 99)
+                QTest::qWait(1);
+        }
+        QTest::qWait(1);
+
+        // the icon table is bounded, without affecting what we received already
+        QVERIFY(client.iconCount() <= 1024);
+        for (int i = 0; i < 1500; ++i) {
+            const auto decoration = client.index(i, 0).data(Qt::DecorationRole);
+            QVERIFY(decoration.isValid());
+            QCOMPARE(decoration.value<QPixmap>().toImage().pixel(8, 8),
+                     QColor(i % 256, i / 256, 0).rgb());
+        }
+
+        delete listModel;
+    }
+
+    void testPrefetchAndEviction()
+    {
+        auto listModel = new QStandardItemModel(this);
+        for (int i = 0; i < 200; ++i)
+            listModel->appendRow(new QStandardItem(QStringLiteral("entry%1").arg(i)));
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.LargeModel"), this);
+        server.setModel(listModel);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.LargeModel"), this);
+        client.setMaximumCacheSize(40);
+        connect(&server, SIGNAL(message(GammaRay::Message)), &client,
+                SLOT(newMessage(GammaRay::Message)));
+        connect(&client, SIGNAL(message(GammaRay::Message)), &server,
+                SLOT(newRequest(GammaRay::Message)));
+
+        QCOMPARE(client.rowCount(), 200);
+        client.index(50, 0).data();
+        QTest::qWait(1);
+
+        // neighboring rows are fetched along with the requested one
+        for (int row = 40; row <= 60; ++row) {
+            const auto state = client.index(row, 0).data(RemoteModelRole::LoadingState)
+                               .value<RemoteModelNodeState::NodeStates>();
+            QCOMPARE(int(state), int(RemoteModelNodeState::NoState));
+        }
+        QCOMPARE(client.index(50, 0).data().toString(), QStringLiteral("entry50"));
+
+        // scroll through everything, the cache must stay bounded
+        for (int row = 0; row < 200; ++row) {
+            client.index(row, 0).data();
+            QTest::qWait(1);
+        }
+        int cachedRows = 0;
+        for (int row = 0; row < 200; ++row) {
+            const auto state = client.index(row, 0).data(RemoteModelRole::LoadingState)
+                               .value<RemoteModelNodeState::NodeStates>();
+            if ((state & RemoteModelNodeState::Empty) == 0)
+                ++cachedRows;
+        }
+        QVERIFY(cachedRows <= 40);
+        QCOMPARE(client.index(199, 0).data().toString(), QStringLiteral("entry199"));
+
+        delete listModel;
+    }
+
+    void testRoleNegotiation()
+    {
+        auto listModel = new QStandardItemModel(this);
+        for (int i = 0; i < 200; ++i) {
+            auto item = new QStandardItem(QStringLiteral("entry%1").arg(i));
+            item->setToolTip(QStringLiteral("tooltip%1").arg(i));
+            item->setData(i, Qt::UserRole + 1);
+            item->setData(i * 2, Qt::UserRole + 3);
+            listModel->appendRow(item);
+        }
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.RoleModel"), this);
+        server.setModel(listModel);
+        server.setLazyRoles(QVector<int>() << Qt::ToolTipRole << Qt::UserRole + 3);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.RoleModel"), this);
+        connect(&server, SIGNAL(message(GammaRay::Message)), &client,
+                SLOT(newMessage(GammaRay::Message)));
+        connect(&client, SIGNAL(message(GammaRay::Message)), &server,
+                SLOT(newRequest(GammaRay::Message)));
+
+        QCOMPARE(client.rowCount(), 200);
+
+        // the first reply contains everything but the lazy roles, so this can be read right away
+        auto index = client.index(0, 0);
+        index.data();
+        QTest::qWait(1);
+        QCOMPARE(index.data().toString(), QStringLiteral("entry0"));
+        QCOMPARE(index.data(Qt::UserRole + 1).toInt(), 0);
+        QVERIFY(!index.data(Qt::UserRole + 3).isValid());
+        QTest::qWait(1);
+        QCOMPARE(index.data(Qt::UserRole + 3).toInt(), 0);
+
+        // later ones contain what the model provided, lazy roles are fetched on demand
+        index = client.index(100, 0);
+        index.data();
+        QTest::qWait(1);
+        QCOMPARE(index.data().toString(), QStringLiteral("entry100"));
+        QCOMPARE(index.data(Qt::UserRole + 1).toInt(), 100);
+        QVERIFY(!index.data(Qt::ToolTipRole).isValid());
+        QTest::qWait(1);
+        QCOMPARE(index.data(Qt::ToolTipRole).toString(), QStringLiteral("tooltip100"));
+        QVERIFY(!index.data(Qt::UserRole + 3).isValid());
+        QTest::qWait(1);
+        QCOMPARE(index.data(Qt::UserRole + 3).toInt(), 200);
+
+        // roles only asked for later are added to the requests, and known to be invalid then
+        QVERIFY(!index.data(Qt::UserRole + 2).isValid());
+        QTest::qWait(1);
+        QVERIFY(!index.data(Qt::UserRole + 2).isValid());
+        const auto state = index.data(RemoteModelRole::LoadingState)
+                           .value<RemoteModelNodeState::NodeStates>();
+        QCOMPARE(int(state), int(RemoteModelNodeState::NoState));
+
+        delete listModel;
+    }
+
     // this should not make a difference if the above works, however it broke massively with Qt 5.4...
     void testSortProxy()
     {
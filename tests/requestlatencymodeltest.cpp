@@ -0,0 +1,108 @@
+/*
+  requestlatencymodeltest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <client/requestlatencymodel.h>
+
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+class RequestLatencyModelTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testBuckets()
+    {
+        for (qint64 usecs = 0; usecs < 100000; usecs += 7) {
+            LatencyDistribution dist;
+            dist.add(usecs);
+            int bucket = 0;
+            while (!dist.histogram[bucket])
+                ++bucket;
+            QVERIFY(usecs <= LatencyDistribution::bucketUpperBound(bucket));
+            QVERIFY(bucket == 0 || usecs > LatencyDistribution::bucketUpperBound(bucket - 1));
+        }
+    }
+
+    void testPercentiles()
+    {
+        LatencyDistribution dist;
+        QCOMPARE(dist.percentile(0.5), qint64(0));
+
+        for (int i = 0; i < 98; ++i)
+            dist.add(1000);
+        dist.add(50000);
+        dist.add(200000);
+        QCOMPARE(dist.count, quint64(100));
+        QCOMPARE(dist.max, qint64(200000));
+
+        // within the resolution of a sub-bucket
+        QVERIFY(dist.percentile(0.5) >= 1000);
+        QVERIFY(dist.percentile(0.5) < 1250);
+        QVERIFY(dist.percentile(0.99) >= 50000);
+        QVERIFY(dist.percentile(0.99) < 62500);
+        QCOMPARE(dist.percentile(1.0), qint64(200000));
+    }
+
+    void testModel()
+    {
+        RequestLatencyModel model;
+        QCOMPARE(model.rowCount(QModelIndex()), 0);
+
+        model.addObject(2, QStringLiteral("com.kdab.GammaRay.ObjectTree"));
+        QCOMPARE(model.rowCount(QModelIndex()), 0);
+
+        model.addRequest(2, Protocol::ModelContentRequest, 3000, 1000);
+        model.addRequest(3, Protocol::ModelRowColumnCountRequest, 500, 100);
+        model.addRequest(2, Protocol::ModelHeaderRequest, 3000, 1000);
+        QCOMPARE(model.rowCount(QModelIndex()), 2);
+
+        QCOMPARE(model.index(0, RequestLatencyModel::ObjectColumn).data().toString(),
+                 QStringLiteral("com.kdab.GammaRay.ObjectTree"));
+        QCOMPARE(model.index(0, RequestLatencyModel::CountColumn).data().toInt(), 2);
+        QCOMPARE(model.index(0, RequestLatencyModel::MaxColumn).data().toString(),
+                 QStringLiteral("3.00"));
+        QCOMPARE(model.index(0, RequestLatencyModel::ServerMedianColumn).data().toString(),
+                 QStringLiteral("1.00"));
+        QCOMPARE(model.index(0, RequestLatencyModel::TransferMedianColumn).data().toString(),
+                 QStringLiteral("2.00"));
+
+        // no name known yet
+        QCOMPARE(model.index(1, RequestLatencyModel::ObjectColumn).data().toString(),
+                 QStringLiteral("3"));
+        model.addObject(3, QStringLiteral("com.kdab.GammaRay.ToolModel"));
+        QCOMPARE(model.index(1, RequestLatencyModel::ObjectColumn).data().toString(),
+                 QStringLiteral("com.kdab.GammaRay.ToolModel"));
+
+        model.clear();
+        QCOMPARE(model.rowCount(QModelIndex()), 0);
+    }
+};
+
+QTEST_MAIN(RequestLatencyModelTest)
+
+#include "requestlatencymodeltest.moc"
@@ -0,0 +1,149 @@
+/*
+  retainedsizetest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config-gammaray.h>
+
+#include <plugins/retainedsize/retainedsizeestimator.h>
+#include <plugins/retainedsize/retainedsizetree.h>
+
+#include <QObject>
+#include <QStandardItemModel>
+#include <QTextDocument>
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+class RetainedSizeTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testPropagation()
+    {
+        QObject root, child, grandChild;
+        RetainedSizeTree tree;
+        tree.addObject(&root, 0);
+        tree.addObject(&child, &root);
+        tree.addObject(&grandChild, &child);
+        QCOMPARE(tree.objectCount(&root), 3);
+
+        tree.setSelfSize(&root, 10);
+        tree.setSelfSize(&child, 20);
+        tree.setSelfSize(&grandChild, 40);
+        QCOMPARE(tree.selfSize(&root), qint64(10));
+        QCOMPARE(tree.retainedSize(&root), qint64(70));
+        QCOMPARE(tree.retainedSize(&child), qint64(60));
+        QCOMPARE(tree.retainedSize(&grandChild), qint64(40));
+
+        tree.setSelfSize(&grandChild, 30);
+        QCOMPARE(tree.retainedSize(&root), qint64(60));
+
+        tree.removeObject(&grandChild);
+        QCOMPARE(tree.retainedSize(&root), qint64(30));
+        QCOMPARE(tree.objectCount(&root), 2);
+        QVERIFY(!tree.contains(&grandChild));
+    }
+
+    void testRemoveParentFirst()
+    {
+        QObject root, child;
+        RetainedSizeTree tree;
+        tree.addObject(&root, 0);
+        tree.addObject(&child, &root);
+        tree.setSelfSize(&child, 20);
+
+        // ~QObject reports the parent before its children
+        tree.removeObject(&root);
+        QVERIFY(!tree.parent(&child));
+        QCOMPARE(tree.retainedSize(&child), qint64(20));
+        tree.removeObject(&child);
+        QVERIFY(tree.objects().isEmpty());
+    }
+
+    void testReparent()
+    {
+        QObject a, b, child;
+        RetainedSizeTree tree;
+        tree.addObject(&a, 0);
+        tree.addObject(&b, 0);
+        tree.addObject(&child, &a);
+        tree.setSelfSize(&child, 100);
+        QCOMPARE(tree.retainedSize(&a), qint64(100));
+
+        tree.reparentObject(&child, &b);
+        QCOMPARE(tree.parent(&child), &b);
+        QCOMPARE(tree.retainedSize(&a), qint64(0));
+        QCOMPARE(tree.retainedSize(&b), qint64(100));
+        QCOMPARE(tree.objectCount(&a), 1);
+        QCOMPARE(tree.objectCount(&b), 2);
+
+        // cycles are rejected
+        tree.reparentObject(&b, &child);
+        QCOMPARE(tree.parent(&b), static_cast<QObject *>(0));
+    }
+
+    void testTopRetainers()
+    {
+        QObject a, b, c;
+        RetainedSizeTree tree;
+        tree.addObject(&a, 0);
+        tree.addObject(&b, 0);
+        tree.addObject(&c, &b);
+        tree.setSelfSize(&a, 50);
+        tree.setSelfSize(&b, 10);
+        tree.setSelfSize(&c, 45);
+
+        const QVector<QObject *> top = tree.topRetainers(2);
+        QCOMPARE(top.size(), 2);
+        QCOMPARE(top.at(0), &b);
+        QCOMPARE(top.at(1), &a);
+        QCOMPARE(tree.topRetainers(10).size(), 3);
+    }
+
+    void testEstimator()
+    {
+        RetainedSizeEstimator estimator;
+        QObject obj;
+        const qint64 baseSize = estimator.selfSize(&obj);
+        QVERIFY(baseSize >= qint64(sizeof(QObject)));
+
+        obj.setProperty("payload", QByteArray(100000, 'x'));
+        QVERIFY(estimator.selfSize(&obj) >= baseSize + 100000);
+
+        QStandardItemModel model(1000, 10);
+        QVERIFY(estimator.selfSize(&model) > estimator.selfSize(&obj));
+
+        // class specific payload
+        QTextDocument document;
+        const qint64 emptySize = estimator.selfSize(&document);
+        document.setPlainText(QString(100000, QLatin1Char('x')));
+        QVERIFY(estimator.selfSize(&document) >= emptySize + 100000 * qint64(sizeof(QChar)));
+    }
+};
+
+QTEST_MAIN(RetainedSizeTest)
+
+#include "retainedsizetest.moc"
@@ -0,0 +1,146 @@
+/*
+  signalprofilertest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <plugins/signalprofiler/signalprofilerrecorder.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+#include <QThread>
+
+using namespace GammaRay;
+
+class SignalProfilerTestThread : public QThread
+{
+public:
+    explicit SignalProfilerTestThread(QObject *obj)
+        : m_obj(obj) {}
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < 10; ++i) {
+            SignalProfilerRecorder::signalBegin(m_obj, 4);
+            SignalProfilerRecorder::signalEnd(m_obj, 4);
+        }
+    }
+
+private:
+    QObject *m_obj;
+};
+
+class SignalProfilerTest : public QObject
+{
+    Q_OBJECT
+private:
+    static SignalProfilerKey key(QObject *sender, int signalIndex, QObject *receiver,
+                                 int slotIndex)
+    {
+        SignalProfilerKey k;
+        if (sender) {
+            k.senderType = sender->metaObject();
+            k.signalIndex = signalIndex;
+        }
+        if (receiver) {
+            k.receiverType = receiver->metaObject();
+            k.slotIndex = slotIndex;
+        }
+        return k;
+    }
+
+private slots:
+    void testNesting()
+    {
+        QObject sender, receiver;
+        const auto before = SignalProfilerRecorder::snapshot();
+
+        SignalProfilerRecorder::signalBegin(&sender, 1);
+        SignalProfilerRecorder::slotBegin(&receiver, 2);
+        SignalProfilerRecorder::signalBegin(&receiver, 1);
+        QTest::qSleep(5);
+        SignalProfilerRecorder::signalEnd(&receiver, 1);
+        SignalProfilerRecorder::slotEnd(&receiver, 2);
+        SignalProfilerRecorder::signalEnd(&sender, 1);
+
+        const auto after = SignalProfilerRecorder::snapshot();
+        const auto emission = after.value(key(&sender, 1, 0, -1));
+        const auto slot = after.value(key(&sender, 1, &receiver, 2));
+        const auto nested = after.value(key(&receiver, 1, 0, -1));
+        QCOMPARE(emission.calls, before.value(key(&sender, 1, 0, -1)).calls + 1);
+        QCOMPARE(slot.calls, before.value(key(&sender, 1, &receiver, 2)).calls + 1);
+        QCOMPARE(nested.calls, before.value(key(&receiver, 1, 0, -1)).calls + 1);
+
+        QVERIFY(nested.inclusiveTime >= 5000000);
+        QVERIFY(slot.inclusiveTime >= nested.inclusiveTime);
+        QVERIFY(emission.inclusiveTime >= slot.inclusiveTime);
+        QVERIFY(slot.exclusiveTime < slot.inclusiveTime);
+        QCOMPARE(nested.maxNesting, 2);
+        QCOMPARE(slot.maxNesting, 1);
+    }
+
+    void testMissingEnd()
+    {
+        QObject sender, receiver;
+        const auto before = SignalProfilerRecorder::snapshot();
+
+        // end callback of the slot is skipped, e.g. due to the receiver being deleted
+        SignalProfilerRecorder::signalBegin(&sender, 3);
+        SignalProfilerRecorder::slotBegin(&receiver, 2);
+        SignalProfilerRecorder::signalEnd(&sender, 3);
+
+        const auto after = SignalProfilerRecorder::snapshot();
+        QCOMPARE(after.value(key(&sender, 3, 0, -1)).calls,
+                 before.value(key(&sender, 3, 0, -1)).calls + 1);
+        QCOMPARE(after.value(key(&sender, 3, &receiver, 2)).calls,
+                 before.value(key(&sender, 3, &receiver, 2)).calls);
+
+        // stack is balanced again
+        SignalProfilerRecorder::signalBegin(&sender, 3);
+        SignalProfilerRecorder::signalEnd(&sender, 3);
+        QCOMPARE(SignalProfilerRecorder::snapshot().value(key(&sender, 3, 0, -1)).maxNesting, 0);
+    }
+
+    void testThreads()
+    {
+        QObject sender;
+        const auto before = SignalProfilerRecorder::snapshot().value(key(&sender, 4, 0, -1)).calls;
+
+        SignalProfilerTestThread t1(&sender), t2(&sender);
+        t1.start();
+        t2.start();
+        QVERIFY(t1.wait());
+        QVERIFY(t2.wait());
+
+        // counts of finished threads are retained
+        const auto after = SignalProfilerRecorder::snapshot().value(key(&sender, 4, 0, -1)).calls;
+        QCOMPARE(after, before + 20);
+        QCOMPARE(SignalProfilerRecorder::snapshot().value(key(&sender, 4, 0, -1)).calls, after);
+    }
+};
+
+QTEST_MAIN(SignalProfilerTest)
+
+#include "signalprofilertest.moc"
@@ -0,0 +1,95 @@
+/*
+  stalldetectortest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config-gammaray.h>
+
+#include <probe/hooks.h>
+#include <probe/probecreator.h>
+#include <core/probe.h>
+#include <common/objectbroker.h>
+#include <common/tools/stalldetector/stalldetectorinterface.h>
+
+#include <3rdparty/qt/modeltest.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+using namespace GammaRay;
+
+class StallDetectorTest : public QObject
+{
+    Q_OBJECT
+private:
+    void createProbe()
+    {
+        Hooks::installHooks();
+        Probe::startupHookReceived();
+        new ProbeCreator(ProbeCreator::Create);
+        QTest::qWait(1); // event loop re-entry
+    }
+
+private slots:
+    void testStall()
+    {
+        createProbe();
+
+        auto model = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.StallModel"));
+        QVERIFY(model);
+        ModelTest modelTest(model);
+        auto histogram = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.StallHistogramModel"));
+        QVERIFY(histogram);
+        ModelTest histogramModelTest(histogram);
+
+        auto detector = ObjectBroker::object<StallDetectorInterface *>();
+        QVERIFY(detector);
+
+        // probe startup and plugin loading can block longer than the default threshold
+        detector->setProperty("threshold", 5000);
+        QMetaObject::invokeMethod(detector, "clear");
+        QTest::qWait(200); // no stalls while the event loop runs
+        QCOMPARE(model->rowCount(), 0);
+
+        detector->setProperty("threshold", 250);
+        QTest::qSleep(700);
+        QTest::qWait(200);
+        QCOMPARE(model->rowCount(), 1);
+        const auto idx = model->index(0, 1);
+        QVERIFY(idx.data().toInt() >= 500);
+#ifdef HAVE_BACKTRACE
+        QVERIFY(model->rowCount(model->index(0, 0)) > 0);
+#endif
+
+        int stalls = 0;
+        for (int i = 0; i < histogram->rowCount(); ++i)
+            stalls += histogram->index(i, 1).data().toInt();
+        QCOMPARE(stalls, 1);
+    }
+};
+
+QTEST_MAIN(StallDetectorTest)
+
+#include "stalldetectortest.moc"
@@ -36,6 +36,7 @@
 #include <ui/tools/metatypebrowser/metatypebrowserwidget.h>
 #include <ui/tools/objectinspector/objectinspectorwidget.h>
 #include <ui/tools/resourcebrowser/resourcebrowserwidget.h>
+#include <ui/tools/stalldetector/stalldetectorwidget.h>
 #include <ui/tools/standardpaths/standardpathswidget.h>
 
 #include <common/endpoint.h>
@@ -65,6 +66,7 @@ MAKE_FACTORY(MessageHandler,    qApp->translate("GammaRay::MessageHandlerFactory
 MAKE_FACTORY(MetaObjectBrowser, qApp->translate("GammaRay::MetaObjectBrowserFactory", "Meta Objects"));
 MAKE_FACTORY(MetaTypeBrowser,   qApp->translate("GammaRay::MetaTypeBrowserFactory", "Meta Types"));
 MAKE_FACTORY(ResourceBrowser,   qApp->translate("GammaRay::ResourceBrowserFactory", "Resources"));
+MAKE_FACTORY(StallDetector,     qApp->translate("GammaRay::StallDetectorFactory", "Stalls"));
 MAKE_FACTORY(StandardPaths,     qApp->translate("GammaRay::StandardPathsFactory", "Standard Paths"));
 
 struct PluginRepository {
@@ -100,6 +102,7 @@ static void initPluginRepository()
     insertFactory(new MetaTypeBrowserFactory);
     insertFactory(new ObjectInspectorFactory);
     insertFactory(new ResourceBrowserFactory);
+    insertFactory(new StallDetectorFactory);
     insertFactory(new StandardPathsFactory);
 
     PluginManager<ToolUiFactory, ProxyToolUiFactory> pm;
@@ -60,7 +60,9 @@
 #include <QMenu>
 #include <QProcess>
 #include <QSettings>
+#include <QStatusBar>
 #include <QStyleFactory>
+#include <QTabWidget>
 #include <QTableView>
 #include <QToolButton>
 #include <QUrl>
@@ -287,6 +289,13 @@ MainWindow::MainWindow(QWidget *parent)
             SLOT(navigateToCode(QUrl,int,int)));
 
     connect(this, SIGNAL(targetQuitRequested()), &m_stateManager, SLOT(saveState()));
+
+    auto probeController = ObjectBroker::object<ProbeControllerInterface *>();
+    connect(probeController, SIGNAL(objectDiscoveryActiveChanged(bool)),
+            this, SLOT(updateObjectDiscoveryStatus()));
+    connect(probeController, SIGNAL(discoveredObjectCountChanged(int)),
+            this, SLOT(updateObjectDiscoveryStatus()));
+    updateObjectDiscoveryStatus();
 }
 
 MainWindow::~MainWindow()
@@ -360,12 +369,27 @@ void MainWindow::aboutKDAB()
 
 void MainWindow::showMessageStatistics()
 {
+    auto tabWidget = new QTabWidget;
+    tabWidget->setWindowTitle(tr("Communication Message Statistics"));
+    tabWidget->setAttribute(Qt::WA_DeleteOnClose);
+
     auto view = new QTableView;
-    view->setWindowTitle(tr("Communication Message Statistics"));
-    view->setAttribute(Qt::WA_DeleteOnClose);
     view->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.MessageStatisticsModel")));
     view->horizontalHeader()->setResizeMode(0, QHeaderView::ResizeToContents);
-    view->showMaximized();
+    tabWidget->addTab(view, tr("Messages"));
+
+    view = new QTableView;
+    view->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.RequestLatencyModel")));
+    view->horizontalHeader()->setResizeMode(QHeaderView::ResizeToContents);
+    tabWidget->addTab(view, tr("Request Latency"));
+
+    view = new QTableView;
+    view->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.BandwidthModel")));
+    view->horizontalHeader()->setResizeMode(QHeaderView::ResizeToContents);
+    view->verticalHeader()->hide();
+    tabWidget->addTab(view, tr("Bandwidth"));
+
+    tabWidget->showMaximized();
 }
 
 bool MainWindow::selectTool(const QString &id)
@@ -535,6 +559,17 @@ QWidget *MainWindow::createErrorPage(const QModelIndex &index)
     return page;
 }
 
+void MainWindow::updateObjectDiscoveryStatus()
+{
+    const auto probeController = ObjectBroker::object<ProbeControllerInterface *>();
+    if (probeController->objectDiscoveryActive()) {
+        statusBar()->showMessage(tr("Searching for existing objects... (%1 found so far)")
+                                 .arg(probeController->discoveredObjectCount()));
+    } else if (auto bar = findChild<QStatusBar *>()) { // don't create one just for clearing it
+        bar->clearMessage();
+    }
+}
+
 void MainWindow::quitHost()
 {
     emit targetQuitRequested();
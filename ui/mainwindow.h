@@ -83,6 +83,8 @@ private slots:
     bool selectTool(const QString &id);
     void toolContextMenu(QPoint pos);
 
+    void updateObjectDiscoveryStatus();
+
     void quitHost();
     void detachProbe();
     void navigateToCode(const QUrl &url, int lineNumber, int columnNumber);
@@ -39,6 +39,9 @@
 
 using namespace GammaRay;
 
+// property views are read by humans, more frequent updates only cost bandwidth
+static const int MaximumUpdateRate = 10;
+
 QVector<PropertyWidgetTabFactoryBase *> PropertyWidget::s_tabFactories
     = QVector<PropertyWidgetTabFactoryBase *>();
 QVector<PropertyWidget *> PropertyWidget::s_propertyWidgets;
@@ -84,6 +87,7 @@ void PropertyWidget::setObjectBaseName(const QString &baseName)
     m_controller = ObjectBroker::object<PropertyControllerInterface *>(
         m_objectBaseName + ".controller");
     connect(m_controller, SIGNAL(availableExtensionsChanged()), this, SLOT(updateShownTabs()));
+    m_controller->setMaximumUpdateRate(MaximumUpdateRate);
 
     updateShownTabs();
 }
@@ -142,6 +142,10 @@ QVariant MetaObjectTreeClientProxyModel::headerData(int section, Qt::Orientation
                 return tr("Self Alive");
             case QMetaObjectModel::ObjectInclusiveAliveCountColumn:
                 return tr("Incl. Alive");
+            case QMetaObjectModel::ObjectInclusiveCreationRateColumn:
+                return tr("Incl. Created/s");
+            case QMetaObjectModel::ObjectInclusiveDestructionRateColumn:
+                return tr("Incl. Destroyed/s");
             default:
                 return QVariant();
         }
@@ -157,6 +161,10 @@ QVariant MetaObjectTreeClientProxyModel::headerData(int section, Qt::Orientation
                 return tr("This column shows the number of objects created and not yet destroyed of a particular type.");
             case QMetaObjectModel::ObjectInclusiveAliveCountColumn:
                 return tr("This column shows the number of objects created and not yet destroyed that inherit from a particular type.");
+            case QMetaObjectModel::ObjectInclusiveCreationRateColumn:
+                return tr("This column shows the number of objects inheriting from a particular type created per second, during the last second.");
+            case QMetaObjectModel::ObjectInclusiveDestructionRateColumn:
+                return tr("This column shows the number of objects inheriting from a particular type destroyed per second, during the last second.");
             default:
                 return QVariant();
         }
@@ -183,6 +191,8 @@ void MetaObjectTreeClientProxyModel::findQObjectIndex()
 
 bool MetaObjectTreeClientProxyModel::needsBackground(const QModelIndex &index) const
 {
+    if (index.column() == QMetaObjectModel::ObjectInclusiveCreationRateColumn || index.column() == QMetaObjectModel::ObjectInclusiveDestructionRateColumn)
+        return false;
     if (index.parent().isValid())
         return true;
     if (index.row() != m_qobjIndex.row())
@@ -0,0 +1,85 @@
+/*
+  stalldetectorwidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2016 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stalldetectorwidget.h"
+#include "ui_stalldetectorwidget.h"
+#include "stalldetectorclient.h"
+
+#include <common/objectbroker.h>
+
+using namespace GammaRay;
+
+static QObject *createStallDetectorClient(const QString & /*name*/, QObject *parent)
+{
+    return new StallDetectorClient(parent);
+}
+
+StallDetectorWidget::StallDetectorWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::StallDetectorWidget)
+    , m_stateManager(this)
+    , m_interface(0)
+{
+    ObjectBroker::registerClientObjectFactoryCallback<StallDetectorInterface *>(
+        createStallDetectorClient);
+    m_interface = ObjectBroker::object<StallDetectorInterface *>();
+
+    ui->setupUi(this);
+
+    ui->stallView->header()->setObjectName("stallViewHeader");
+    ui->stallView->setDeferredResizeMode(0, QHeaderView::ResizeToContents);
+    ui->stallView->setDeferredResizeMode(1, QHeaderView::ResizeToContents);
+    ui->stallView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.StallModel")));
+
+    ui->histogramView->header()->setObjectName("histogramViewHeader");
+    ui->histogramView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    ui->histogramView->setDeferredResizeMode(1, QHeaderView::ResizeToContents);
+    ui->histogramView->setModel(ObjectBroker::model(QStringLiteral(
+                                                        "com.kdab.GammaRay.StallHistogramModel")));
+
+    m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "75%" << "25%");
+
+    thresholdChanged();
+    connect(m_interface, SIGNAL(thresholdChanged()), this, SLOT(thresholdChanged()));
+    connect(ui->thresholdBox, SIGNAL(valueChanged(int)), this, SLOT(thresholdEdited(int)));
+    connect(ui->clearButton, SIGNAL(clicked()), m_interface, SLOT(clear()));
+}
+
+StallDetectorWidget::~StallDetectorWidget()
+{
+}
+
+void StallDetectorWidget::thresholdChanged()
+{
+    if (ui->thresholdBox->value() != m_interface->threshold())
+        ui->thresholdBox->setValue(m_interface->threshold());
+}
+
+void StallDetectorWidget::thresholdEdited(int threshold)
+{
+    m_interface->setThreshold(threshold);
+}